@@ -28,6 +28,7 @@
 #include <mlt++/MltProducer.h>
 #include <mlt++/MltProfile.h>
 #include <mlt++/MltRepository.h>
+#include <chrono>
 #include <sstream>
 #define private public
 #define protected public
@@ -105,6 +106,21 @@ QString createProducerWithSound(Mlt::Profile &prof, std::shared_ptr<ProjectItemM
 
     return binId;
 }
+/** @brief Bin clips are not part of recorded sessions, create a clip with audio and video under the recorded id */
+void createReplayProducer(Mlt::Profile &prof, const QString &binId, std::shared_ptr<ProjectItemModel> binModel)
+{
+    // Long enough for the moves and resizes of a real session
+    const int length = 100000;
+    std::shared_ptr<Mlt::Producer> producer = std::make_shared<Mlt::Producer>(prof, "blipflash");
+    producer->set("length", length);
+    producer->set_in_and_out(0, length - 1);
+    producer->set("kdenlive:duration", length);
+    Q_ASSERT(producer->is_valid());
+    auto binClip = ProjectClip::construct(binId, QIcon(), binModel, producer);
+    Fun undo = []() { return true; };
+    Fun redo = []() { return true; };
+    binModel->addItem(binClip, binModel->getRootFolder()->clipId(), undo, redo);
+}
 inline int modulo(int a, int b)
 {
     const int result = a % b;
@@ -123,10 +139,11 @@ bool isIthParamARef(const rttr::method &method, size_t i)
 } // namespace
 } // namespace
 
-void fuzz(const std::string &input)
+void fuzz(const std::string &input, ReplayStats *stats)
 {
-    Logger::init();
+    Logger::init(stats ? stats->traceCapacity : 0);
     Logger::clear();
+    const bool verbose = stats == nullptr;
     std::stringstream ss;
     ss << input;
 
@@ -257,21 +274,46 @@ void fuzz(const std::string &input)
         id = modulo(id, (int)all_tracks[timeline].size());
         return all_tracks[timeline][id];
     };
+    auto measure = [&](const std::string &name, const std::function<void()> &operation) {
+        if (!stats) {
+            operation();
+            return;
+        }
+        size_t allocations = stats->allocationCounter ? stats->allocationCounter() : 0;
+        auto start = std::chrono::steady_clock::now();
+        operation();
+        auto end = std::chrono::steady_clock::now();
+        if (stats->allocationCounter) {
+            allocations = stats->allocationCounter() - allocations;
+        }
+        stats->samples[name].push_back({std::chrono::duration<double, std::micro>(end - start).count(), allocations});
+    };
+    // When replaying a recorded session, the clips it refers to are synthesized
+    auto ensure_bin_clip = [&](const QString &binId) {
+        if (!stats || binId.isEmpty() || pCore->projectItemModel()->hasClip(binId)) {
+            return;
+        }
+        measure("constr_bin_clip", [&]() { createReplayProducer(profile, binId, binModel); });
+    };
     std::string c;
 
     while (ss >> c) {
         if (c == "u") {
-            std::cout << "UNDOING" << std::endl;
-            undoStack->undo();
+            if (verbose) {
+                std::cout << "UNDOING" << std::endl;
+            }
+            measure("undo", [&]() { undoStack->undo(); });
         } else if (c == "r") {
-            std::cout << "REDOING" << std::endl;
-            undoStack->redo();
+            if (verbose) {
+                std::cout << "REDOING" << std::endl;
+            }
+            measure("redo", [&]() { undoStack->redo(); });
         } else if (Logger::back_translation_table.count(c) > 0) {
             // std::cout << "found=" << c;
             c = Logger::back_translation_table[c];
             // std::cout << " translated=" << c << std::endl;
             if (c == "constr_TimelineModel") {
-                all_timelines.emplace_back(TimelineItemModel::construct(&profile, guideModel, undoStack));
+                measure(c, [&]() { all_timelines.emplace_back(TimelineItemModel::construct(&profile, guideModel, undoStack)); });
             } else if (c == "constr_ClipModel") {
                 auto timeline = get_timeline();
                 int id = 0, state_id;
@@ -280,6 +322,7 @@ void fuzz(const std::string &input)
                 std::string binId;
                 ss >> binId >> id >> state_id >> speed;
                 QString binClip = QString::fromStdString(binId);
+                ensure_bin_clip(binClip);
                 bool valid = true;
                 if (!pCore->projectItemModel()->hasClip(binClip)) {
                     if (pCore->projectItemModel()->getAllClipIds().size() == 0) {
@@ -290,7 +333,7 @@ void fuzz(const std::string &input)
                 }
                 state = static_cast<PlaylistState::ClipState>(state_id);
                 if (timeline && valid) {
-                    ClipModel::construct(timeline, binClip, -1, state, speed);
+                    measure(c, [&]() { ClipModel::construct(timeline, binClip, -1, state, speed); });
                 }
             } else if (c == "constr_TrackModel") {
                 auto timeline = get_timeline();
@@ -304,16 +347,16 @@ void fuzz(const std::string &input)
                 if (pos < -1) pos = 0;
                 pos = std::min((int)all_tracks[timeline].size(), pos);
                 if (timeline) {
-                    TrackModel::construct(timeline, -1, pos, QString::fromStdString(name), audio);
+                    measure(c, [&]() { TrackModel::construct(timeline, -1, pos, QString::fromStdString(name), audio); });
                 }
             } else if (c == "constr_test_producer") {
                 std::string color;
                 int length = 0;
                 bool limited = false;
                 ss >> color >> length >> limited;
-                createProducer(profile, color, binModel, length, limited);
+                measure(c, [&]() { createProducer(profile, color, binModel, length, limited); });
             } else if (c == "constr_test_producer_sound") {
-                createProducerWithSound(profile, binModel);
+                measure(c, [&]() { createProducerWithSound(profile, binModel); });
             } else {
                 // std::cout << "executing " << c << std::endl;
                 rttr::type target_type = rttr::type::get<int>();
@@ -434,6 +477,9 @@ void fuzz(const std::string &input)
                                 if (str == "$$") {
                                     str = "";
                                 }
+                                if (arg_name == "binClipId") {
+                                    ensure_bin_clip(QString::fromStdString(str));
+                                }
                                 arguments.emplace_back(QString::fromStdString(str));
                             } else if (arg_type == rttr::type::get<std::shared_ptr<TimelineItemModel>>()) {
                                 auto timeline = get_timeline();
@@ -466,7 +512,9 @@ void fuzz(const std::string &input)
                         }
                     }
                     if (valid) {
-                        std::cout << "VALID!!! " << target_method.get_name().to_string() << std::endl;
+                        if (verbose) {
+                            std::cout << "VALID!!! " << target_method.get_name().to_string() << std::endl;
+                        }
                         std::vector<rttr::argument> args;
                         args.reserve(arguments.size());
                         for (auto &a : arguments) {
@@ -476,19 +524,20 @@ void fuzz(const std::string &input)
                         for (const auto &p : target_method.get_parameter_infos()) {
                             // std::cout << "expected=" << p.get_type().get_name().to_string() << std::endl;
                         }
-                        rttr::variant res = target_method.invoke_variadic(ptr, args);
-                        if (res.is_valid()) {
-                            std::cout << "SUCCESS!!!" << std::endl;
-                        } else {
-                            std::cout << "!!!FAILLLLLL!!!" << std::endl;
+                        rttr::variant res;
+                        measure(c, [&]() { res = target_method.invoke_variadic(ptr, args); });
+                        if (verbose) {
+                            std::cout << (res.is_valid() ? "SUCCESS!!!" : "!!!FAILLLLLL!!!") << std::endl;
                         }
                     }
                 }
             }
         }
         update_elems();
-        for (const auto &t : all_timelines) {
-            assert(t->checkConsistency());
+        if (verbose) {
+            for (const auto &t : all_timelines) {
+                assert(t->checkConsistency());
+            }
         }
     }
     undoStack->clear();
@@ -503,7 +552,9 @@ void fuzz(const std::string &input)
     pCore->m_projectManager = nullptr;
     Core::m_self.reset();
     MltConnection::m_self.reset();
-    std::cout << "---------------------------------------------------------------------------------------------------------------------------------------------"
-                 "---------------"
-              << std::endl;
+    if (verbose) {
+        std::cout << "---------------------------------------------------------------------------------------------------------------------------------------------"
+                     "---------------"
+                  << std::endl;
+    }
 }
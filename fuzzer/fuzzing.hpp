@@ -21,6 +21,29 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
 #include <string>
+#include <vector>
 
-void fuzz(const std::string &input);
+/** @brief Cost of each replayed operation, collected by fuzz() for the trace replay benchmark */
+struct ReplayStats
+{
+    struct Sample
+    {
+        double usecs;
+        size_t allocations;
+    };
+    /// @brief Samples by operation name ("undo", "redo", "constr_ClipModel", "requestClipMove", ...)
+    std::map<std::string, std::vector<Sample>> samples;
+    /// @brief Returns the number of allocations made so far, optional
+    std::function<size_t()> allocationCounter;
+    /// @brief Number of operations kept by the model tracing during the replay, like in the application
+    size_t traceCapacity = 1000;
+};
+
+/** @brief Replays a fuzzer input or a recorded trace against a fresh model.
+ * When @param stats is given, each operation is timed and the consistency checks and verbose output are skipped.
+ * Recorded sessions do not contain the creation of bin clips, so a clip is then synthesized for each bin id they use.
+ */
+void fuzz(const std::string &input, ReplayStats *stats = nullptr);
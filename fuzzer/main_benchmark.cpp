@@ -0,0 +1,262 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+/* Replays recorded model traces (the fuzz_case_*.txt files written by Logger::print_trace) and reports the latency of each
+ * operation type. Usage: trace_benchmark [-repeat N] trace_file...
+ */
+
+#include "core.h"
+#include "fuzzing.hpp"
+#include <QApplication>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+namespace {
+std::atomic<size_t> allocationCount{0};
+
+double percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0.;
+    }
+    size_t ix = std::min(sorted.size() - 1, size_t(p * double(sorted.size() - 1) + 0.5));
+    return sorted[ix];
+}
+} // namespace
+
+// Count every allocation made by the replay
+void *operator new(size_t size)
+{
+    ++allocationCount;
+    void *ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    ++allocationCount;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+#if __cpp_aligned_new
+namespace {
+void *alignedAlloc(size_t size, std::align_val_t alignment)
+{
+    ++allocationCount;
+    size_t align = std::max(size_t(alignment), sizeof(void *));
+#ifdef _WIN32
+    return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, align, size == 0 ? 1 : size) != 0) {
+        return nullptr;
+    }
+    return ptr;
+#endif
+}
+
+void alignedFree(void *ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+} // namespace
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    void *ptr = alignedAlloc(size, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return alignedAlloc(size, alignment);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return alignedAlloc(size, alignment);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    alignedFree(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    alignedFree(ptr);
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+    qputenv("MLT_TESTS", QByteArray("1"));
+    QStringList args = app.arguments();
+    args.removeFirst();
+    int repeat = 1;
+    if (args.count() > 1 && args.at(0) == QLatin1String("-repeat")) {
+        repeat = std::max(1, args.at(1).toInt());
+        args = args.mid(2);
+    }
+    if (args.isEmpty()) {
+        std::cerr << "Usage: trace_benchmark [-repeat N] trace_file..." << std::endl;
+        return 1;
+    }
+
+    ReplayStats stats;
+    stats.allocationCounter = []() { return allocationCount.load(std::memory_order_relaxed); };
+    for (const QString &file : qAsConst(args)) {
+        std::ifstream in(file.toStdString());
+        if (!in) {
+            std::cerr << "Cannot read " << file.toStdString() << std::endl;
+            return 1;
+        }
+        std::stringstream ss;
+        ss << in.rdbuf();
+        for (int i = 0; i < repeat; ++i) {
+            Core::build(false);
+            fuzz(ss.str(), &stats);
+        }
+    }
+
+    // Report, most expensive operations first
+    struct Row
+    {
+        std::string name;
+        size_t count;
+        double total, p50, p99, max;
+        size_t allocations;
+    };
+    std::vector<Row> rows;
+    double total = 0.;
+    size_t totalAllocations = 0;
+    for (const auto &op : stats.samples) {
+        std::vector<double> times;
+        Row row{op.first, op.second.size(), 0., 0., 0., 0., 0};
+        for (const auto &sample : op.second) {
+            times.push_back(sample.usecs);
+            row.total += sample.usecs;
+            row.allocations += sample.allocations;
+        }
+        std::sort(times.begin(), times.end());
+        row.p50 = percentile(times, 0.5);
+        row.p99 = percentile(times, 0.99);
+        row.max = times.empty() ? 0. : times.back();
+        total += row.total;
+        totalAllocations += row.allocations;
+        rows.push_back(row);
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) { return a.total > b.total; });
+
+    std::cout << std::left << std::setw(40) << "operation" << std::right << std::setw(8) << "count" << std::setw(12) << "p50 (us)" << std::setw(12)
+              << "p99 (us)" << std::setw(12) << "max (us)" << std::setw(12) << "total (ms)" << std::setw(14) << "allocations" << std::setw(12) << "alloc/op"
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Row &row : rows) {
+        std::cout << std::left << std::setw(40) << row.name << std::right << std::setw(8) << row.count << std::setw(12) << row.p50 << std::setw(12) << row.p99
+                  << std::setw(12) << row.max << std::setw(12) << row.total / 1000. << std::setw(14) << row.allocations << std::setw(12)
+                  << double(row.allocations) / double(std::max<size_t>(1, row.count)) << std::endl;
+    }
+    std::cout << "Total: " << total / 1000. << " ms, " << totalAllocations << " allocations" << std::endl;
+    return 0;
+}
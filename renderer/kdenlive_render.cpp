@@ -47,6 +47,17 @@ int main(int argc, char **argv)
             pid = args.at(0).section(QLatin1Char(':'), 1).toInt();
             args.removeFirst();
         }
+        // number of segments to render in parallel, and FFmpeg used to join them
+        int segments = 1;
+        QString ffmpeg;
+        while (args.count() > 0 && (args.at(0).startsWith(QLatin1String("-segments:")) || args.at(0).startsWith(QLatin1String("-ffmpeg:")))) {
+            if (args.at(0).startsWith(QLatin1String("-segments:"))) {
+                segments = args.at(0).section(QLatin1Char(':'), 1).toInt();
+            } else {
+                ffmpeg = args.at(0).section(QLatin1Char(':'), 1, -1);
+            }
+            args.removeFirst();
+        }
         // Do we want a split render
         if (args.count() > 0 && args.at(0) == QLatin1String("-split")) {
             args.removeFirst();
@@ -140,6 +151,9 @@ int main(int argc, char **argv)
         }
 
         auto *rJob = new RenderJob(render, playlist, target, pid, in, out, qApp);
+        if (segments > 1 && !ffmpeg.isEmpty()) {
+            rJob->setSegments(segments, ffmpeg);
+        }
         rJob->start();
         QObject::connect(rJob, &RenderJob::renderingFinished, [&, rJob]() {
             rJob->deleteLater();
@@ -19,11 +19,14 @@
 
 #include "renderjob.h"
 
+#include <QDomDocument>
 #include <QFile>
 #include <QStringList>
 #include <QThread>
 #include <QtDBus>
 #include <QElapsedTimer>
+#include <algorithm>
+#include <numeric>
 #include <utility>
 // Can't believe I need to do this to sleep.
 class SleepThread : QThread
@@ -51,6 +54,9 @@ RenderJob::RenderJob(const QString &render, const QString &scenelist, const QStr
     , m_frameout(out)
     , m_pid(pid)
     , m_dualpass(false)
+    , m_segmentCount(1)
+    , m_runningSegments(0)
+    , m_firstPass(false)
 {
     m_renderProcess = new QProcess;
     m_renderProcess->setReadChannel(QProcess::StandardError);
@@ -82,6 +88,12 @@ RenderJob::~RenderJob()
     m_logfile.close();
 }
 
+void RenderJob::setSegments(int segments, const QString &ffmpeg)
+{
+    m_segmentCount = segments;
+    m_ffmpeg = ffmpeg;
+}
+
 void RenderJob::slotAbort(const QString &url)
 {
     if (m_dest == url) {
@@ -92,7 +104,12 @@ void RenderJob::slotAbort(const QString &url)
 void RenderJob::slotAbort()
 {
     qWarning() << "Job aborted by user...";
+    m_runningSegments = 0;
+    for (QProcess *process : qAsConst(m_segmentProcesses)) {
+        process->kill();
+    }
     m_renderProcess->kill();
+    cleanupSegments();
 
     if (m_kdenliveinterface) {
         m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingFinished"), {m_dest, -3, QString()});
@@ -119,47 +136,56 @@ void RenderJob::receivedStderr()
     } else {
         int progress = result.section(QLatin1Char(' '), -1).toInt();
         int frame = result.section(QLatin1Char(','), 0, 0).section(QLatin1Char(' '), -1).toInt();
-        if (progress <= m_progress || progress <= 0 || progress > 100) {
-            return;
-        }
-        m_progress = progress;
-        if (m_args.contains(QStringLiteral("pass=1"))) {
-            m_progress /= 2.0;
-        } else if (m_args.contains(QStringLiteral("pass=2"))) {
-            m_progress = 50 + m_progress / 2.0;
-        }
-        if ((m_kdenliveinterface != nullptr) && m_kdenliveinterface->isValid()) {
-            m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingProgress"), {m_dest, m_progress, frame});
-        }
-        qint64 elapsedTime = m_startTime.secsTo(QDateTime::currentDateTime());
-        if (elapsedTime == m_seconds) {
-            return;
-        }
-        int speed = (frame - m_frame) / (elapsedTime - m_seconds);
-        if (m_jobUiserver) {
-            qint64 remaining = elapsedTime * (100 - progress) / progress;
-            int days = int(remaining / 86400);
-            int remainingSecs = int(remaining % 86400);
-            QTime when = QTime(0, 0, 0, 0).addSecs(remainingSecs);
-            QString est = tr("Remaining time ");
-            if (days > 0) {
-                est.append(tr("%n day(s) ", "", days));
-            }
-            est.append(when.toString(QStringLiteral("hh:mm:ss")));
+        updateProgress(progress, frame);
+    }
+}
 
-            m_jobUiserver->call(QStringLiteral("setPercent"), uint(m_progress));
-            m_jobUiserver->call(QStringLiteral("setDescriptionField"), 0, QString(), est);
-            m_jobUiserver->call(QStringLiteral("setProcessedAmount"), qulonglong(frame - m_framein), tr("frames"));
-            m_jobUiserver->call(QStringLiteral("setSpeed"), qulonglong(speed));
+void RenderJob::updateProgress(int progress, int frame)
+{
+    if (progress <= m_progress || progress <= 0 || progress > 100) {
+        return;
+    }
+    m_progress = progress;
+    if (m_args.contains(QStringLiteral("pass=1"))) {
+        m_progress /= 2.0;
+    } else if (m_args.contains(QStringLiteral("pass=2"))) {
+        m_progress = 50 + m_progress / 2.0;
+    }
+    if ((m_kdenliveinterface != nullptr) && m_kdenliveinterface->isValid()) {
+        m_kdenliveinterface->callWithArgumentList(QDBus::NoBlock, QStringLiteral("setRenderingProgress"), {m_dest, m_progress, frame});
+    }
+    qint64 elapsedTime = m_startTime.secsTo(QDateTime::currentDateTime());
+    if (elapsedTime == m_seconds) {
+        return;
+    }
+    int speed = (frame - m_frame) / (elapsedTime - m_seconds);
+    if (m_jobUiserver) {
+        qint64 remaining = elapsedTime * (100 - progress) / progress;
+        int days = int(remaining / 86400);
+        int remainingSecs = int(remaining % 86400);
+        QTime when = QTime(0, 0, 0, 0).addSecs(remainingSecs);
+        QString est = tr("Remaining time ");
+        if (days > 0) {
+            est.append(tr("%n day(s) ", "", days));
         }
-        m_seconds = elapsedTime;
-        m_frame = frame;
-        m_logstream << QStringLiteral("%1\t%2\t%3\t%4\n").arg(m_seconds).arg(m_frame).arg(m_progress).arg(speed);
+        est.append(when.toString(QStringLiteral("hh:mm:ss")));
+
+        m_jobUiserver->call(QStringLiteral("setPercent"), uint(m_progress));
+        m_jobUiserver->call(QStringLiteral("setDescriptionField"), 0, QString(), est);
+        m_jobUiserver->call(QStringLiteral("setProcessedAmount"), qulonglong(frame - m_framein), tr("frames"));
+        m_jobUiserver->call(QStringLiteral("setSpeed"), qulonglong(speed));
     }
+    m_seconds = elapsedTime;
+    m_frame = frame;
+    m_logstream << QStringLiteral("%1\t%2\t%3\t%4\n").arg(m_seconds).arg(m_frame).arg(m_progress).arg(speed);
 }
 
 void RenderJob::start()
 {
+    if (m_segmentCount > 1 && !prepareSegments()) {
+        m_logstream << "Cannot split playlist, rendering in a single process" << "\n";
+        m_segmentCount = 1;
+    }
     QDBusConnectionInterface *interface = QDBusConnection::sessionBus().interface();
     if ((interface != nullptr) && m_usekuiserver) {
         if (!interface->isServiceRegistered(QStringLiteral("org.kde.JobViewServer"))) {
@@ -210,6 +236,25 @@ void RenderJob::start()
 
     // Because of the logging, we connect to stderr in all cases.
     connect(m_renderProcess, &QProcess::readyReadStandardError, this, &RenderJob::receivedStderr);
+    if (m_segmentCount > 1) {
+        // The video segments, followed by the audio when it is rendered separately
+        const int processes = m_segmentPlaylists.count();
+        m_runningSegments = processes;
+        for (int i = 0; i < processes; i++) {
+            auto *process = new QProcess(this);
+            process->setReadChannel(QProcess::StandardError);
+            connect(process, &QProcess::readyReadStandardError, this, &RenderJob::receivedSegmentStderr);
+            connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &RenderJob::slotSegmentFinished);
+            m_segmentProcesses << process;
+        }
+        for (int i = 0; i < processes; i++) {
+            const QStringList args = {QStringLiteral("-progress"), m_segmentPlaylists.at(i)};
+            m_segmentProcesses.at(i)->start(m_prog, args);
+            m_logstream << "Started render process: " << m_prog << ' ' << args.join(QLatin1Char(' ')) << "\n";
+        }
+        m_logstream.flush();
+        return;
+    }
     m_renderProcess->start(m_prog, m_args);
     m_logstream << "Started render process: " << m_prog << ' ' << m_args.join(QLatin1Char(' ')) << "\n";
     m_logstream.flush();
@@ -255,6 +300,7 @@ void RenderJob::slotCheckProcess(QProcess::ProcessState state)
 
 void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
 {
+    cleanupSegments();
     if (m_jobUiserver) {
         m_jobUiserver->call(QStringLiteral("setDescriptionField"), (uint)1, tr("Rendered file"), m_dest);
         m_jobUiserver->call(QStringLiteral("terminate"), QString());
@@ -308,3 +354,286 @@ void RenderJob::slotIsOver(QProcess::ExitStatus status, bool isWritable)
     }
     emit renderingFinished();
 }
+
+bool RenderJob::prepareSegments()
+{
+    QString playlistPath = m_scenelist;
+    bool multi = false;
+    if (playlistPath.startsWith(QLatin1String("xml:"))) {
+        playlistPath.remove(0, 4);
+        if (playlistPath.endsWith(QLatin1String("?multi=1"))) {
+            playlistPath.chop(8);
+            multi = true;
+        }
+    }
+    QFile f(playlistPath);
+    QDomDocument doc;
+    if (!f.open(QIODevice::ReadOnly) || !doc.setContent(&f, false)) {
+        return false;
+    }
+    f.close();
+    QDomElement consumer = doc.documentElement().firstChildElement(QStringLiteral("consumer"));
+    if (consumer.isNull() || consumer.attribute(QStringLiteral("mlt_service")) != QLatin1String("avformat")) {
+        return false;
+    }
+    const QString target = consumer.attribute(QStringLiteral("target"));
+    if (target.contains(QRegExp(QStringLiteral("%[0-9]*d")))) {
+        // Image sequence, nothing to join
+        return false;
+    }
+    int in = consumer.attribute(QStringLiteral("in"), QStringLiteral("0")).toInt();
+    int out = consumer.attribute(QStringLiteral("out"), QStringLiteral("-1")).toInt();
+    // Don't bother with segments shorter than 10 seconds at 25fps
+    int segments = qMin(m_segmentCount, (out - in + 1) / 250);
+    if (segments < 2) {
+        return false;
+    }
+
+    // Collect the clip boundaries of all tracks, a cut there is invisible in the result
+    QVector<int> cuts;
+    QDomNodeList playlists = doc.elementsByTagName(QStringLiteral("playlist"));
+    for (int i = 0; i < playlists.count(); i++) {
+        int pos = 0;
+        QDomNode child = playlists.at(i).firstChild();
+        while (!child.isNull()) {
+            QDomElement e = child.toElement();
+            bool ok = true;
+            if (e.tagName() == QLatin1String("entry")) {
+                pos += e.attribute(QStringLiteral("out")).toInt(&ok) - e.attribute(QStringLiteral("in")).toInt() + 1;
+            } else if (e.tagName() == QLatin1String("blank")) {
+                pos += e.attribute(QStringLiteral("length")).toInt(&ok);
+            }
+            if (!ok) {
+                // Time stored as clock value, ignore this track
+                break;
+            }
+            if (pos > in && pos < out) {
+                cuts << pos;
+            }
+            child = child.nextSibling();
+        }
+    }
+    std::sort(cuts.begin(), cuts.end());
+
+    // Choose segment starts, moved to the closest clip boundary when there is one nearby
+    const int length = out - in + 1;
+    const int tolerance = length / segments / 4;
+    QVector<int> starts = {in};
+    for (int i = 1; i < segments; i++) {
+        int ideal = in + length * i / segments;
+        int best = ideal;
+        auto it = std::lower_bound(cuts.constBegin(), cuts.constEnd(), ideal - tolerance);
+        while (it != cuts.constEnd() && *it <= ideal + tolerance) {
+            if (qAbs(*it - ideal) < qAbs(best - ideal) || best == ideal) {
+                best = *it;
+            }
+            ++it;
+        }
+        if (best > starts.last()) {
+            starts << best;
+        }
+    }
+    segments = starts.count();
+    if (segments < 2) {
+        return false;
+    }
+
+    m_firstPass = consumer.attribute(QStringLiteral("pass")) == QLatin1String("1") ||
+                  consumer.attribute(QStringLiteral("x265-params")).startsWith(QLatin1String("pass=1:"));
+    const QFileInfo info(target);
+    const QString baseName = QFileInfo(playlistPath).completeBaseName();
+    // The first pass only produces statistics
+    const bool hasAudio = !m_firstPass && consumer.attribute(QStringLiteral("an")) != QLatin1String("1") &&
+                          consumer.attribute(QStringLiteral("audio_off")) != QLatin1String("1");
+    for (int i = 0; i < segments; i++) {
+        int segmentOut = i + 1 < segments ? starts.at(i + 1) - 1 : out;
+        QString segmentFile = info.absoluteDir().absoluteFilePath(QStringLiteral(".%1-seg%2.%3").arg(info.completeBaseName()).arg(i).arg(info.suffix()));
+        QDomDocument segmentDoc = doc.cloneNode(true).toDocument();
+        QDomElement segmentConsumer = segmentDoc.documentElement().firstChildElement(QStringLiteral("consumer"));
+        segmentConsumer.setAttribute(QStringLiteral("target"), segmentFile);
+        segmentConsumer.setAttribute(QStringLiteral("in"), starts.at(i));
+        segmentConsumer.setAttribute(QStringLiteral("out"), segmentOut);
+        // Each segment needs its own 2 pass statistics
+        if (segmentConsumer.hasAttribute(QStringLiteral("passlogfile"))) {
+            segmentConsumer.setAttribute(QStringLiteral("passlogfile"),
+                                         segmentConsumer.attribute(QStringLiteral("passlogfile")) + QStringLiteral("_seg%1").arg(i));
+        }
+        if (segmentConsumer.hasAttribute(QStringLiteral("x265-params"))) {
+            QString params = segmentConsumer.attribute(QStringLiteral("x265-params"));
+            params.replace(QLatin1String("_2pass.log"), QStringLiteral("_2pass_seg%1.log").arg(i));
+            segmentConsumer.setAttribute(QStringLiteral("x265-params"), params);
+        }
+        if (hasAudio) {
+            segmentConsumer.setAttribute(QStringLiteral("an"), 1);
+        }
+        QFile file(QDir::temp().absoluteFilePath(QStringLiteral("%1-seg%2.mlt").arg(baseName).arg(i)));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            cleanupSegments();
+            return false;
+        }
+        file.write(segmentDoc.toString().toUtf8());
+        file.close();
+        m_segmentPlaylists << (multi ? QStringLiteral("xml:%1?multi=1").arg(file.fileName()) : file.fileName());
+        m_segmentFiles << segmentFile;
+        m_segmentLength << segmentOut - starts.at(i) + 1;
+        m_segmentProgress << 0;
+    }
+    if (hasAudio) {
+        // Audio encoders add priming samples at the start of each stream, so joining audio
+        // segments leaves gaps at the boundaries. Render the whole audio in one pass instead.
+        m_audioFile = info.absoluteDir().absoluteFilePath(QStringLiteral(".%1-audio.%2").arg(info.completeBaseName(), info.suffix()));
+        QDomDocument audioDoc = doc.cloneNode(true).toDocument();
+        QDomElement audioConsumer = audioDoc.documentElement().firstChildElement(QStringLiteral("consumer"));
+        audioConsumer.setAttribute(QStringLiteral("target"), m_audioFile);
+        audioConsumer.setAttribute(QStringLiteral("vn"), 1);
+        audioConsumer.removeAttribute(QStringLiteral("pass"));
+        audioConsumer.removeAttribute(QStringLiteral("passlogfile"));
+        QFile file(QDir::temp().absoluteFilePath(QStringLiteral("%1-audio.mlt").arg(baseName)));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            cleanupSegments();
+            return false;
+        }
+        file.write(audioDoc.toString().toUtf8());
+        file.close();
+        m_segmentPlaylists << (multi ? QStringLiteral("xml:%1?multi=1").arg(file.fileName()) : file.fileName());
+        // Audio encoding is fast, it is not counted in the progress
+        m_segmentLength << 0;
+        m_segmentProgress << 0;
+    }
+    m_segmentCount = segments;
+    m_frame = m_framein = in;
+    m_frameout = length;
+    return true;
+}
+
+void RenderJob::receivedSegmentStderr()
+{
+    auto *process = qobject_cast<QProcess *>(sender());
+    int ix = m_segmentProcesses.indexOf(process);
+    if (ix < 0) {
+        return;
+    }
+    QString result = QString::fromLocal8Bit(process->readAllStandardError()).simplified();
+    if (!result.startsWith(QLatin1String("Current Frame"))) {
+        m_errorMessage.append(result + QStringLiteral("<br>"));
+        m_logstream << result;
+        return;
+    }
+    int percent = result.section(QLatin1Char(' '), -1).toInt();
+    m_segmentProgress[ix] = m_segmentLength.at(ix) * qBound(0, percent, 100) / 100;
+    int done = std::accumulate(m_segmentProgress.constBegin(), m_segmentProgress.constEnd(), 0);
+    // Keep the last percent for joining the segments
+    updateProgress(qMin(99, 100 * done / m_frameout), m_framein + done);
+}
+
+void RenderJob::slotSegmentFinished(int exitCode, QProcess::ExitStatus status)
+{
+    if (m_runningSegments <= 0) {
+        // Already failed or aborted
+        return;
+    }
+    if (status == QProcess::CrashExit || exitCode != 0) {
+        int ix = m_segmentProcesses.indexOf(qobject_cast<QProcess *>(sender()));
+        m_logstream << "Segment " << ix << " failed, stopping render" << "\n";
+        m_runningSegments = 0;
+        for (QProcess *process : qAsConst(m_segmentProcesses)) {
+            process->kill();
+        }
+        slotIsOver(QProcess::CrashExit);
+        return;
+    }
+    if (--m_runningSegments > 0) {
+        return;
+    }
+    if (m_firstPass) {
+        // Only the statistics are needed for the second pass
+        slotIsOver(QProcess::NormalExit);
+        return;
+    }
+    startConcat();
+}
+
+void RenderJob::startConcat()
+{
+    QFile list(QDir::temp().absoluteFilePath(QStringLiteral("%1-segments.txt").arg(QFileInfo(m_dest).completeBaseName())));
+    if (!list.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_errorMessage.append(tr("Cannot write to %1").arg(list.fileName()));
+        slotIsOver(QProcess::CrashExit);
+        return;
+    }
+    QTextStream stream(&list);
+    for (const QString &segment : qAsConst(m_segmentFiles)) {
+        QString path = segment;
+        stream << "file '" << path.replace(QLatin1Char('\''), QLatin1String("'\\''")) << "'\n";
+    }
+    stream.flush();
+    list.close();
+    m_segmentPlaylists << list.fileName();
+    // All segments start on a key frame, so the streams can be copied as is
+    QStringList args = {QStringLiteral("-y"),   QStringLiteral("-v"), QStringLiteral("error"), QStringLiteral("-f"), QStringLiteral("concat"),
+                        QStringLiteral("-safe"), QStringLiteral("0"), QStringLiteral("-i"),    list.fileName()};
+    if (!m_audioFile.isEmpty()) {
+        args << QStringLiteral("-i") << m_audioFile << QStringLiteral("-map") << QStringLiteral("0") << QStringLiteral("-map") << QStringLiteral("1:a");
+    } else {
+        args << QStringLiteral("-map") << QStringLiteral("0");
+    }
+    args << QStringLiteral("-c") << QStringLiteral("copy") << m_dest;
+    auto *process = new QProcess(this);
+    process->setReadChannel(QProcess::StandardError);
+    connect(process, &QProcess::readyReadStandardError, this, [this, process]() {
+        const QString result = QString::fromLocal8Bit(process->readAllStandardError()).simplified();
+        m_errorMessage.append(result + QStringLiteral("<br>"));
+        m_logstream << result << "\n";
+    });
+    connect(process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &RenderJob::slotConcatFinished);
+    m_segmentProcesses << process;
+    m_runningSegments = 1;
+    process->start(m_ffmpeg, args);
+    m_logstream << "Started concat process: " << m_ffmpeg << ' ' << args.join(QLatin1Char(' ')) << "\n";
+    m_logstream.flush();
+}
+
+void RenderJob::slotConcatFinished(int exitCode, QProcess::ExitStatus status)
+{
+    if (m_runningSegments <= 0) {
+        // Aborted
+        return;
+    }
+    m_runningSegments = 0;
+    if (status == QProcess::CrashExit || exitCode != 0) {
+        // Keep the rendered parts, the result can still be joined by hand
+        m_logstream << "Joining the segments failed, the rendered parts are kept:" << "\n";
+        for (const QString &file : qAsConst(m_segmentFiles)) {
+            m_logstream << file << "\n";
+        }
+        if (!m_audioFile.isEmpty()) {
+            m_logstream << m_audioFile << "\n";
+        }
+        m_segmentFiles.clear();
+        m_audioFile.clear();
+        QFile::remove(m_dest);
+        slotIsOver(QProcess::CrashExit);
+        return;
+    }
+    slotIsOver(QProcess::NormalExit);
+}
+
+void RenderJob::cleanupSegments()
+{
+    for (const QString &file : qAsConst(m_segmentPlaylists)) {
+        QString path = file;
+        if (path.startsWith(QLatin1String("xml:"))) {
+            path = path.mid(4).section(QLatin1Char('?'), 0, 0);
+        }
+        QFile::remove(path);
+    }
+    for (const QString &file : qAsConst(m_segmentFiles)) {
+        QFile::remove(file);
+    }
+    if (!m_audioFile.isEmpty()) {
+        QFile::remove(m_audioFile);
+    }
+    m_segmentPlaylists.clear();
+    m_segmentFiles.clear();
+    m_audioFile.clear();
+}
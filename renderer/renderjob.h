@@ -25,6 +25,7 @@
 #include <QProcess>
 #include <QDateTime>
 #include <QFile>
+#include <QVector>
 // Testing
 #include <QTextStream>
 
@@ -35,6 +36,8 @@ class RenderJob : public QObject
 public:
     RenderJob(const QString &render, const QString &scenelist, const QString &target, int pid = -1, int in = -1, int out = -1, QObject *parent = nullptr);
     ~RenderJob();
+    /** @brief Render the playlist as @param segments parts in parallel and join them with the @param ffmpeg binary */
+    void setSegments(int segments, const QString &ffmpeg);
 
 public slots:
     void start();
@@ -45,6 +48,9 @@ private slots:
     void slotAbort();
     void slotAbort(const QString &url);
     void slotCheckProcess(QProcess::ProcessState state);
+    void receivedSegmentStderr();
+    void slotSegmentFinished(int exitCode, QProcess::ExitStatus status);
+    void slotConcatFinished(int exitCode, QProcess::ExitStatus status);
 
 private:
     QString m_scenelist;
@@ -72,7 +78,28 @@ private:
     QStringList m_args;
     /** @brief Used to write to the log file. */
     QTextStream m_logstream;
+    /** @brief Number of segments rendered in parallel, 1 for a single melt process */
+    int m_segmentCount;
+    QString m_ffmpeg;
+    QList<QProcess *> m_segmentProcesses;
+    /** @brief Rendered frames and length of each segment */
+    QVector<int> m_segmentProgress;
+    QVector<int> m_segmentLength;
+    QStringList m_segmentFiles;
+    QStringList m_segmentPlaylists;
+    /** @brief The audio of a segmented render, rendered in a single pass to avoid encoder priming gaps at the joins */
+    QString m_audioFile;
+    int m_runningSegments;
+    /** @brief True if this job is the first pass of a 2 pass encoding, which produces no file to join */
+    bool m_firstPass;
     void initKdenliveDbusInterface();
+    /** @brief Update the progress display, @param frame is the absolute timeline position */
+    void updateProgress(int progress, int frame);
+    /** @brief Write one playlist per segment, cutting on clip boundaries when possible. Returns false if the playlist cannot be segmented */
+    bool prepareSegments();
+    /** @brief Join the rendered segments and the audio into the destination file without re-encoding */
+    void startConcat();
+    void cleanupSegments();
 
 signals:
     void renderingFinished();
@@ -30,6 +30,7 @@ TreeItem::TreeItem(QList<QVariant> data, const std::shared_ptr<AbstractTreeModel
     , m_model(model)
     , m_depth(0)
     , m_id(id == -1 ? AbstractTreeModel::getNextId() : id)
+    , m_row(-1)
     , m_isInModel(false)
     , m_isRoot(isRoot)
 {
@@ -86,9 +87,8 @@ bool TreeItem::appendChild(const std::shared_ptr<TreeItem> &child)
     if (auto ptr = m_model.lock()) {
         ptr->notifyRowAboutToAppend(shared_from_this());
         child->updateParent(shared_from_this());
-        int id = child->getId();
-        auto it = m_childItems.insert(m_childItems.end(), child);
-        m_iteratorTable[id] = it;
+        child->m_row = int(m_childItems.size());
+        m_childItems.push_back(child);
         registerSelf(child);
         ptr->notifyRowAppended(child);
         return true;
@@ -102,22 +102,23 @@ void TreeItem::moveChild(int ix, const std::shared_ptr<TreeItem> &child)
 {
     if (auto ptr = m_model.lock()) {
         auto parentPtr = child->m_parentItem.lock();
+        int firstChanged = ix;
         if (parentPtr && parentPtr->getId() != m_id) {
             parentPtr->removeChild(child);
-        } else {
+        } else if (parentPtr) {
             // deletion of child
-            auto it = m_iteratorTable[child->getId()];
-            m_childItems.erase(it);
+            firstChanged = qMin(ix, child->m_row);
+            m_childItems.erase(m_childItems.begin() + child->m_row);
         }
         ptr->notifyRowAboutToAppend(shared_from_this());
         child->updateParent(shared_from_this());
-        int id = child->getId();
-        auto pos = m_childItems.begin();
-        std::advance(pos, ix);
-        auto it = m_childItems.insert(pos, child);
-        m_iteratorTable[id] = it;
+        m_childItems.insert(m_childItems.begin() + ix, child);
+        updateRows(firstChanged);
+        if (!child->isInModel()) {
+            // the child was deregistered when removed from its previous parent
+            registerSelf(child);
+        }
         ptr->notifyRowAppended(child);
-        m_isInModel = true;
     } else {
         qDebug() << "ERROR: Something went wrong when moving child in TreeItem. Model is not available anymore";
         Q_ASSERT(false);
@@ -127,14 +128,13 @@ void TreeItem::moveChild(int ix, const std::shared_ptr<TreeItem> &child)
 void TreeItem::removeChild(const std::shared_ptr<TreeItem> &child)
 {
     if (auto ptr = m_model.lock()) {
-        ptr->notifyRowAboutToDelete(shared_from_this(), child->row());
-        // get iterator corresponding to child
-        Q_ASSERT(m_iteratorTable.count(child->getId()) > 0);
-        auto it = m_iteratorTable[child->getId()];
+        int row = child->row();
+        ptr->notifyRowAboutToDelete(shared_from_this(), row);
+        Q_ASSERT(row >= 0 && row < (int)m_childItems.size() && m_childItems[size_t(row)] == child);
         // deletion of child
-        m_childItems.erase(it);
-        // clean iterator table
-        m_iteratorTable.erase(child->getId());
+        m_childItems.erase(m_childItems.begin() + row);
+        updateRows(row);
+        child->m_row = -1;
         child->m_depth = 0;
         child->m_parentItem.reset();
         child->deregisterSelf();
@@ -170,9 +170,7 @@ bool TreeItem::changeParent(std::shared_ptr<TreeItem> newParent)
 std::shared_ptr<TreeItem> TreeItem::child(int row) const
 {
     Q_ASSERT(row >= 0 && row < (int)m_childItems.size());
-    auto it = m_childItems.cbegin();
-    std::advance(it, row);
-    return (*it);
+    return m_childItems[size_t(row)];
 }
 
 int TreeItem::childCount() const
@@ -202,14 +200,19 @@ std::weak_ptr<TreeItem> TreeItem::parentItem() const
 
 int TreeItem::row() const
 {
-    if (auto ptr = m_parentItem.lock()) {
-        // we compute the distance in the parent's children list
-        auto it = ptr->m_childItems.begin();
-        return (int)std::distance(it, (decltype(it))ptr->m_iteratorTable.at(m_id));
+    if (!m_parentItem.expired()) {
+        return m_row;
     }
     return -1;
 }
 
+void TreeItem::updateRows(int from)
+{
+    for (size_t i = size_t(qMax(0, from)); i < m_childItems.size(); ++i) {
+        m_childItems[i]->m_row = int(i);
+    }
+}
+
 int TreeItem::depth() const
 {
     return m_depth;
@@ -26,7 +26,7 @@
 #include <QList>
 #include <QVariant>
 #include <memory>
-#include <unordered_map>
+#include <vector>
 
 /* @brief This class is a generic class to represent items of a tree-like model
    It works in tandem with AbstractTreeModel or one of its derived classes.
@@ -155,9 +155,10 @@ protected:
     */
     virtual void updateParent(std::shared_ptr<TreeItem> parent);
 
-    std::list<std::shared_ptr<TreeItem>> m_childItems;
-    std::unordered_map<int, std::list<std::shared_ptr<TreeItem>>::iterator>
-        m_iteratorTable; // this logs the iterator associated which each child id. This allows easy access of a child based on its id.
+    /* @brief Set the row of the children starting at the given index, after an insertion or a removal */
+    void updateRows(int from);
+
+    std::vector<std::shared_ptr<TreeItem>> m_childItems;
 
     QList<QVariant> m_itemData;
     std::weak_ptr<TreeItem> m_parentItem;
@@ -165,6 +166,7 @@ protected:
     std::weak_ptr<AbstractTreeModel> m_model;
     int m_depth;
     int m_id;
+    int m_row; // index of the item amongst its parent's children, maintained by the parent
 
     bool m_isInModel;
     bool m_isRoot;
@@ -209,7 +209,7 @@ private:
     ParamType m_paramType;
     mutable QReadWriteLock m_lock; // This is a lock that ensures safety in case of concurrent access
 
-    std::map<GenTime, std::pair<KeyframeType, QVariant>> m_keyframeList;
+    std::map<TickTime, std::pair<KeyframeType, QVariant>> m_keyframeList;
 
 signals:
     void modelChanged();
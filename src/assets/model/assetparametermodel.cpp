@@ -30,6 +30,7 @@
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QString>
+#include <QThread>
 #include <effects/effectsrepository.hpp>
 #define DEBUG_LOCALE false
 
@@ -44,6 +45,13 @@ AssetParameterModel::AssetParameterModel(std::unique_ptr<Mlt::Properties> asset,
     , m_keyframes(nullptr)
 {
     Q_ASSERT(m_asset->is_valid());
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(0);
+    connect(&m_updateTimer, &QTimer::timeout, this, &AssetParameterModel::flushOwnerUpdates);
+    // Timeline preview chunks are only invalidated once the parameters stop changing
+    m_invalidateTimer.setSingleShot(true);
+    m_invalidateTimer.setInterval(500);
+    connect(&m_invalidateTimer, &QTimer::timeout, this, [this]() { pCore->invalidateItem(m_ownerId); });
     QDomNodeList parameterNodes = assetXml.elementsByTagName(QStringLiteral("parameter"));
     m_hideKeyframesByDefault = assetXml.hasAttribute(QStringLiteral("hideKeyframes"));
     m_isAudio = assetXml.attribute(QStringLiteral("type")) == QLatin1String("audio");
@@ -281,16 +289,7 @@ void AssetParameterModel::setParameter(const QString &name, int value, bool upda
         emit replugEffect(shared_from_this());
     }
     if (update) {
-        emit modelChanged();
-        emit dataChanged(index(0, 0), index(m_rows.count() - 1, 0), {});
-        // Update fades in timeline
-        pCore->updateItemModel(m_ownerId, m_assetId);
-        if (!m_isAudio) {
-            // Trigger monitor refresh
-            pCore->refreshProjectItem(m_ownerId);
-            // Invalidate timeline preview
-            pCore->invalidateItem(m_ownerId);
-        }
+        scheduleOwnerUpdate(true, m_rows.indexOf(name));
     }
 }
 
@@ -368,33 +367,62 @@ void AssetParameterModel::setParameter(const QString &name, const QString &param
         // these effects don't understand param change and need to be rebuild
         emit replugEffect(shared_from_this());
         updateChildRequired = false;
-    } else if (update) {
-        qDebug() << "// SENDING DATA CHANGE....";
-        if (paramIndex.isValid()) {
-            emit dataChanged(paramIndex, paramIndex);
-        } else {
-            QModelIndex ix = index(m_rows.indexOf(name), 0);
-            emit dataChanged(ix, ix);
-        }
-        emit modelChanged();
     }
     if (updateChildRequired) {
         emit updateChildren(name);
     }
-    // Update timeline view if necessary
-    if (m_ownerId.first == ObjectType::NoItem) {
+    // Notify the views, and update timeline view if necessary
+    bool notify = update && updateChildRequired;
+    if (m_ownerId.first == ObjectType::NoItem && !update) {
         // Used for generator clips
-        if (!update) emit modelChanged();
-    } else {
-        // Update fades in timeline
-        pCore->updateItemModel(m_ownerId, m_assetId);
-        if (!m_isAudio) {
-            // Trigger monitor refresh
-            pCore->refreshProjectItem(m_ownerId);
-            // Invalidate timeline preview
-            pCore->invalidateItem(m_ownerId);
+        emit modelChanged();
+    } else if (notify || m_ownerId.first != ObjectType::NoItem) {
+        scheduleOwnerUpdate(notify, paramIndex.isValid() ? paramIndex.row() : m_rows.indexOf(name));
+    }
+}
+
+void AssetParameterModel::scheduleOwnerUpdate(bool notify, int row)
+{
+    if (notify) {
+        QMutexLocker lock(&m_pendingMutex);
+        m_pendingChange = true;
+        if (row > -1) {
+            m_pendingRows.insert(row);
         }
     }
+    // The timers can only be started from the thread owning the model
+    QMetaObject::invokeMethod(&m_updateTimer, "start", QThread::currentThread() == thread() ? Qt::DirectConnection : Qt::QueuedConnection);
+    if (!m_isAudio && m_ownerId.first != ObjectType::NoItem) {
+        QMetaObject::invokeMethod(&m_invalidateTimer, "start", QThread::currentThread() == thread() ? Qt::DirectConnection : Qt::QueuedConnection);
+    }
+}
+
+void AssetParameterModel::flushOwnerUpdates()
+{
+    QSet<int> rows;
+    bool changed = false;
+    {
+        QMutexLocker lock(&m_pendingMutex);
+        rows.swap(m_pendingRows);
+        std::swap(changed, m_pendingChange);
+    }
+    if (changed) {
+        for (int row : qAsConst(rows)) {
+            emit dataChanged(index(row, 0), index(row, 0));
+        }
+        emit modelChanged();
+    }
+    if (m_ownerId.first == ObjectType::NoItem) {
+        return;
+    }
+    // Update fades in timeline
+    pCore->updateItemModel(m_ownerId, m_assetId);
+    if (!m_isAudio) {
+        // Frames cached for scrubbing are stale right away, only the timeline preview waits for the end of the interaction
+        pCore->invalidateMonitorFrames(m_ownerId);
+        // Trigger monitor refresh, the monitor renders the latest values
+        pCore->refreshProjectItem(m_ownerId);
+    }
 }
 
 AssetParameterModel::~AssetParameterModel() = default;
@@ -27,6 +27,9 @@
 #include <QAbstractListModel>
 #include <QDomElement>
 #include <QJsonDocument>
+#include <QMutex>
+#include <QSet>
+#include <QTimer>
 #include <unordered_map>
 
 #include <memory>
@@ -242,6 +245,25 @@ protected:
      */
     void internalSetParameter(const QString &name, const QString &paramValue, const QModelIndex &paramIndex = QModelIndex());
 
+    /* @brief Update the views and the owner of the asset (timeline item and monitor) after a parameter change.
+       Changes made during the same event loop pass are sent together, and the timeline preview is only
+       invalidated once the parameters stop changing, so that dragging a slider does not flood the monitor.
+       @param notify whether the views must be notified of the change
+       @param row the changed row, or -1 if it is not displayed
+    */
+    void scheduleOwnerUpdate(bool notify = false, int row = -1);
+    /* @brief Send the row changes and owner updates collected by scheduleOwnerUpdate */
+    void flushOwnerUpdates();
+
+    // Timer firing on the next event loop pass, to send the pending owner updates at once
+    QTimer m_updateTimer;
+    // Timer delaying the timeline preview invalidation until the end of an interaction
+    QTimer m_invalidateTimer;
+    // Rows changed since the last flush, parameters can be set from other threads
+    QSet<int> m_pendingRows;
+    bool m_pendingChange = false;
+    QMutex m_pendingMutex;
+
 signals:
     void modelChanged();
     /** @brief inform child effects (in case of bin effect with timeline producers)
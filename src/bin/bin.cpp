@@ -1196,9 +1196,13 @@ Bin::Bin(std::shared_ptr<ProjectItemModel> model, QWidget *parent)
     m_discardCurrentClipJobs->setCheckable(false);
     m_discardPendingJobs = new QAction(i18n("Cancel Pending Jobs"), this);
     m_discardPendingJobs->setCheckable(false);
+    m_pauseJobs = new QAction(i18n("Pause Encoding Jobs"), this);
+    m_pauseJobs->setCheckable(true);
     m_jobsMenu->addAction(m_cancelJobs);
     m_jobsMenu->addAction(m_discardCurrentClipJobs);
     m_jobsMenu->addAction(m_discardPendingJobs);
+    m_jobsMenu->addSeparator();
+    m_jobsMenu->addAction(m_pauseJobs);
     m_infoLabel->setMenu(m_jobsMenu);
     m_infoLabel->setAction(infoAction);
 
@@ -1214,6 +1218,19 @@ Bin::Bin(std::shared_ptr<ProjectItemModel> model, QWidget *parent)
     connect(m_discardPendingJobs, &QAction::triggered, [&]() {
         pCore->jobManager()->slotCancelPendingJobs();
     });
+    connect(m_pauseJobs, &QAction::triggered, this, [&](bool pause) {
+        if (pause) {
+            pCore->jobManager()->slotPauseJobs();
+        } else {
+            pCore->jobManager()->slotResumeJobs();
+        }
+    });
+    connect(pCore->jobManager().get(), &JobManager::jobCount, m_pauseJobs, [this](int count) {
+        if (count == 0 && m_pauseJobs->isChecked()) {
+            m_pauseJobs->setChecked(false);
+            pCore->jobManager()->slotResumeJobs();
+        }
+    });
 
     // Hack, create toolbar spacer
     QWidget *spacer = new QWidget();
@@ -2774,6 +2791,13 @@ void Bin::setupMenu()
     setupAddClipAction(addClipMenu, ClipType::SlideShow, QStringLiteral("add_slide_clip"), i18n("Add Image Sequence"), QIcon::fromTheme(QStringLiteral("kdenlive-add-slide-clip")));
     setupAddClipAction(addClipMenu, ClipType::Text, QStringLiteral("add_text_clip"), i18n("Add Title Clip"), QIcon::fromTheme(QStringLiteral("kdenlive-add-text-clip")));
     setupAddClipAction(addClipMenu, ClipType::TextTemplate, QStringLiteral("add_text_template_clip"), i18n("Add Template Title"), QIcon::fromTheme(QStringLiteral("kdenlive-add-text-clip")));
+    QAction *addTitleBatch =
+        addAction(QStringLiteral("add_title_batch"), i18n("Add Titles from Data File"), QIcon::fromTheme(QStringLiteral("kdenlive-add-text-clip")));
+    addClipMenu->addAction(addTitleBatch);
+    connect(addTitleBatch, &QAction::triggered, this, [this]() {
+        ClipCreationDialog::createTitleBatchClips(m_doc, getCurrentFolder(), m_itemModel);
+        pCore->window()->raiseBin();
+    });
 
     QAction *downloadResourceAction =
         addAction(QStringLiteral("download_resource"), i18n("Online Resources"), QIcon::fromTheme(QStringLiteral("edit-download")));
@@ -466,6 +466,7 @@ private:
     QAction *m_cancelJobs;
     QAction *m_discardCurrentClipJobs;
     QAction *m_discardPendingJobs;
+    QAction *m_pauseJobs;
     QAction *m_upAction;
     QAction *m_tagAction;
     QActionGroup *m_sortGroup;
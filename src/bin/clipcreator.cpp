@@ -73,6 +73,31 @@ QString ClipCreator::createTitleClip(const std::unordered_map<QString, QString>
     return res ? id : QStringLiteral("-1");
 }
 
+QStringList ClipCreator::createTitleClips(const QStringList &titles, const QStringList &names, int duration, const QString &parentFolder,
+                                         const std::shared_ptr<ProjectItemModel> &model)
+{
+    Fun undo = []() { return true; };
+    Fun redo = []() { return true; };
+    QStringList ids;
+    for (int i = 0; i < titles.count(); ++i) {
+        QDomDocument xml;
+        auto prod = createProducer(xml, ClipType::Text, QString(), names.value(i), duration, QStringLiteral("kdenlivetitle"));
+        std::unordered_map<QString, QString> properties;
+        properties[QStringLiteral("xmldata")] = titles.at(i);
+        Xml::addXmlProperties(prod, properties);
+        QString id;
+        if (!model->requestAddBinClip(id, xml.documentElement(), parentFolder, undo, redo)) {
+            undo();
+            return QStringList();
+        }
+        ids << id;
+    }
+    if (!ids.isEmpty()) {
+        pCore->pushUndo(undo, redo, i18np("Create title clip", "Create %1 title clips", ids.count()));
+    }
+    return ids;
+}
+
 QString ClipCreator::createColorClip(const QString &color, int duration, const QString &name, const QString &parentFolder,
                                      const std::shared_ptr<ProjectItemModel> &model)
 {
@@ -54,6 +54,17 @@ QString createColorClip(const QString &color, int duration, const QString &name,
 QString createTitleClip(const std::unordered_map<QString, QString> &properties, int duration, const QString &name, const QString &parentFolder,
                         const std::shared_ptr<ProjectItemModel> &model);
 
+/* @brief Create several title clips in a single undoable operation
+   @param titles : the xml data of each title
+   @param names : the name of each clip
+   @param duration : duration of the clips
+   @param parentFolder: the binId of the containing folder
+   @param model: a shared pointer to the bin item model
+   @return the binIds of the created clips, empty on failure
+*/
+QStringList createTitleClips(const QStringList &titles, const QStringList &names, int duration, const QString &parentFolder,
+                             const std::shared_ptr<ProjectItemModel> &model);
+
 /* @brief Create a title template
    @param path : path to the template
    @param text : text of the template (optional)
@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "decoderpool.hpp"
+#include "kdenlive_debug.h"
+#include <mlt++/MltProducer.h>
+
+std::unique_ptr<DecoderPool> DecoderPool::instance;
+std::once_flag DecoderPool::m_onceFlag;
+
+DecoderPool::DecoderPool()
+    : m_open(std::make_shared<std::atomic<int>>(0))
+{
+}
+
+std::unique_ptr<DecoderPool> &DecoderPool::get()
+{
+    std::call_once(m_onceFlag, [] { instance.reset(new DecoderPool()); });
+    return instance;
+}
+
+std::shared_ptr<Mlt::Producer> DecoderPool::adopt(Mlt::Producer *producer)
+{
+    // Internal property, not saved in the project
+    producer->set("_kdenlive_pooled", 1);
+    (*m_open)++;
+    m_created++;
+    auto open = m_open;
+    return std::shared_ptr<Mlt::Producer>(producer, [open](Mlt::Producer *prod) {
+        (*open)--;
+        delete prod;
+    });
+}
+
+bool DecoderPool::isPooled(const std::shared_ptr<Mlt::Producer> &producer)
+{
+    return producer && producer->get_int("_kdenlive_pooled") == 1;
+}
+
+bool DecoderPool::isIdle(const std::shared_ptr<Mlt::Producer> &producer)
+{
+    // Each cut holds a reference on its parent, the only remaining one is ours
+    return producer && producer->ref_count() <= 1;
+}
+
+void DecoderPool::touch(const std::shared_ptr<Mlt::Producer> &producer, const std::function<void()> &close)
+{
+    QMutexLocker lock(&m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->producer.lock() == producer) {
+            it->close = close;
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            return;
+        }
+    }
+    m_entries.push_front({producer, close});
+}
+
+void DecoderPool::closeIdle(int maxIdle)
+{
+    std::vector<std::function<void()>> toClose;
+    {
+        QMutexLocker lock(&m_mutex);
+        int idle = 0;
+        // The most recently used producer was just requested, its cut does not exist yet
+        auto it = m_entries.begin();
+        if (it != m_entries.end()) {
+            ++it;
+        }
+        while (it != m_entries.end()) {
+            auto producer = it->producer.lock();
+            if (!producer) {
+                it = m_entries.erase(it);
+                continue;
+            }
+            if (isIdle(producer) && ++idle > maxIdle) {
+                toClose.push_back(it->close);
+                it = m_entries.erase(it);
+                continue;
+            }
+            ++it;
+        }
+    }
+    // Closing releases the producer, do it without holding the lock
+    for (const auto &close : toClose) {
+        close();
+        m_closed++;
+    }
+    if (!toClose.empty()) {
+        qCDebug(KDENLIVE_LOG) << "Closed" << toClose.size() << "idle decoders," << openDecoders() << "still open";
+    }
+}
+
+int DecoderPool::openDecoders() const
+{
+    return *m_open;
+}
+
+int DecoderPool::createdDecoders() const
+{
+    return m_created;
+}
+
+int DecoderPool::closedDecoders() const
+{
+    return m_closed;
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QMutex>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace Mlt {
+class Producer;
+}
+
+/** @brief This class keeps track of the decoders opened for the timeline producers of the bin clips.
+    Each timeline track needs its own producer of a clip (and thus its own decoder), since tracks request frames at different positions.
+    The pool counts the producers that are open, and remembers when each of them was last requested.
+    Producers that are not used by any timeline clip anymore are idle, the least recently used ones are closed when there are too many of them.
+ * Note that this class is a Singleton
+ */
+
+class DecoderPool
+{
+
+public:
+    // Returns the instance of the Singleton
+    static std::unique_ptr<DecoderPool> &get();
+
+    /* @brief Takes ownership of a newly created producer. It is counted as an open decoder until it is deleted */
+    std::shared_ptr<Mlt::Producer> adopt(Mlt::Producer *producer);
+
+    /* @brief Returns true if the producer was created through adopt() */
+    static bool isPooled(const std::shared_ptr<Mlt::Producer> &producer);
+
+    /* @brief Returns true if no timeline clip (cut) uses the producer anymore */
+    static bool isIdle(const std::shared_ptr<Mlt::Producer> &producer);
+
+    /* @brief Marks the producer as the most recently used one
+       @param close is called to release the producer when it has to be closed
+     */
+    void touch(const std::shared_ptr<Mlt::Producer> &producer, const std::function<void()> &close);
+
+    /* @brief Closes the least recently used idle producers until at most maxIdle of them remain. The most recently used one is always kept */
+    void closeIdle(int maxIdle);
+
+    /* @brief Number of decoders currently open */
+    int openDecoders() const;
+    /* @brief Number of decoders opened since startup */
+    int createdDecoders() const;
+    /* @brief Number of idle producers closed by the pool */
+    int closedDecoders() const;
+
+protected:
+    // Constructor is protected because class is a Singleton
+    DecoderPool();
+
+    static std::unique_ptr<DecoderPool> instance;
+    static std::once_flag m_onceFlag; // flag to create the pool only once;
+
+    struct Entry
+    {
+        std::weak_ptr<Mlt::Producer> producer;
+        std::function<void()> close;
+    };
+    // Pooled producers, most recently used first
+    std::list<Entry> m_entries;
+    QMutex m_mutex;
+
+    // Shared with the deleters of the producers, that may outlive the pool on exit
+    std::shared_ptr<std::atomic<int>> m_open;
+    std::atomic<int> m_created{0};
+    std::atomic<int> m_closed{0};
+};
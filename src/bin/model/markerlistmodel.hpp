@@ -176,7 +176,7 @@ private:
 
     mutable QReadWriteLock m_lock; // This is a lock that ensures safety in case of concurrent access
 
-    std::map<GenTime, std::pair<QString, int>> m_markerList;
+    std::map<TickTime, std::pair<QString, int>> m_markerList;
     std::vector<std::weak_ptr<SnapInterface>> m_registeredSnaps;
 
 signals:
@@ -152,7 +152,7 @@ public slots:
 private:
     std::shared_ptr<TimelineItemModel> m_timeline;
     std::weak_ptr<DocUndoStack> m_undoStack;
-    std::map<GenTime, std::pair<QString, GenTime>> m_subtitleList;
+    std::map<TickTime, std::pair<QString, GenTime>> m_subtitleList;
 
     QString scriptInfoSection, styleSection,eventSection;
     QString styleName;
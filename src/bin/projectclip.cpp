@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "projectclip.h"
 #include "bin.h"
 #include "core.h"
+#include "decoderpool.hpp"
 #include "doc/docundostack.hpp"
 #include "doc/kdenlivedoc.h"
 #include "doc/kthumb.h"
@@ -45,7 +46,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "projectsubclip.h"
 #include "timecode.h"
 #include "timeline2/model/snapmodel.hpp"
+#include "titler/titlebatch.hpp"
 
+#include "utils/filehashcache.hpp"
 #include "utils/thumbnailcache.hpp"
 #include "xml/xml.hpp"
 #include <QPainter>
@@ -604,9 +607,16 @@ std::shared_ptr<Mlt::Producer> ProjectClip::thumbProducer()
         m_thumbsProducer = softClone(ClipController::getPassPropertiesList());
     } else {
         QString mltService = m_masterProducer->get("mlt_service");
-        const QString mltResource = m_masterProducer->get("resource");
+        QString mltResource = m_masterProducer->get("resource");
         if (mltService == QLatin1String("avformat")) {
             mltService = QStringLiteral("avformat-novalidate");
+        } else if (m_clipType == ClipType::Text) {
+            // Use the render of static titles if they were generated in batch
+            const QString cachedRender = TitleBatch::cachePath(getProducerProperty(QStringLiteral("xmldata")));
+            if (!cachedRender.isEmpty() && QFile::exists(cachedRender)) {
+                mltService = QStringLiteral("qimage");
+                mltResource = cachedRender;
+            }
         }
         m_thumbsProducer.reset(new Mlt::Producer(*pCore->thumbProfile(), mltService.toUtf8().constData(), mltResource.toUtf8().constData()));
         if (m_thumbsProducer->is_valid()) {
@@ -690,6 +700,9 @@ std::shared_ptr<Mlt::Producer> ProjectClip::getTimelineProducer(int trackId, int
                     m_audioProducers[trackId]->set("audio_index", audioStream);
                 }
                 m_effectStack->addService(m_audioProducers[trackId]);
+                poolProducer(m_audioProducers[trackId], true);
+            } else {
+                poolProducer(m_audioProducers[trackId], false);
             }
             return std::shared_ptr<Mlt::Producer>(m_audioProducers[trackId]->cut());
         }
@@ -710,6 +723,9 @@ std::shared_ptr<Mlt::Producer> ProjectClip::getTimelineProducer(int trackId, int
                 m_videoProducers[trackId]->set("set.test_audio", 1);
                 m_videoProducers[trackId]->set("set.test_image", 0);
                 m_effectStack->addService(m_videoProducers[trackId]);
+                poolProducer(m_videoProducers[trackId], true);
+            } else {
+                poolProducer(m_videoProducers[trackId], false);
             }
             int duration = m_masterProducer->time_to_frames(m_masterProducer->get("kdenlive:duration"));
             return std::shared_ptr<Mlt::Producer>(m_videoProducers[trackId]->cut(-1, duration > 0 ? duration - 1: -1));
@@ -856,8 +872,71 @@ std::pair<std::shared_ptr<Mlt::Producer>, bool> ProjectClip::giveMasterAndGetTim
     return {std::shared_ptr<Mlt::Producer>(ClipController::mediaUnavailable->cut()), false};
 }
 
+void ProjectClip::poolProducer(const std::shared_ptr<Mlt::Producer> &producer, bool opened)
+{
+    if (!DecoderPool::isPooled(producer)) {
+        return;
+    }
+    std::weak_ptr<ProjectClip> clip = std::static_pointer_cast<ProjectClip>(shared_from_this());
+    Mlt::Producer *prod = producer.get();
+    DecoderPool::get()->touch(producer, [clip, prod]() {
+        if (auto ptr = clip.lock()) {
+            ptr->closeTimelineProducer(prod);
+        }
+    });
+    if (opened) {
+        DecoderPool::get()->closeIdle(KdenliveSettings::maxidledecoders());
+    }
+}
+
+void ProjectClip::closeTimelineProducer(Mlt::Producer *producer)
+{
+    for (auto *producers : {&m_audioProducers, &m_videoProducers}) {
+        for (auto it = producers->begin(); it != producers->end(); ++it) {
+            if (it->second.get() == producer) {
+                m_effectStack->removeService(it->second);
+                producers->erase(it);
+                return;
+            }
+        }
+    }
+}
+
 std::shared_ptr<Mlt::Producer> ProjectClip::cloneProducer(bool removeEffects)
 {
+    const QString service = QString::fromLatin1(m_masterProducer->get("mlt_service"));
+    if (removeEffects && service.startsWith(QLatin1String("avformat"))) {
+        // Timeline producers of media files are rebuilt from the resource and properties of the master, which avoids an xml round trip
+        bool simpleStack = true;
+        for (int i = 0; i < m_masterProducer->filter_count(); ++i) {
+            std::unique_ptr<Mlt::Filter> filter(m_masterProducer->filter(i));
+            if (filter->get_int("_loader") == 0 && filter->get("kdenlive_id") == nullptr) {
+                // This filter would have to be copied
+                simpleStack = false;
+                break;
+            }
+        }
+        if (simpleStack) {
+            // Going through the loader with a service:resource string, like the xml producer does, attaches the normalizing filters
+            const QByteArray resource = QByteArrayLiteral("avformat-novalidate:") + m_masterProducer->get("resource");
+            std::shared_ptr<Mlt::Producer> prod =
+                DecoderPool::get()->adopt(new Mlt::Producer(pCore->getCurrentProfile()->profile(), nullptr, resource.constData()));
+            if (prod->is_valid()) {
+                for (int i = 0; i < m_masterProducer->count(); ++i) {
+                    const char *name = m_masterProducer->get_name(i);
+                    const char *value = m_masterProducer->get(i);
+                    // Skip internal and service properties
+                    if (name == nullptr || value == nullptr || name[0] == '_' || strcmp(name, "mlt_type") == 0 || strcmp(name, "mlt_service") == 0 ||
+                        strcmp(name, "resource") == 0 || strcmp(name, "id") == 0) {
+                        continue;
+                    }
+                    prod->set(name, value);
+                }
+                prod->set("mute_on_pause", 0);
+                return prod;
+            }
+        }
+    }
     Mlt::Consumer c(pCore->getCurrentProfile()->profile(), "xml", "string");
     Mlt::Service s(m_masterProducer->get_service());
     int ignore = s.get_int("ignore_points");
@@ -876,8 +955,8 @@ std::shared_ptr<Mlt::Producer> ProjectClip::cloneProducer(bool removeEffects)
         s.set("ignore_points", ignore);
     }
     const QByteArray clipXml = c.get("string");
-    std::shared_ptr<Mlt::Producer> prod;
-    prod.reset(new Mlt::Producer(pCore->getCurrentProfile()->profile(), "xml-string", clipXml.constData()));
+    std::shared_ptr<Mlt::Producer> prod =
+        DecoderPool::get()->adopt(new Mlt::Producer(pCore->getCurrentProfile()->profile(), "xml-string", clipXml.constData()));
 
     if (strcmp(prod->get("mlt_service"), "avformat") == 0) {
         prod->set("mlt_service", "avformat-novalidate");
@@ -1048,28 +1127,7 @@ const QString ProjectClip::getFileHash()
 
 const QPair<QByteArray, qint64> ProjectClip::calculateHash(const QString path)
 {
-    QFile file(path);
-    QByteArray fileHash;
-    qint64 fSize = 0;
-    if (file.open(QIODevice::ReadOnly)) { // write size and hash only if resource points to a file
-        /*
-        * 1 MB = 1 second per 450 files (or faster)
-        * 10 MB = 9 seconds per 450 files (or faster)
-        */
-        QByteArray fileData;
-        fSize = file.size();
-        if (fSize > 2000000) {
-            fileData = file.read(1000000);
-            if (file.seek(file.size() - 1000000)) {
-                fileData.append(file.readAll());
-            }
-        } else {
-            fileData = file.readAll();
-        }
-        file.close();
-        fileHash = QCryptographicHash::hash(fileData, QCryptographicHash::Md5);
-    }
-    return {fileHash, fSize};
+    return FileHashCache::get()->fileHash(path);
 }
 
 double ProjectClip::getOriginalFps() const
@@ -1389,6 +1447,8 @@ void ProjectClip::discardAudioThumb()
         return;
     }
     pCore->jobManager()->discardJobs(clipId(), AbstractClipJob::AUDIOTHUMBJOB);
+    pCore->jobManager()->discardJobs(clipId(), AbstractClipJob::SPECTROGRAMJOB);
+    pCore->jobManager()->discardJobs(clipId(), AbstractClipJob::LOUDNESSJOB);
     QString audioThumbPath;
     QList <int> streams = m_audioInfo->streams().keys();
     // Delete audio thumbnail data
@@ -1407,6 +1467,11 @@ void ProjectClip::discardAudioThumb()
         if (!audioThumbPath.isEmpty()) {
             QFile::remove(audioThumbPath);
         }
+        audioThumbPath = getSpectrogramPath(st);
+        if (!audioThumbPath.isEmpty()) {
+            QFile::remove(audioThumbPath);
+        }
+        resetProducerProperty(QStringLiteral("kdenlive:loudness.%1").arg(st));
     }
 
     resetProducerProperty(QStringLiteral("kdenlive:audio_max"));
@@ -1447,6 +1512,15 @@ const QString ProjectClip::getAudioThumbPath(int stream)
     return audioPath;
 }
 
+const QString ProjectClip::getSpectrogramPath(int stream)
+{
+    const QString audioPath = getAudioThumbPath(stream);
+    if (audioPath.isEmpty()) {
+        return QString();
+    }
+    return audioPath.section(QLatin1Char('_'), 0, -2) + QStringLiteral("_spectrogram.png");
+}
+
 QStringList ProjectClip::updatedAnalysisData(const QString &name, const QString &data, int offset)
 {
     if (data.isEmpty()) {
@@ -162,7 +162,7 @@ public:
 
     /** @brief The clip hash created from the clip's resource. */
     const QString hash();
-    /** @brief Callculate a file hash from a path. */
+    /** @brief Callculate a file hash from a path. The result is memoized as long as the file does not change. */
     static const QPair<QByteArray, qint64> calculateHash(const QString path);
 
     /** @brief Returns true if we are using a proxy for this clip. */
@@ -187,6 +187,8 @@ public:
     void discardAudioThumb();
     /** @brief Get path for this clip's audio thumbnail */
     const QString getAudioThumbPath(int stream);
+    /** @brief Returns the path of the cached spectrogram image of an audio stream */
+    const QString getSpectrogramPath(int stream);
     /** @brief Returns true if this producer has audio and can be splitted on timeline*/
     bool isSplittable() const;
 
@@ -298,6 +300,11 @@ private:
     // This is a helper function that creates the disabled producer. This is a clone of the original one, with audio and video disabled
     void createDisabledMasterProducer();
 
+    /** @brief Marks a track producer as used in the decoder pool. If it was just opened, the least recently used idle producers are closed. */
+    void poolProducer(const std::shared_ptr<Mlt::Producer> &producer, bool opened);
+    /** @brief Releases a track producer closed by the decoder pool */
+    void closeTimelineProducer(Mlt::Producer *producer);
+
     std::map<int, std::weak_ptr<TimelineModel>> m_registeredClips;
 
     // the following holds a producer for each audio clip in the timeline
@@ -316,6 +323,8 @@ signals:
     /** @brief Clip is ready, load properties. */
     void loadPropertiesPanel();
     void audioThumbReady();
+    /** @brief The spectrogram image was computed and cached */
+    void spectrogramReady();
     void updateStreamInfo(int ix);
 };
 
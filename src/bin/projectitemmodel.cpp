@@ -56,6 +56,7 @@ ProjectItemModel::ProjectItemModel(QObject *parent)
     , m_lock(QReadWriteLock::Recursive)
     , m_binPlaylist(new BinPlaylist())
     , m_fileWatcher(new FileWatcher())
+    , m_searchRevision(0)
     , m_nextId(1)
     , m_blankThumb()
     , m_dragType(PlaylistState::Disabled)
@@ -66,6 +67,8 @@ ProjectItemModel::ProjectItemModel(QObject *parent)
     connect(m_fileWatcher.get(), &FileWatcher::binClipModified, this, &ProjectItemModel::reloadClip);
     connect(m_fileWatcher.get(), &FileWatcher::binClipWaiting, this, &ProjectItemModel::setClipWaiting);
     connect(m_fileWatcher.get(), &FileWatcher::binClipMissing, this, &ProjectItemModel::setClipInvalid);
+    // This must be the first connection so that the index is up to date when the filter proxy reacts to the change
+    connect(this, &QAbstractItemModel::dataChanged, this, &ProjectItemModel::updateSearchIndex);
 }
 
 std::shared_ptr<ProjectItemModel> ProjectItemModel::construct(QObject *parent)
@@ -627,6 +630,7 @@ void ProjectItemModel::registerItem(const std::shared_ptr<TreeItem> &item)
     auto clip = std::static_pointer_cast<AbstractProjectItem>(item);
     m_binPlaylist->manageBinItemInsertion(clip);
     AbstractTreeModel::registerItem(item);
+    updateSearchEntry(clip);
     if (clip->itemType() == AbstractProjectItem::ClipItem) {
         auto clipItem = std::static_pointer_cast<ProjectClip>(clip);
         updateWatcher(clipItem);
@@ -639,12 +643,89 @@ void ProjectItemModel::deregisterItem(int id, TreeItem *item)
     m_binPlaylist->manageBinItemDeletion(clip);
     // TODO : here, we should suspend jobs belonging to the item we delete. They can be restarted if the item is reinserted by undo
     AbstractTreeModel::deregisterItem(id, item);
+    m_searchIndex.erase(id);
+    m_searchRevision++;
     if (clip->itemType() == AbstractProjectItem::ClipItem) {
         auto clipItem = static_cast<ProjectClip *>(clip);
         m_fileWatcher->removeFile(clipItem->clipId());
     }
 }
 
+void ProjectItemModel::updateSearchEntry(const std::shared_ptr<AbstractProjectItem> &item)
+{
+    QWriteLocker locker(&m_lock);
+    if (item->isRoot()) {
+        return;
+    }
+    SearchEntry entry;
+    // Name, date and description are the searchable columns
+    entry.text = QStringList({item->getData(AbstractProjectItem::DataName).toString(), item->getData(AbstractProjectItem::DataDate).toString(),
+                              item->getData(AbstractProjectItem::DataDescription).toString()})
+                     .join(QLatin1Char('\n'))
+                     .toCaseFolded();
+    entry.tags = item->getData(AbstractProjectItem::DataTag).toString().toCaseFolded();
+    entry.type = item->getData(AbstractProjectItem::ClipType).toInt();
+    entry.rating = item->getData(AbstractProjectItem::DataRating).toInt();
+    entry.usage = item->getData(AbstractProjectItem::UsageCount).toInt();
+    auto it = m_searchIndex.find(item->getId());
+    if (it != m_searchIndex.end() && it->second.text == entry.text && it->second.tags == entry.tags && it->second.type == entry.type &&
+        it->second.rating == entry.rating && it->second.usage == entry.usage) {
+        // Nothing searchable changed, keep the filter caches of the proxies
+        return;
+    }
+    m_searchIndex[item->getId()] = entry;
+    m_searchRevision++;
+}
+
+void ProjectItemModel::updateSearchIndex(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
+{
+    QWriteLocker locker(&m_lock);
+    if (!topLeft.isValid() || !bottomRight.isValid()) {
+        return;
+    }
+    if (!roles.isEmpty()) {
+        // Job progress and thumbnails do not change what the filters match. A loaded clip only signals its duration and status,
+        // although its name, type and tags change too
+        static const QVector<int> searchRoles = {AbstractProjectItem::DataName,   AbstractProjectItem::DataDate,     AbstractProjectItem::DataDescription,
+                                                 AbstractProjectItem::DataTag,    AbstractProjectItem::DataRating,   AbstractProjectItem::UsageCount,
+                                                 AbstractProjectItem::ClipType,   AbstractProjectItem::DataDuration, AbstractProjectItem::ClipStatus};
+        bool searchable = false;
+        for (int role : roles) {
+            if (searchRoles.contains(role)) {
+                searchable = true;
+                break;
+            }
+        }
+        if (!searchable) {
+            return;
+        }
+    }
+    const QModelIndex parentIndex = topLeft.parent();
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        QModelIndex ix = row == topLeft.row() ? topLeft : index(row, 0, parentIndex);
+        if (ix.isValid()) {
+            updateSearchEntry(getBinItemByIndex(ix));
+        }
+    }
+}
+
+bool ProjectItemModel::getSearchEntry(int itemId, SearchEntry &entry) const
+{
+    READ_LOCK();
+    auto it = m_searchIndex.find(itemId);
+    if (it == m_searchIndex.end()) {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+int ProjectItemModel::searchRevision() const
+{
+    READ_LOCK();
+    return m_searchRevision;
+}
+
 int ProjectItemModel::getFreeFolderId()
 {
     while (!isIdFree(QString::number(++m_nextId))) {
@@ -214,6 +214,21 @@ public:
     /** @brief Number of clips in the bin playlist */
     int clipsCount() const;
 
+    /** @brief Filterable data of a bin item, cached for the bin search filter.
+        Strings are stored case folded so that matching only requires a plain contains() */
+    struct SearchEntry
+    {
+        QString text;
+        QString tags;
+        int type = 0;
+        int rating = 0;
+        int usage = 0;
+    };
+    /** @brief Fetch the cached search data of an item. Returns false if the item is not indexed */
+    bool getSearchEntry(int itemId, SearchEntry &entry) const;
+    /** @brief Returns a counter that is increased each time the searchable data of an item changes */
+    int searchRevision() const;
+
 protected:
     /* @brief Register the existence of a new element
      */
@@ -230,6 +245,9 @@ protected:
     /* @brief Function to be called when the url of a clip changes */
     void updateWatcher(const std::shared_ptr<ProjectClip> &item);
 
+    /* @brief Refresh the search index entry of an item */
+    void updateSearchEntry(const std::shared_ptr<AbstractProjectItem> &item);
+
 public slots:
     /** @brief An item in the list was modified, notify */
     void onItemUpdated(const std::shared_ptr<AbstractProjectItem> &item, int role);
@@ -241,6 +259,10 @@ public slots:
     @param data is a definition of the subclips (keys are subclips' names, value are "in:out")*/
     void loadSubClips(const QString &id, const QString &clipData);
 
+private slots:
+    /** @brief Keep the search index in sync with the model data */
+    void updateSearchIndex(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
+
 private:
     /** @brief Return reference to column specific data */
     int mapToColumn(int column) const;
@@ -251,6 +273,10 @@ private:
 
     std::unique_ptr<FileWatcher> m_fileWatcher;
 
+    /** @brief Search data of all registered items, by item id */
+    std::unordered_map<int, SearchEntry> m_searchIndex;
+    int m_searchRevision;
+
     int m_nextId;
     QIcon m_blankThumb;
     PlaylistState::ClipState m_dragType;
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "projectsortproxymodel.h"
 #include "abstractprojectitem.h"
+#include "projectitemmodel.h"
 
 #include <QItemSelectionModel>
 
@@ -29,6 +30,7 @@ ProjectSortProxyModel::ProjectSortProxyModel(QObject *parent)
     , m_searchType(0)
     , m_searchRating(0)
     , m_unusedFilter(false)
+    , m_cacheRevision(-1)
 {
     m_collator.setLocale(QLocale()); // Locale used for sorting → OK
     m_collator.setCaseSensitivity(Qt::CaseInsensitive);
@@ -50,74 +52,70 @@ bool ProjectSortProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &s
 
 bool ProjectSortProxyModel::filterAcceptsRowItself(int sourceRow, const QModelIndex &sourceParent) const
 {
-    if (m_unusedFilter) {
-        // Column 8 contains the usage
-        QModelIndex indexTag = sourceModel()->index(sourceRow, 8, sourceParent);
-        if (sourceModel()->data(indexTag).toInt() > 0) {
-            return false;
-        }
+    auto *model = static_cast<ProjectItemModel *>(sourceModel());
+    QModelIndex index0 = model->index(sourceRow, 0, sourceParent);
+    if (!index0.isValid()) {
+        return false;
     }
-    if (m_searchRating > 0) {
-        // Column 7 contains the rating
-        QModelIndex indexTag = sourceModel()->index(sourceRow, 7, sourceParent);
-        if (sourceModel()->data(indexTag).toInt() != m_searchRating) {
-            return false;
-        }
+    return itemAccepted(model, (int)index0.internalId());
+}
+
+bool ProjectSortProxyModel::itemAccepted(const ProjectItemModel *model, int itemId) const
+{
+    ProjectItemModel::SearchEntry entry;
+    if (!model->getSearchEntry(itemId, entry)) {
+        return false;
     }
-    if (m_searchType > 0) {
-        // Column 3 contains the item type (video, image, title, etc)
-        QModelIndex indexTag = sourceModel()->index(sourceRow, 3, sourceParent);
-        if (sourceModel()->data(indexTag).toInt() != m_searchType) {
-            return false;
-        }
+    if (m_unusedFilter && entry.usage > 0) {
+        return false;
     }
-    if (!m_searchTag.isEmpty()) {
-        // Column 4 contains the item tag data
-        QModelIndex indexTag = sourceModel()->index(sourceRow, 4, sourceParent);
-        auto tagData = sourceModel()->data(indexTag);
-        for (const QString &tag : m_searchTag) {
-            if (!tagData.toString().contains(tag, Qt::CaseInsensitive)) {
-                return false;
-            }
-        }
+    if (m_searchRating > 0 && entry.rating != m_searchRating) {
+        return false;
     }
-
-    for (int i = 0; i < 3; i++) {
-        QModelIndex index0 = sourceModel()->index(sourceRow, i, sourceParent);
-        if (!index0.isValid()) {
+    // Item type (video, image, title, etc)
+    if (m_searchType > 0 && entry.type != m_searchType) {
+        return false;
+    }
+    for (const QString &tag : m_foldedSearchTag) {
+        if (!entry.tags.contains(tag)) {
             return false;
         }
-        auto data = sourceModel()->data(index0);
-        if (data.toString().contains(m_searchString, Qt::CaseInsensitive)) {
-            return true;
-        }
     }
-    return false;
+    return entry.text.contains(m_foldedSearchString);
+}
+
+void ProjectSortProxyModel::checkCacheRevision(const ProjectItemModel *model) const
+{
+    int revision = model->searchRevision();
+    if (revision != m_cacheRevision) {
+        m_acceptedChildren.clear();
+        m_cacheRevision = revision;
+    }
 }
 
 bool ProjectSortProxyModel::hasAcceptedChildren(int sourceRow, const QModelIndex &source_parent) const
 {
-    QModelIndex item = sourceModel()->index(sourceRow, 0, source_parent);
+    auto *model = static_cast<ProjectItemModel *>(sourceModel());
+    QModelIndex item = model->index(sourceRow, 0, source_parent);
     if (!item.isValid()) {
         return false;
     }
-
-    // check if there are children
-    int childCount = item.model()->rowCount(item);
-    if (childCount == 0) {
-        return false;
+    int itemId = (int)item.internalId();
+    checkCacheRevision(model);
+    auto cached = m_acceptedChildren.find(itemId);
+    if (cached != m_acceptedChildren.end()) {
+        return cached->second;
     }
-
-    for (int i = 0; i < childCount; ++i) {
-        if (filterAcceptsRowItself(i, item)) {
-            return true;
-        }
-        // recursive call -> NOTICE that this is depth-first searching, you're probably better off with breadth first search...
-        if (hasAcceptedChildren(i, item)) {
-            return true;
-        }
+    std::shared_ptr<TreeItem> treeItem = model->getItemById(itemId);
+    bool accepted = false;
+    if (treeItem->childCount() > 0) {
+        // Walk the subtree once, the result is then reused for all rows until the index or filters change
+        accepted = treeItem->accumulate_const(false, [this, model, itemId](bool found, const std::shared_ptr<const TreeItem> &it) {
+            return found || (it->getId() != itemId && itemAccepted(model, it->getId()));
+        });
     }
-    return false;
+    m_acceptedChildren[itemId] = accepted;
+    return accepted;
 }
 
 bool ProjectSortProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
@@ -151,6 +149,8 @@ QItemSelectionModel *ProjectSortProxyModel::selectionModel()
 void ProjectSortProxyModel::slotSetSearchString(const QString &str)
 {
     m_searchString = str;
+    m_foldedSearchString = str.toCaseFolded();
+    m_acceptedChildren.clear();
     invalidateFilter();
 }
 
@@ -159,16 +159,23 @@ void ProjectSortProxyModel::slotSetFilters(const QStringList tagFilters, const i
     m_searchType = typeFilters;
     m_searchRating = rateFilters;
     m_searchTag = tagFilters;
+    m_foldedSearchTag.clear();
+    for (const QString &tag : tagFilters) {
+        m_foldedSearchTag << tag.toCaseFolded();
+    }
     m_unusedFilter = unusedFilter;
+    m_acceptedChildren.clear();
     invalidateFilter();
 }
 
 void ProjectSortProxyModel::slotClearSearchFilters()
 {
     m_searchTag.clear();
+    m_foldedSearchTag.clear();
     m_searchRating = 0;
     m_searchType = 0;
     m_unusedFilter = false;
+    m_acceptedChildren.clear();
     invalidateFilter();
 }
 
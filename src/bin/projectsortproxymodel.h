@@ -24,8 +24,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QCollator>
 #include <QSortFilterProxyModel>
+#include <unordered_map>
 
 class QItemSelectionModel;
+class ProjectItemModel;
 
 /**
  * @class ProjectSortProxyModel
@@ -64,11 +66,21 @@ protected:
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
     bool filterAcceptsRowItself(int source_row, const QModelIndex &source_parent) const;
     bool hasAcceptedChildren(int source_row, const QModelIndex &source_parent) const;
+    /** @brief Returns true if the indexed data of an item matches the current filters */
+    bool itemAccepted(const ProjectItemModel *model, int itemId) const;
+    /** @brief Drop the cached folder results if the filters or the model changed */
+    void checkCacheRevision(const ProjectItemModel *model) const;
 
 private:
     QItemSelectionModel *m_selection;
     QString m_searchString;
     QStringList m_searchTag;
+    /** @brief Case folded copies of the search string and tags, matched against the model's search index */
+    QString m_foldedSearchString;
+    QStringList m_foldedSearchTag;
+    /** @brief Per folder cache of the subtree acceptance, valid for m_cacheRevision of the model search index */
+    mutable std::unordered_map<int, bool> m_acceptedChildren;
+    mutable int m_cacheRevision;
     int m_searchType;
     int m_searchRating;
     bool m_unusedFilter;
@@ -766,6 +766,28 @@ void Core::invalidateItem(ObjectId itemId)
     }
 }
 
+void Core::invalidateMonitorFrames(const ObjectId &itemId)
+{
+    if (!m_guiConstructed || !m_mainWindow->getCurrentTimeline() || m_mainWindow->getCurrentTimeline()->loading) return;
+    auto model = m_mainWindow->getCurrentTimeline()->controller()->getModel();
+    switch (itemId.first) {
+    case ObjectType::TimelineClip:
+    case ObjectType::TimelineComposition:
+        if (model->isItem(itemId.second) && model->getItemTrackId(itemId.second) > -1) {
+            int start = model->getItemPosition(itemId.second);
+            m_monitorManager->projectMonitor()->invalidateFrameCache(start, start + model->getItemPlaytime(itemId.second));
+        }
+        break;
+    case ObjectType::TimelineTrack:
+    case ObjectType::BinClip:
+    case ObjectType::Master:
+        m_monitorManager->projectMonitor()->invalidateFrameCache(0, -1);
+        break;
+    default:
+        break;
+    }
+}
+
 double Core::getClipSpeed(int id) const
 {
     return m_mainWindow->getCurrentTimeline()->controller()->getModel()->getClipSpeed(id);
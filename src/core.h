@@ -186,6 +186,8 @@ public:
     double getClipSpeed(int id) const;
     /** @brief Mark an item as invalid for timeline preview */
     void invalidateItem(ObjectId itemId);
+    /** @brief Drop the project monitor frames cached for scrubbing where an item is, without waiting for the timeline preview invalidation */
+    void invalidateMonitorFrames(const ObjectId &itemId);
     void invalidateRange(QPair<int, int>range);
     void prepareShutdown();
     /** the keyframe model changed (effect added, deleted, active effect changed), inform timeline */
@@ -33,6 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "kdenlivesettings.h"
 #include "project/dialogs/slideshowclip.h"
 #include "timecodedisplay.h"
+#include "titler/titlebatch.hpp"
 #include "titler/titlewidget.h"
 #include "titletemplatedialog.h"
 #include "ui_colorclip_ui.h"
@@ -48,12 +49,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QDialog>
 #include <QDir>
+#include <QEventLoop>
+#include <QFileDialog>
+#include <QFutureWatcher>
 #include <QMimeDatabase>
 #include <QPointer>
+#include <QProgressDialog>
 #include <QPushButton>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QUndoCommand>
 #include <QWindow>
+#include <QtConcurrent>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 // static
@@ -293,6 +301,81 @@ void ClipCreationDialog::createTitleTemplateClip(KdenliveDoc *doc, const QString
     }
 }
 
+void ClipCreationDialog::createTitleBatchClips(KdenliveDoc *doc, const QString &parentFolder, std::shared_ptr<ProjectItemModel> model)
+{
+    const QString templatePath = QFileDialog::getOpenFileName(QApplication::activeWindow(), i18n("Select Title Template"),
+                                                              doc->projectDataFolder() + QStringLiteral("/titles"), i18n("Titles (*.kdenlivetitle)"));
+    if (templatePath.isEmpty()) {
+        return;
+    }
+    const QString dataPath = QFileDialog::getOpenFileName(QApplication::activeWindow(), i18n("Select Title Data"), QFileInfo(templatePath).absolutePath(),
+                                                          i18n("Data files (*.csv *.json *.txt)"));
+    if (dataPath.isEmpty()) {
+        return;
+    }
+    QDomDocument titledoc;
+    QFile txtfile(templatePath);
+    if (!txtfile.open(QIODevice::ReadOnly) || !titledoc.setContent(&txtfile)) {
+        KMessageBox::sorry(QApplication::activeWindow(), i18n("Cannot read title template %1", templatePath));
+        return;
+    }
+    txtfile.close();
+    int duration = titledoc.documentElement().attribute(QStringLiteral("duration")).toInt();
+    if (duration == 0) {
+        duration = pCore->getDurationFromString(KdenliveSettings::title_duration());
+    }
+    TitleBatch::Data data;
+    QString error;
+    if (!TitleBatch::readData(dataPath, data, error)) {
+        KMessageBox::sorry(QApplication::activeWindow(), error);
+        return;
+    }
+
+    // Fill the titles and render the static ones to the cache on the thread pool
+    bool ok = false;
+    const QDir cacheDir = doc->getCacheDir(CacheThumbs, &ok);
+    const QSize frameSize = pCore->getCurrentFrameSize();
+    const QString templateXml = titledoc.toString();
+    std::function<QString(int)> generate = [&data, &templateXml, &cacheDir, ok, frameSize](int row) {
+        const QString xml = TitleBatch::applyRow(templateXml, data.columns, data.rows.at(row));
+        if (ok && TitleBatch::isStatic(xml)) {
+            // Identical titles share their render
+            const QString path = TitleBatch::cachePath(cacheDir, xml, frameSize);
+            if (!QFile::exists(path)) {
+                QImage image = TitleBatch::render(xml, frameSize);
+                // Rows with identical content render to the same path, each writes a temporary file renamed at once
+                QSaveFile file(path);
+                if (!image.isNull() && file.open(QIODevice::WriteOnly) && image.save(&file, "PNG")) {
+                    file.commit();
+                }
+            }
+        }
+        return xml;
+    };
+    QVector<int> rows(data.rows.count());
+    std::iota(rows.begin(), rows.end(), 0);
+    QProgressDialog progress(i18n("Generating titles..."), QString(), 0, rows.count(), QApplication::activeWindow());
+    progress.setWindowModality(Qt::WindowModal);
+    progress.show();
+    QFutureWatcher<QString> watcher;
+    QEventLoop loop;
+    QObject::connect(&watcher, &QFutureWatcher<QString>::progressValueChanged, &progress, &QProgressDialog::setValue);
+    QObject::connect(&watcher, &QFutureWatcher<QString>::finished, &loop, &QEventLoop::quit);
+    watcher.setFuture(QtConcurrent::mapped(rows, generate));
+    if (!watcher.isFinished()) {
+        loop.exec();
+    }
+    progress.close();
+
+    QStringList titles = watcher.future().results();
+    QStringList names;
+    for (int i = 0; i < data.rows.count(); ++i) {
+        const QString name = data.rows.at(i).value(0).simplified();
+        names << (name.isEmpty() ? i18n("Title clip %1", i + 1) : name);
+    }
+    ClipCreator::createTitleClips(titles, names, duration, parentFolder, std::move(model));
+}
+
 // void ClipCreationDialog::createClipsCommand(KdenliveDoc *doc, const QList<QUrl> &urls, const QStringList &groupInfo, Bin *bin,
 //                                             const QMap<QString, QString> &data)
 // {
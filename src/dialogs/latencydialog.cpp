@@ -0,0 +1,103 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "latencydialog.h"
+#include "utils/latencystats.hpp"
+
+#include <klocalizedstring.h>
+#include <QApplication>
+#include <QClipboard>
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QLocale>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace {
+QString formatDuration(qint64 usecs)
+{
+    if (usecs < 1000) {
+        return i18nc("Duration in microseconds", "%1 µs", usecs);
+    }
+    return i18nc("Duration in milliseconds", "%1 ms", QLocale().toString(usecs / 1000., 'f', 1));
+}
+} // namespace
+
+LatencyDialog::LatencyDialog(QWidget *parent)
+    : QDialog(parent)
+    , m_list(new QTreeWidget(this))
+{
+    setWindowTitle(i18n("Operation Latency"));
+    auto *lay = new QVBoxLayout;
+    m_list->setRootIsDecorated(false);
+    m_list->setSortingEnabled(true);
+    m_list->setAlternatingRowColors(true);
+    m_list->setHeaderLabels({i18n("Operation"), i18n("Count"), i18n("Average"), i18n("Median"), i18n("95%"), i18n("99%"), i18n("Maximum")});
+    m_list->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_list->sortByColumn(0, Qt::AscendingOrder);
+    lay->addWidget(m_list);
+
+    auto *buttonBox = new QDialogButtonBox(QDialogButtonBox::Reset | QDialogButtonBox::Close);
+    QPushButton *copy = buttonBox->addButton(i18n("Copy as JSON"), QDialogButtonBox::ActionRole);
+    connect(copy, &QPushButton::clicked, this, &LatencyDialog::slotCopy);
+    connect(buttonBox->button(QDialogButtonBox::Reset), &QPushButton::clicked, this, [this]() {
+        LatencyStats::get()->reset();
+        slotRefresh();
+    });
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    lay->addWidget(buttonBox);
+    setLayout(lay);
+    resize(700, 400);
+
+    m_refreshTimer.setInterval(1000);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &LatencyDialog::slotRefresh);
+    m_refreshTimer.start();
+    slotRefresh();
+}
+
+void LatencyDialog::slotRefresh()
+{
+    const QVector<LatencyStats::Summary> summaries = LatencyStats::get()->summaries();
+    m_list->setUpdatesEnabled(false);
+    m_list->setSortingEnabled(false);
+    m_list->clear();
+    for (const LatencyStats::Summary &summary : summaries) {
+        auto *item = new QTreeWidgetItem(m_list);
+        item->setText(0, summary.operation);
+        item->setData(1, Qt::DisplayRole, summary.count);
+        item->setText(2, formatDuration(summary.count > 0 ? summary.totalUs / summary.count : 0));
+        item->setText(3, formatDuration(summary.p50Us));
+        item->setText(4, formatDuration(summary.p95Us));
+        item->setText(5, formatDuration(summary.p99Us));
+        item->setText(6, formatDuration(summary.maxUs));
+        for (int i = 2; i < 7; ++i) {
+            item->setTextAlignment(i, Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+    m_list->setSortingEnabled(true);
+    m_list->setUpdatesEnabled(true);
+}
+
+void LatencyDialog::slotCopy()
+{
+    QApplication::clipboard()->setText(LatencyStats::get()->toJson());
+}
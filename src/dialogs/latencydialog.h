@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QDialog>
+#include <QTimer>
+
+class QTreeWidget;
+
+/**
+ * @class LatencyDialog
+ * @brief A dialog displaying the duration statistics of the operations measured by LatencyStats.
+ */
+
+class LatencyDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LatencyDialog(QWidget *parent = nullptr);
+
+private slots:
+    /** @brief Reload the statistics. */
+    void slotRefresh();
+    /** @brief Copy the statistics as JSON to the clipboard. */
+    void slotCopy();
+
+private:
+    QTreeWidget *m_list;
+    QTimer m_refreshTimer;
+};
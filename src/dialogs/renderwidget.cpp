@@ -366,7 +366,10 @@ RenderWidget::RenderWidget(bool enableProxy, QWidget *parent)
     if (KdenliveSettings::gpu_accel()) {
         // Disable parallel rendering for movit
         m_view.parallel_process->setEnabled(false);
+        m_view.render_segments->setEnabled(false);
     }
+    m_view.render_segments->setValue(KdenliveSettings::rendersegments());
+    connect(m_view.render_segments, QOverload<int>::of(&QSpinBox::valueChanged), [](int value) { KdenliveSettings::setRendersegments(value); });
     m_view.field_order->setEnabled(false);
     connect(m_view.scanning_list, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) { m_view.field_order->setEnabled(index == 2); });
     refreshView();
@@ -1613,6 +1616,13 @@ void RenderWidget::generateRenderFiles(QDomDocument doc, const QString &playlist
         file.close();
     }
 
+    // Split long renders in segments encoded in parallel, joined with FFmpeg
+    QStringList segmentArgs;
+    if (m_view.render_segments->isEnabled() && m_view.render_segments->value() > 1 && !KdenliveSettings::ffmpegpath().isEmpty() &&
+        !QRegExp(QStringLiteral(".*%[0-9]*d.*")).exactMatch(renderedFile)) {
+        segmentArgs << QStringLiteral("-segments:%1").arg(m_view.render_segments->value()) << QStringLiteral("-ffmpeg:%1").arg(KdenliveSettings::ffmpegpath());
+    }
+
     // Create job
     RenderJobItem *renderItem = nullptr;
     QList<QTreeWidgetItem *> existing = m_view.running_jobs->findItems(renderedFile, Qt::MatchExactly, 1);
@@ -1634,6 +1644,7 @@ void RenderWidget::generateRenderFiles(QDomDocument doc, const QString &playlist
             renderItem->setData(1, Qt::UserRole, i18n("Waiting..."));
             QStringList argsJob = {KdenliveSettings::rendererpath(), playlistPath, renderedFile,
                                    QStringLiteral("-pid:%1").arg(QCoreApplication::applicationPid())};
+            argsJob << segmentArgs;
             renderItem->setData(1, ParametersRole, argsJob);
             QDateTime t = QDateTime::currentDateTime();
             renderItem->setData(1, StartTimeRole, t);
@@ -1662,6 +1673,7 @@ void RenderWidget::generateRenderFiles(QDomDocument doc, const QString &playlist
         renderItem->setData(1, LastTimeRole, t);
         renderItem->setData(1, LastFrameRole, in);
         QStringList argsJob = {KdenliveSettings::rendererpath(), pl, renderedFile, QStringLiteral("-pid:%1").arg(QCoreApplication::applicationPid())};
+        argsJob << segmentArgs;
         renderItem->setData(1, ParametersRole, argsJob);
         qDebug() << "* CREATED JOB WITH ARGS: " << argsJob;
         if (!exportAudio) {
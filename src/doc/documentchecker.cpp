@@ -23,6 +23,7 @@
 #include "kdenlivesettings.h"
 #include "kthumb.h"
 #include "titler/titlewidget.h"
+#include "utils/filehashcache.hpp"
 #include "bin/projectclip.h"
 
 #include <KMessageBox>
@@ -152,6 +153,21 @@ bool DocumentChecker::hasErrorInClips()
     QStringList serviceToCheck;
     serviceToCheck << QStringLiteral("kdenlivetitle") << QStringLiteral("qimage") << QStringLiteral("pixbuf") << QStringLiteral("timewarp")
                    << QStringLiteral("framebuffer") << QStringLiteral("xml") << QStringLiteral("qtext");
+    // Hash the media files in the background, so that clip loading only reads the results
+    QStringList hashedPaths;
+    for (int i = 0; i < max; ++i) {
+        QDomElement e = documentProducers.item(i).toElement();
+        if (!Xml::getXmlProperty(e, QStringLiteral("mlt_service")).startsWith(QLatin1String("avformat"))) {
+            continue;
+        }
+        QString resource = Xml::getXmlProperty(e, QStringLiteral("kdenlive:proxy")).length() > 1 ? Xml::getXmlProperty(e, QStringLiteral("kdenlive:originalurl"))
+                                                                                               : Xml::getXmlProperty(e, QStringLiteral("resource"));
+        if (QFileInfo(resource).isRelative()) {
+            resource.prepend(root);
+        }
+        hashedPaths << resource;
+    }
+    FileHashCache::get()->prefetch(hashedPaths);
     for (int i = 0; i < max; ++i) {
         QDomElement e = documentProducers.item(i).toElement();
         QString service = Xml::getXmlProperty(e, QStringLiteral("mlt_service"));
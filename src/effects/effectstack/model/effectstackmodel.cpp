@@ -29,6 +29,7 @@
 #include "macros.hpp"
 #include "timeline2/model/timelinemodel.hpp"
 #include <profiles/profilemodel.hpp>
+#include <QSet>
 #include <stack>
 #include <utility>
 #include <vector>
@@ -40,6 +41,7 @@ EffectStackModel::EffectStackModel(std::weak_ptr<Mlt::Service> service, ObjectId
     , m_undoStack(std::move(undo_stack))
     , m_lock(QReadWriteLock::Recursive)
     , m_loadingExisting(false)
+    , m_batchInsertion(false)
 {
     m_masterService = std::move(service);
 }
@@ -409,6 +411,234 @@ bool EffectStackModel::fromXml(const QDomElement &effectsXml, Fun &undo, Fun &re
     return effectAdded;
 }
 
+EffectStackModel::EffectDescription EffectStackModel::describeEffect(const QString &effectId)
+{
+    EffectDescription description;
+    description.effectId = effectId;
+    AssetListType::AssetType type = EffectsRepository::get()->getType(effectId);
+    description.isAudio = type == AssetListType::AssetType::Audio || type == AssetListType::AssetType::CustomAudio;
+    description.isUnique = EffectsRepository::get()->isUnique(effectId);
+    description.enabled = true;
+    description.parentIn = 0;
+    return description;
+}
+
+std::vector<EffectStackModel::EffectDescription> EffectStackModel::parseEffects(const QDomElement &effectsXml)
+{
+    std::vector<EffectDescription> result;
+    QDomNodeList nodeList = effectsXml.elementsByTagName(QStringLiteral("effect"));
+    int parentIn = effectsXml.attribute(QStringLiteral("parentIn")).toInt();
+    for (int i = 0; i < nodeList.count(); ++i) {
+        QDomElement node = nodeList.item(i).toElement();
+        EffectDescription description = describeEffect(node.attribute(QStringLiteral("id")));
+        if (Xml::hasXmlProperty(node, QLatin1String("disable"))) {
+            description.enabled = Xml::getXmlProperty(node, QLatin1String("disable")).toInt() != 1;
+        }
+        description.in = node.attribute(QStringLiteral("in"));
+        description.out = node.attribute(QStringLiteral("out"));
+        // Effects merged from several clips keep the in point of their own clip
+        description.parentIn = node.hasAttribute(QStringLiteral("parentIn")) ? node.attribute(QStringLiteral("parentIn")).toInt() : parentIn;
+        QDomNodeList params = node.elementsByTagName(QStringLiteral("property"));
+        for (int j = 0; j < params.count(); j++) {
+            QDomElement pnode = params.item(j).toElement();
+            const QString pName = pnode.attribute(QStringLiteral("name"));
+            if (pName == QLatin1String("in") || pName == QLatin1String("out")) {
+                continue;
+            }
+            description.parameters.append(QPair<QString, QVariant>(pName, QVariant(pnode.text())));
+        }
+        result.push_back(description);
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<EffectItemModel>> EffectStackModel::createEffects(const std::vector<EffectDescription> &effects)
+{
+    QWriteLocker locker(&m_lock);
+    std::vector<std::shared_ptr<EffectItemModel>> result;
+    int currentIn = pCore->getItemIn(m_ownerId);
+    PlaylistState::ClipState state = pCore->getItemState(m_ownerId);
+    QSet<QString> uniqueEffects;
+    for (const EffectDescription &description : effects) {
+        if ((description.isAudio && state == PlaylistState::VideoOnly) || (!description.isAudio && state == PlaylistState::AudioOnly)) {
+            continue;
+        }
+        if (description.isUnique) {
+            if (hasEffect(description.effectId) || uniqueEffects.contains(description.effectId)) {
+                // The stack is left untouched
+                pCore->displayMessage(i18n("Effect %1 cannot be added twice.", EffectsRepository::get()->getName(description.effectId)), InformationMessage);
+                return {};
+            }
+            uniqueEffects.insert(description.effectId);
+        }
+        auto effect = EffectItemModel::construct(description.effectId, shared_from_this(), description.enabled);
+        if (!description.out.isEmpty()) {
+            effect->filter().set("in", description.in.toUtf8().constData());
+            effect->filter().set("out", description.out.toUtf8().constData());
+        }
+        if (!description.parameters.isEmpty()) {
+            QVector<QPair<QString, QVariant>> parameters = description.parameters;
+            int offset = currentIn - description.parentIn;
+            if (offset != 0) {
+                QStringList keyframeParams = effect->getKeyframableParameters();
+                for (auto &param : parameters) {
+                    if (keyframeParams.contains(param.first)) {
+                        param.second = KeyframeModel::getAnimationStringWithOffset(effect, param.second.toString(), offset);
+                    }
+                }
+            }
+            // The stack is refreshed once all effects are planted
+            effect->setParameters(parameters, false);
+        }
+        effect->prepareKeyframes();
+        connect(effect.get(), &AssetParameterModel::modelChanged, this, &EffectStackModel::modelChanged);
+        connect(effect.get(), &AssetParameterModel::replugEffect, this, &EffectStackModel::replugEffect, Qt::DirectConnection);
+        const QString &effectId = description.effectId;
+        if (effectId == QLatin1String("fadein") || effectId == QLatin1String("fade_from_black")) {
+            int duration = effect->filter().get_length() - 1;
+            effect->filter().set("in", currentIn);
+            effect->filter().set("out", currentIn + duration);
+        } else if ((effectId == QLatin1String("fadeout") || effectId == QLatin1String("fade_to_black")) && !description.out.isEmpty()) {
+            int duration = effect->filter().get_length() - 1;
+            int filterOut = currentIn + pCore->getItemDuration(m_ownerId) - 1;
+            effect->filter().set("in", filterOut - duration);
+            effect->filter().set("out", filterOut);
+        }
+        result.push_back(effect);
+    }
+    return result;
+}
+
+bool EffectStackModel::plantEffects(const std::vector<std::shared_ptr<EffectItemModel>> &effects, bool makeCurrent)
+{
+    QWriteLocker locker(&m_lock);
+    bool result = true;
+    if (makeCurrent) {
+        if (auto srvPtr = m_masterService.lock()) {
+            srvPtr->set("kdenlive:activeeffect", rowCount());
+        }
+    }
+    m_batchInsertion = true;
+    for (const auto &effect : effects) {
+        // TODO the parent should probably not always be the root
+        result = addItem_lambda(effect, rootItem->getId())() && result;
+    }
+    m_batchInsertion = false;
+    refreshAfterBatch(effects);
+    return result;
+}
+
+bool EffectStackModel::unplantEffects(const std::vector<std::shared_ptr<EffectItemModel>> &effects)
+{
+    QWriteLocker locker(&m_lock);
+    bool result = true;
+    m_batchInsertion = true;
+    for (auto it = effects.rbegin(); it != effects.rend(); ++it) {
+        int id = (*it)->getId();
+        result = removeItem_lambda(id)() && result;
+        m_fadeIns.erase(id);
+        m_fadeOuts.erase(id);
+    }
+    m_batchInsertion = false;
+    refreshAfterBatch(effects);
+    return result;
+}
+
+void EffectStackModel::refreshAfterBatch(const std::vector<std::shared_ptr<EffectItemModel>> &effects)
+{
+    QVector<int> roles = {TimelineModel::EffectNamesRole};
+    for (const auto &effect : effects) {
+        const QString &effectId = effect->getAssetId();
+        if ((effectId == QLatin1String("fadein") || effectId == QLatin1String("fade_from_black")) && !roles.contains(TimelineModel::FadeInRole)) {
+            roles << TimelineModel::FadeInRole;
+        } else if ((effectId == QLatin1String("fadeout") || effectId == QLatin1String("fade_to_black")) && !roles.contains(TimelineModel::FadeOutRole)) {
+            roles << TimelineModel::FadeOutRole;
+        }
+    }
+    emit dataChanged(QModelIndex(), QModelIndex(), roles);
+}
+
+void EffectStackModel::refreshOwners(const std::vector<std::shared_ptr<EffectStackModel>> &stacks, bool hasVideo)
+{
+    // The timeline clips are refreshed as a single range, other owners one by one
+    int start = -1;
+    int end = -1;
+    for (const auto &stack : stacks) {
+        const ObjectId &owner = stack->m_ownerId;
+        pCore->updateItemKeyframes(owner);
+        if (!hasVideo) {
+            continue;
+        }
+        if (owner.first == ObjectType::TimelineClip) {
+            int position = pCore->getItemPosition(owner);
+            if (position > -1) {
+                start = start < 0 ? position : qMin(start, position);
+                end = qMax(end, position + pCore->getItemDuration(owner));
+            }
+        } else {
+            pCore->refreshProjectItem(owner);
+            pCore->invalidateItem(owner);
+        }
+    }
+    if (start > -1 && end > start) {
+        pCore->invalidateRange({start, end});
+        pCore->refreshProjectRange({start, end});
+    }
+}
+
+int EffectStackModel::appendEffects(const std::vector<std::shared_ptr<EffectStackModel>> &stacks, const std::vector<EffectDescription> &effects, Fun &undo,
+                                    Fun &redo, bool makeCurrent)
+{
+    // A flat list of operations instead of a chain of nested lambdas, so that undoing a large selection stays cheap
+    auto operations = std::make_shared<std::vector<std::pair<Fun, Fun>>>();
+    // The owners of the stacks that received effects, refreshed together once all stacks are done
+    auto owners = std::make_shared<std::vector<std::shared_ptr<EffectStackModel>>>();
+    bool hasVideo = false;
+    for (const auto &stack : stacks) {
+        std::vector<std::shared_ptr<EffectItemModel>> items = stack->createEffects(effects);
+        if (items.empty()) {
+            continue;
+        }
+        for (const auto &item : items) {
+            hasVideo = hasVideo || !item->isAudio();
+        }
+        Fun plant = [stack, items, makeCurrent]() { return stack->plantEffects(items, makeCurrent); };
+        Fun unplant = [stack, items]() { return stack->unplantEffects(items); };
+        if (!plant()) {
+            unplant();
+            for (auto it = operations->rbegin(); it != operations->rend(); ++it) {
+                it->second();
+            }
+            refreshOwners(*owners, hasVideo);
+            return 0;
+        }
+        operations->push_back({plant, unplant});
+        owners->push_back(stack);
+    }
+    if (operations->empty()) {
+        return 0;
+    }
+    refreshOwners(*owners, hasVideo);
+    Fun local_redo = [operations, owners, hasVideo]() {
+        bool result = true;
+        for (const auto &operation : *operations) {
+            result = operation.first() && result;
+        }
+        refreshOwners(*owners, hasVideo);
+        return result;
+    };
+    Fun local_undo = [operations, owners, hasVideo]() {
+        bool result = true;
+        for (auto it = operations->rbegin(); it != operations->rend(); ++it) {
+            result = it->second() && result;
+        }
+        refreshOwners(*owners, hasVideo);
+        return result;
+    };
+    UPDATE_UNDO_REDO_NOLOCK(local_redo, local_undo, undo, redo);
+    return int(operations->size());
+}
+
 bool EffectStackModel::copyEffect(const std::shared_ptr<AbstractEffectItem> &sourceItem, PlaylistState::ClipState state)
 {
     QWriteLocker locker(&m_lock);
@@ -564,6 +794,62 @@ bool EffectStackModel::appendEffect(const QString &effectId, bool makeCurrent)
     return res;
 }
 
+bool EffectStackModel::setNormalizationGain(double gain, Fun &undo, Fun &redo)
+{
+    QWriteLocker locker(&m_lock);
+    const QString level = QString::number(gain, 'f', 2);
+    for (const auto &leaf : rootItem->getLeaves()) {
+        std::shared_ptr<AbstractEffectItem> item = std::static_pointer_cast<AbstractEffectItem>(leaf);
+        if (item->effectItemType() == EffectItemType::Group) {
+            continue;
+        }
+        std::shared_ptr<EffectItemModel> effect = std::static_pointer_cast<EffectItemModel>(leaf);
+        if (effect->filter().get_int("kdenlive:normalization") != 1) {
+            continue;
+        }
+        // The stack is already normalized, only adjust the gain
+        const QString previousLevel = effect->filter().get("level");
+        if (previousLevel == level) {
+            return true;
+        }
+        Fun operation = [effect, level]() {
+            effect->setParameter(QStringLiteral("level"), level);
+            return true;
+        };
+        Fun reverse = [effect, previousLevel]() {
+            effect->setParameter(QStringLiteral("level"), previousLevel);
+            return true;
+        };
+        operation();
+        UPDATE_UNDO_REDO(operation, reverse, undo, redo);
+        return true;
+    }
+    if (pCore->getItemState(m_ownerId) == PlaylistState::VideoOnly) {
+        // Cannot add an audio effect to this item
+        return false;
+    }
+    auto effect = EffectItemModel::construct(QStringLiteral("volume"), shared_from_this());
+    effect->filter().set("kdenlive:normalization", 1);
+    effect->setParameter(QStringLiteral("level"), level, false);
+    Fun local_undo = removeItem_lambda(effect->getId());
+    Fun local_redo = addItem_lambda(effect, rootItem->getId());
+    effect->prepareKeyframes();
+    connect(effect.get(), &AssetParameterModel::modelChanged, this, &EffectStackModel::modelChanged);
+    connect(effect.get(), &AssetParameterModel::replugEffect, this, &EffectStackModel::replugEffect, Qt::DirectConnection);
+    if (!local_redo()) {
+        return false;
+    }
+    Fun update = [this]() {
+        emit dataChanged(QModelIndex(), QModelIndex(), {TimelineModel::EffectNamesRole});
+        return true;
+    };
+    update();
+    PUSH_LAMBDA(update, local_redo);
+    PUSH_LAMBDA(update, local_undo);
+    UPDATE_UNDO_REDO(local_redo, local_undo, undo, redo);
+    return true;
+}
+
 bool EffectStackModel::adjustStackLength(bool adjustFromEnd, int oldIn, int oldDuration, int newIn, int duration, int offset, Fun &undo, Fun &redo,
                                          bool logUndo)
 {
@@ -877,7 +1163,7 @@ void EffectStackModel::registerItem(const std::shared_ptr<TreeItem> &item)
             m_fadeOuts.insert(effectItem->getId());
         }
         ix = getIndexFromItem(effectItem);
-        if (!effectItem->isAudio() && !m_loadingExisting) {
+        if (!effectItem->isAudio() && !m_loadingExisting && !m_batchInsertion) {
             pCore->refreshProjectItem(m_ownerId);
             pCore->invalidateItem(m_ownerId);
         }
@@ -894,7 +1180,7 @@ void EffectStackModel::deregisterItem(int id, TreeItem *item)
         for (const auto &service : m_childServices) {
             effectItem->unplantClone(service);
         }
-        if (!effectItem->isAudio()) {
+        if (!effectItem->isAudio() && !m_batchInsertion) {
             pCore->refreshProjectItem(m_ownerId);
             pCore->invalidateItem(m_ownerId);
         }
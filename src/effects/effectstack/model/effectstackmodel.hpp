@@ -30,6 +30,7 @@
 #include <memory>
 #include <mlt++/Mlt.h>
 #include <unordered_set>
+#include <vector>
 
 /* @brief This class an effect stack as viewed by the back-end.
    It is responsible for planting and managing effects into the list of producer it holds a pointer to.
@@ -87,6 +88,10 @@ public:
     int getActiveEffect() const;
     /* @brief Adjust an effect duration (useful for fades) */
     bool adjustFadeLength(int duration, bool fromStart, bool audioFade, bool videoFade, bool logUndo);
+    /* @brief Set the gain of the loudness normalization effect of the stack, a volume effect added at the bottom of the stack if needed
+       @param gain is the gain in dB
+    */
+    bool setNormalizationGain(double gain, Fun &undo, Fun &redo);
     bool adjustStackLength(bool adjustFromEnd, int oldIn, int oldDuration, int newIn, int duration, int offset, Fun &undo, Fun &redo, bool logUndo);
 
     void slotCreateGroup(const std::shared_ptr<EffectItemModel> &childEffect);
@@ -136,6 +141,31 @@ public:
     QDomElement rowToXml(int row, QDomDocument &document);
     /* @brief Load an effect stack from an XML representation */
     bool fromXml(const QDomElement &effectsXml, Fun &undo, Fun &redo);
+
+    /* @brief An effect read once from its xml description, that can then be appended to many stacks */
+    struct EffectDescription
+    {
+        QString effectId;
+        bool isAudio;
+        bool isUnique;
+        bool enabled;
+        QString in;
+        QString out;
+        /* @brief In point of the item the effect was copied from, used to shift keyframes */
+        int parentIn;
+        QVector<QPair<QString, QVariant>> parameters;
+    };
+    /* @brief Returns the description of an effect with its default parameters */
+    static EffectDescription describeEffect(const QString &effectId);
+    /* @brief Parse the effects of an XML representation of a stack, as produced by toXml */
+    static std::vector<EffectDescription> parseEffects(const QDomElement &effectsXml);
+    /* @brief Append the same effects at the bottom of several stacks in one operation
+       Each stack is refreshed once and the whole operation is recorded as a single undo/redo pair
+       @param makeCurrent if true, the first added effect becomes the active one of each stack
+       @return the number of stacks that received at least one effect
+    */
+    static int appendEffects(const std::vector<std::shared_ptr<EffectStackModel>> &stacks, const std::vector<EffectDescription> &effects, Fun &undo,
+                             Fun &redo, bool makeCurrent = false);
     /* @brief Delete active effect from stack */
     void removeCurrentEffect();
 
@@ -175,6 +205,18 @@ private:
      *          in the producer, so we shouldn't plant them again. Setting this value to
      *          true will prevent planting in the producer */
     bool m_loadingExisting;
+    /** @brief: When adding or removing several effects at once, the owner is refreshed once at the end instead of on each effect */
+    bool m_batchInsertion;
+
+    /** @brief Build the effects of a batch for this stack
+        @return an empty list if they cannot be added, for example if a unique effect would be added twice */
+    std::vector<std::shared_ptr<EffectItemModel>> createEffects(const std::vector<EffectDescription> &effects);
+    /** @brief Add / remove the effects of a batch to the stack and send a single dataChanged, the owner is refreshed by refreshOwners */
+    bool plantEffects(const std::vector<std::shared_ptr<EffectItemModel>> &effects, bool makeCurrent);
+    bool unplantEffects(const std::vector<std::shared_ptr<EffectItemModel>> &effects);
+    void refreshAfterBatch(const std::vector<std::shared_ptr<EffectItemModel>> &effects);
+    /** @brief Refresh the owners of the stacks of a batch, with one invalidation and monitor refresh for all timeline clips */
+    static void refreshOwners(const std::vector<std::shared_ptr<EffectStackModel>> &stacks, bool hasVideo);
 private slots:
     /** @brief: Some effects do not support dynamic changes like sox, and need to be unplugged / replugged on each param change
      */
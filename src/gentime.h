@@ -18,12 +18,16 @@
 #ifndef GENTIME_H
 #define GENTIME_H
 
+#include "utils/ticktime.hpp"
+
 #include <QString>
 #include <cmath>
 
 /**
  * @class GenTime
  * @brief Encapsulates a time, which can be set in various forms and outputted in various forms.
+ * Containers that need an exact ordering should be keyed on TickTime: a GenTime converts to a TickTime at the start of its
+ * frame (see setFps), and back.
  * @author Jason Wood
  */
 
@@ -31,76 +35,119 @@ class GenTime
 {
 public:
     /** @brief Creates a GenTime object, with a time of 0 seconds. */
-    GenTime();
+    GenTime()
+        : m_time(0.0)
+    {
+    }
 
     /** @brief Creates a GenTime object, with time given in seconds. */
-    explicit GenTime(double seconds);
+    explicit GenTime(double seconds)
+        : m_time(seconds)
+    {
+    }
 
     /** @brief Creates a GenTime object, by passing number of frames and how many frames per second. */
-    GenTime(int frames, double framesPerSecond);
+    GenTime(int frames, double framesPerSecond)
+        : m_time((double)frames / framesPerSecond)
+    {
+    }
+
+    /** @brief Creates a GenTime object from an exact time. */
+    GenTime(TickTime time)
+        : m_time(time.seconds())
+    {
+    }
+
+    /** @brief Converts to an exact time, at the start of the nearest frame of the rate set with setFps. */
+    operator TickTime() const
+    {
+        const double fps = grid().fps;
+        return fps > 0 ? TickTime::fromFrames(frames(fps), fps) : TickTime::fromSeconds(m_time);
+    }
 
     /** @brief Gets the time, in seconds. */
-    double seconds() const;
+    double seconds() const { return m_time; }
 
     /** @brief Gets the time, in milliseconds */
-    double ms() const;
+    double ms() const { return m_time * 1000; }
 
     /** @brief Gets the time in frames.
      * @param framesPerSecond Number of frames per second */
-    int frames(double framesPerSecond) const;
+    int frames(double framesPerSecond) const { return (int)floor(m_time * framesPerSecond + 0.5); }
 
-    QString toString() const;
+    QString toString() const { return QStringLiteral("%1 s").arg(m_time, 0, 'f', 2); }
 
     /*
      * Operators.
      */
 
     /// Unary minus
-    GenTime operator-();
+    GenTime operator-() { return GenTime(-m_time); }
 
     /// Addition
-    GenTime &operator+=(GenTime op);
+    GenTime &operator+=(GenTime op)
+    {
+        m_time += op.m_time;
+        return *this;
+    }
 
     /// Subtraction
-    GenTime &operator-=(GenTime op);
+    GenTime &operator-=(GenTime op)
+    {
+        m_time -= op.m_time;
+        return *this;
+    }
 
     /** @brief Adds two GenTimes. */
-    GenTime operator+(GenTime op) const;
+    GenTime operator+(GenTime op) const { return GenTime(m_time + op.m_time); }
 
     /** @brief Subtracts one genTime from another. */
-    GenTime operator-(GenTime op) const;
+    GenTime operator-(GenTime op) const { return GenTime(m_time - op.m_time); }
 
     /** @brief Multiplies one GenTime by a double value, returning a GenTime. */
-    GenTime operator*(double op) const;
+    GenTime operator*(double op) const { return GenTime(m_time * op); }
 
     /** @brief Divides one GenTime by a double value, returning a GenTime. */
-    GenTime operator/(double op) const;
+    GenTime operator/(double op) const { return GenTime(m_time / op); }
 
     /* All the comparison operators considers that two GenTime that differs by less
     than one frame are equal.
     The fps used to carry this computation must be set using the static function setFps
     */
-    bool operator<(GenTime op) const;
+    bool operator<(GenTime op) const { return m_time + grid().delta < op.m_time; }
 
-    bool operator>(GenTime op) const;
+    bool operator>(GenTime op) const { return m_time > op.m_time + grid().delta; }
 
-    bool operator>=(GenTime op) const;
+    bool operator>=(GenTime op) const { return m_time + grid().delta >= op.m_time; }
 
-    bool operator<=(GenTime op) const;
+    bool operator<=(GenTime op) const { return m_time <= op.m_time + grid().delta; }
 
-    bool operator==(GenTime op) const;
+    bool operator==(GenTime op) const { return fabs(m_time - op.m_time) < grid().delta; }
 
-    bool operator!=(GenTime op) const;
+    bool operator!=(GenTime op) const { return fabs(m_time - op.m_time) >= grid().delta; }
 
-    /** @brief Sets the fps used to determine if two GenTimes are equal */
-    static void setFps(double fps);
+    /** @brief Sets the fps used to determine if two GenTimes are equal, and to convert them to TickTime */
+    static void setFps(double fps)
+    {
+        grid().fps = fps;
+        grid().delta = 0.9 / fps;
+    }
 
 private:
     /** Holds the time in seconds for this object. */
     double m_time;
 
-    /** A delta value that is used to get around floating point rounding issues. */
-    static double s_delta;
+    struct FrameGrid
+    {
+        double fps = 0.;
+        /** A delta value that is used to get around floating point rounding issues. */
+        double delta = 0.00001;
+    };
+    static FrameGrid &grid()
+    {
+        static FrameGrid frameGrid;
+        return frameGrid;
+    }
 };
 
 #endif
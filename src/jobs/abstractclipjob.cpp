@@ -21,6 +21,7 @@
 #include "abstractclipjob.h"
 #include "doc/kdenlivedoc.h"
 #include "kdenlivesettings.h"
+#include "utils/latencystats.hpp"
 
 AbstractClipJob::AbstractClipJob(JOBTYPE type, QString id, QObject *parent)
     : QObject(parent)
@@ -56,6 +57,12 @@ const QString AbstractClipJob::getLogDetails() const
 // static
 bool AbstractClipJob::execute(const std::shared_ptr<AbstractClipJob> &job)
 {
+    // Indexed by JOBTYPE
+    static const char *probeNames[] = {"job.other",      "job.proxy", "job.cut",   "job.stabilize",  "job.transcode", "job.filter",
+                                       "job.thumbnail",  "job.analyse", "job.load", "job.audiothumb", "job.speed",     "job.cache",
+                                       "job.spectrogram", "job.loudness"};
+    int type = int(job->jobType());
+    LatencyProbe probe(type >= 0 && type <= LOUDNESSJOB ? probeNames[type] : probeNames[0]);
     return job->startJob();
 }
 
@@ -51,7 +51,9 @@ public:
         LOADJOB = 8,
         AUDIOTHUMBJOB = 9,
         SPEEDJOB = 10,
-        CACHEJOB = 11
+        CACHEJOB = 11,
+        SPECTROGRAMJOB = 12,
+        LOUDNESSJOB = 13
     };
     AbstractClipJob(JOBTYPE type, QString id, QObject *parent = nullptr);
     ~AbstractClipJob() override;
@@ -96,6 +98,9 @@ signals:
     // send an int between 0 and 100 to reflect computation progress
     void jobProgress(int);
     void jobCanceled();
+    // suspend / continue the external process of the job, if any
+    void jobPaused();
+    void jobResumed();
 };
 
 #endif
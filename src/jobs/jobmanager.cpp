@@ -37,6 +37,7 @@ int JobManager::m_currentId = 0;
 JobManager::JobManager(QObject *parent)
     : QAbstractListModel(parent)
     , m_lock(QReadWriteLock::Recursive)
+    , m_paused(0)
 {
 }
 
@@ -222,6 +223,39 @@ void JobManager::slotCancelJobs()
     }
 }
 
+bool JobManager::isPaused() const
+{
+    return m_paused.loadAcquire() != 0;
+}
+
+void JobManager::slotPauseJobs()
+{
+    QReadLocker locker(&m_lock);
+    m_paused.storeRelease(1);
+    for (const auto &j : m_jobs) {
+        if (j.second->m_processed) {
+            continue;
+        }
+        for (const std::shared_ptr<AbstractClipJob> &job : j.second->m_job) {
+            emit job->jobPaused();
+        }
+    }
+}
+
+void JobManager::slotResumeJobs()
+{
+    QReadLocker locker(&m_lock);
+    m_paused.storeRelease(0);
+    for (const auto &j : m_jobs) {
+        if (j.second->m_processed) {
+            continue;
+        }
+        for (const std::shared_ptr<AbstractClipJob> &job : j.second->m_job) {
+            emit job->jobResumed();
+        }
+    }
+}
+
 void JobManager::createJob(const std::shared_ptr<Job_t> &job)
 {
     // connect progress signals
@@ -229,7 +263,8 @@ void JobManager::createJob(const std::shared_ptr<Job_t> &job)
     for (const auto &it : job->m_indices) {
         size_t i = it.second;
         auto binId = it.first;
-        connect(job->m_job[i].get(), &AbstractClipJob::jobProgress, [job, i, binId](int p) {
+        // Jobs report progress from their worker thread, update the model from the main thread
+        connect(job->m_job[i].get(), &AbstractClipJob::jobProgress, this, [job, i, binId](int p) {
             job->m_progress[i] = std::max(job->m_progress[i], p);
             if (pCore) {
                 pCore->projectItemModel()->onItemUpdated(binId, AbstractProjectItem::JobProgress);
@@ -29,6 +29,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QAbstractListModel>
 #include <QFutureWatcher>
 #include <QObject>
+#include <QAtomicInt>
 #include <QReadWriteLock>
 #include <map>
 #include <memory>
@@ -127,6 +128,9 @@ public:
     /** @brief return the message of a given job on a given clip (message, detailed log)*/
     QPair<QString, QString> getJobMessageForClip(int jobId, const QString &binId) const;
 
+    /** @brief Returns true if the jobs were suspended by slotPauseJobs. Processes started meanwhile should start paused */
+    bool isPaused() const;
+
     // Mandatory overloads
     QVariant data(const QModelIndex &index, int role) const override;
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -148,6 +152,10 @@ public slots:
     void slotCancelJobs();
     /** @brief Discard all pending jobs. */
     void slotCancelPendingJobs();
+    /** @brief Suspend the external processes of all running jobs. */
+    void slotPauseJobs();
+    /** @brief Continue the jobs suspended by slotPauseJobs. */
+    void slotResumeJobs();
 
 private:
     /** @brief This is a lock that ensures safety in case of concurrent access */
@@ -159,6 +167,7 @@ private:
     /** @brief List of all the jobs by clip. */
     std::unordered_map<QString, std::vector<int>> m_jobsByClip;
     std::unordered_map<int, std::vector<int>> m_jobsByParents;
+    QAtomicInt m_paused;
 
 signals:
     void jobCount(int);
@@ -30,6 +30,7 @@
 #include "klocalizedstring.h"
 #include "macros.hpp"
 #include "profiles/profilemodel.hpp"
+#include "utils/filehashcache.hpp"
 #include "project/dialogs/slideshowclip.h"
 #include "effects/effectsrepository.hpp"
 #include "effects/effectstack/model/effectstackmodel.hpp"
@@ -272,6 +273,11 @@ bool LoadJob::startJob()
     if (type == ClipType::Unknown) {
         type = getTypeForService(service, m_resource);
     }
+    if (type == ClipType::AV || type == ClipType::Audio || type == ClipType::Video || type == ClipType::Image) {
+        // Hash the source in the job thread, the clip then reads it from the memo when it is loaded
+        QString original = Xml::getXmlProperty(m_xml, QStringLiteral("kdenlive:originalurl"));
+        FileHashCache::get()->fileHash(original.isEmpty() ? m_resource : original);
+    }
     switch (type) {
     case ClipType::Color:
         m_producer = loadResource(m_resource, QStringLiteral("color:"));
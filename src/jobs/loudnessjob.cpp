@@ -0,0 +1,245 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "loudnessjob.hpp"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
+#include "core.h"
+#include "effects/effectstack/model/effectstackmodel.hpp"
+#include "kdenlivesettings.h"
+#include "klocalizedstring.h"
+#include "lib/audio/audioStreamInfo.h"
+#include "macros.hpp"
+#include "processrunner.hpp"
+
+#include <QFile>
+#include <QRegularExpression>
+#include <cmath>
+
+// ebur128 reports the loudness of silence as -70 LUFS
+#define LOUDNESS_SILENCE -70.
+
+namespace {
+const QString loudnessProperty(int stream)
+{
+    return QStringLiteral("kdenlive:loudness.%1").arg(stream);
+}
+
+double parseLoudness(const QString &value)
+{
+    if (value.endsWith(QLatin1String("inf"))) {
+        return value.startsWith(QLatin1Char('-')) ? -INFINITY : INFINITY;
+    }
+    return value.toDouble();
+}
+} // namespace
+
+LoudnessJob::LoudnessJob(const QString &binId, bool normalize)
+    : AbstractClipJob(LOUDNESSJOB, binId)
+    , m_normalize(normalize)
+{
+}
+
+const QString LoudnessJob::getDescription() const
+{
+    return i18n("Measuring loudness of clip %1", m_clipId);
+}
+
+bool LoudnessJob::cachedMeasure(const std::shared_ptr<ProjectClip> &clip, int stream, Measure &measure)
+{
+    const QStringList values = clip->getProducerProperty(loudnessProperty(stream)).split(QLatin1Char(';'));
+    if (values.count() != 3) {
+        return false;
+    }
+    measure = {parseLoudness(values.at(0)), parseLoudness(values.at(1)), parseLoudness(values.at(2))};
+    return true;
+}
+
+double LoudnessJob::normalizationGain(const Measure &measure, double target, double maxTruePeak)
+{
+    if (!std::isfinite(measure.integrated) || measure.integrated <= LOUDNESS_SILENCE) {
+        // Don't amplify silence
+        return 0.;
+    }
+    double gain = target - measure.integrated;
+    if (std::isfinite(measure.truePeak) && measure.truePeak + gain > maxTruePeak) {
+        gain = maxTruePeak - measure.truePeak;
+    }
+    return gain;
+}
+
+QMap<int, LoudnessJob::Measure> LoudnessJob::parseSummaries(const QString &log)
+{
+    static const QRegularExpression filterExp(QStringLiteral("\\[Parsed_ebur128_(\\d+) @ [^\\]]*\\] Summary:"));
+    static const QRegularExpression valueExp(QStringLiteral("^\\s*(I|LRA|Peak):\\s*(-?inf|-?\\d+(?:\\.\\d+)?)"));
+    QMap<int, Measure> measures;
+    // Only fully parsed summaries are returned
+    QMap<int, int> foundValues;
+    int current = -1;
+    const QStringList lines = log.split(QLatin1Char('\n'));
+    for (const QString &line : lines) {
+        QRegularExpressionMatch match = filterExp.match(line);
+        if (match.hasMatch()) {
+            current = match.captured(1).toInt();
+            measures[current] = {NAN, NAN, NAN};
+            foundValues[current] = 0;
+            continue;
+        }
+        if (current < 0) {
+            continue;
+        }
+        match = valueExp.match(line);
+        if (!match.hasMatch()) {
+            continue;
+        }
+        const QString name = match.captured(1);
+        const double value = parseLoudness(match.captured(2));
+        Measure &measure = measures[current];
+        if (name == QLatin1String("I")) {
+            measure.integrated = value;
+        } else if (name == QLatin1String("LRA")) {
+            measure.range = value;
+        } else {
+            measure.truePeak = value;
+        }
+        foundValues[current]++;
+    }
+    QMutableMapIterator<int, Measure> i(measures);
+    while (i.hasNext()) {
+        i.next();
+        if (foundValues.value(i.key()) < 3) {
+            i.remove();
+        }
+    }
+    return measures;
+}
+
+bool LoudnessJob::startJob()
+{
+    if (m_done) {
+        return true;
+    }
+    m_binClip = pCore->projectItemModel()->getClipByBinID(m_clipId);
+    if (m_binClip == nullptr || m_binClip->audioInfo() == nullptr || m_binClip->audioChannels() == 0) {
+        // Clip was deleted or has no audio, skip it without failing the other clips of the batch
+        m_binClip.reset();
+        m_successful = m_done = true;
+        return true;
+    }
+    // Only decode the streams that were not analysed yet
+    QList<int> streams;
+    const QList<int> allStreams = m_binClip->audioInfo()->streams().keys();
+    for (int stream : allStreams) {
+        Measure measure;
+        if (!cachedMeasure(m_binClip, stream, measure)) {
+            streams << stream;
+        }
+    }
+    if (streams.isEmpty()) {
+        m_successful = m_done = true;
+        return true;
+    }
+    const QString filePath = m_binClip->getOriginalUrl();
+    if (!QFile::exists(filePath)) {
+        m_errorMessage.append(i18n("Loudness: cannot open file %1", filePath));
+        m_done = true;
+        return false;
+    }
+    // One ebur128 filter per stream, all fed by the same decoder
+    QStringList graph;
+    QStringList args {QStringLiteral("-hide_banner"), QStringLiteral("-i"), filePath};
+    QStringList outputs;
+    for (int i = 0; i < streams.count(); i++) {
+        int ffmpegIndex = qMax(0, m_binClip->getAudioStreamFfmpegIndex(streams.at(i)));
+        graph << QStringLiteral("[0:a:%1]ebur128=peak=true:framelog=verbose[loud%2]").arg(ffmpegIndex).arg(i);
+        outputs << QStringLiteral("-map") << QStringLiteral("[loud%1]").arg(i) << QStringLiteral("-f") << QStringLiteral("null") << QStringLiteral("-");
+    }
+    args << QStringLiteral("-filter_complex") << graph.join(QLatin1Char(';')) << outputs;
+    // The measures are logged, no file is created
+    ProcessRunner runner(ProcessRunner::FFmpeg, QString());
+    runner.setDuration(m_binClip->duration().seconds());
+    runner.connectJob(this);
+    const bool finished = runner.run(KdenliveSettings::ffmpegpath(), args);
+    const QString log = runner.log();
+    m_done = true;
+    if (runner.isCanceled()) {
+        // Job was aborted
+        return false;
+    }
+    const QMap<int, Measure> measures = parseSummaries(log);
+    if (!finished || measures.count() != streams.count()) {
+        m_logDetails = log;
+        m_errorMessage.append(i18n("Loudness: failed to measure the loudness of %1", filePath));
+        return false;
+    }
+    for (int i = 0; i < streams.count(); i++) {
+        m_measures.insert(streams.at(i), measures.value(i));
+    }
+    m_successful = true;
+    return true;
+}
+
+bool LoudnessJob::commitResult(Fun &undo, Fun &redo)
+{
+    Q_ASSERT(!m_resultConsumed);
+    if (!m_done) {
+        qDebug() << "ERROR: Trying to consume invalid results";
+        return false;
+    }
+    m_resultConsumed = true;
+    if (!m_successful) {
+        return false;
+    }
+    if (m_binClip == nullptr) {
+        // Skipped clip without audio
+        return true;
+    }
+    // The measures describe the source file and are not part of the undo history
+    QMapIterator<int, Measure> i(m_measures);
+    while (i.hasNext()) {
+        i.next();
+        const Measure &m = i.value();
+        m_binClip->setProducerProperty(loudnessProperty(i.key()), QStringLiteral("%1;%2;%3")
+                                                                       .arg(QString::number(m.integrated, 'f', 1), QString::number(m.range, 'f', 1),
+                                                                            QString::number(m.truePeak, 'f', 1)));
+    }
+    if (!m_measures.isEmpty()) {
+        pCore->setDocumentModified();
+    }
+    Measure measure;
+    if (!cachedMeasure(m_binClip, m_binClip->audioInfo()->audio_index(), measure)) {
+        // The active stream was not measured, nothing to report for this clip
+        return true;
+    }
+    if (!m_normalize) {
+        pCore->displayMessage(i18n("%1: integrated loudness %2 LUFS, loudness range %3 LU, true peak %4 dBTP", m_binClip->clipName(),
+                                   QString::number(measure.integrated, 'f', 1), QString::number(measure.range, 'f', 1),
+                                   QString::number(measure.truePeak, 'f', 1)),
+                              InformationMessage);
+        return true;
+    }
+    double gain = normalizationGain(measure, KdenliveSettings::loudnessTarget(), KdenliveSettings::loudnessMaxTruePeak());
+    if (!m_binClip->getEffectStack()->setNormalizationGain(gain, undo, redo)) {
+        // Don't discard the normalization of the other clips of the batch
+        pCore->displayMessage(i18n("Cannot normalize the loudness of %1", m_binClip->clipName()), ErrorMessage);
+    }
+    return true;
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include "abstractclipjob.h"
+
+#include <QMap>
+#include <memory>
+
+/**
+ * @class LoudnessJob
+ * @brief Measures the EBU R128 loudness of the audio streams of a clip, and optionally normalizes it
+ *
+ * All the audio streams of the clip are measured in a single FFmpeg decoding pass. The integrated
+ * loudness, loudness range and true peak of each stream are cached in the clip properties, so that
+ * normalizing an analysed clip does not decode it again. Clips without audio are skipped.
+ */
+
+class ProjectClip;
+class LoudnessJob : public AbstractClipJob
+{
+    Q_OBJECT
+
+public:
+    /* @brief Measure the loudness of the clip
+       @param normalize: if true, a gain bringing the active stream to the loudness target is applied to the clip
+    */
+    LoudnessJob(const QString &binId, bool normalize);
+
+    const QString getDescription() const override;
+    bool startJob() override;
+    bool commitResult(Fun &undo, Fun &redo) override;
+
+    struct Measure
+    {
+        /** @brief Integrated loudness, in LUFS */
+        double integrated;
+        /** @brief Loudness range, in LU */
+        double range;
+        /** @brief True peak, in dBTP */
+        double truePeak;
+    };
+    /** @brief Returns the cached measure of a stream of the clip, false if it was not analysed */
+    static bool cachedMeasure(const std::shared_ptr<ProjectClip> &clip, int stream, Measure &measure);
+    /** @brief Returns the gain in dB bringing a measure to the target loudness, limited so that the true peak stays below maxTruePeak */
+    static double normalizationGain(const Measure &measure, double target, double maxTruePeak);
+    /** @brief Parses the summaries logged by FFmpeg ebur128 filters, indexed by filter number */
+    static QMap<int, Measure> parseSummaries(const QString &log);
+
+private:
+    std::shared_ptr<ProjectClip> m_binClip;
+    bool m_normalize;
+    /** @brief The measures of this job, indexed by MLT stream */
+    QMap<int, Measure> m_measures;
+    bool m_done{false}, m_successful{false};
+};
@@ -0,0 +1,286 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "processrunner.hpp"
+#include "abstractclipjob.h"
+#include "core.h"
+#include "jobmanager.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <cstdio>
+#include <utility>
+
+#ifndef Q_OS_WIN
+#include <csignal>
+#include <sys/types.h>
+#endif
+
+ProcessRunner::ProcessRunner(Tool tool, QString destination, QObject *parent)
+    : QObject(parent)
+    , m_tool(tool)
+    , m_destination(std::move(destination))
+    , m_partialFile(m_destination.isEmpty() ? QString() : partialPath(m_destination))
+    , m_process(nullptr)
+    , m_pool(QThreadPool::globalInstance())
+    , m_durationUs(0)
+    , m_canceled(0)
+    , m_paused(0)
+    , m_pid(0)
+{
+}
+
+ProcessRunner::~ProcessRunner()
+{
+    if (!m_partialFile.isEmpty()) {
+        QFile::remove(m_partialFile);
+    }
+}
+
+// static
+QString ProcessRunner::partialPath(const QString &path)
+{
+    // Keep the file extension, encoders use it to select the output format
+    QFileInfo info(path);
+    return info.absoluteDir().absoluteFilePath(QStringLiteral(".part-") + info.fileName());
+}
+
+const QString &ProcessRunner::partialFile() const
+{
+    return m_partialFile;
+}
+
+void ProcessRunner::setDuration(double seconds)
+{
+    m_durationUs = qint64(seconds * 1000000);
+}
+
+const QString &ProcessRunner::log() const
+{
+    return m_log;
+}
+
+bool ProcessRunner::isCanceled() const
+{
+    return m_canceled.loadAcquire() != 0;
+}
+
+void ProcessRunner::connectJob(AbstractClipJob *job, bool forwardProgress)
+{
+    if (forwardProgress) {
+        connect(this, &ProcessRunner::progress, job, &AbstractClipJob::jobProgress, Qt::DirectConnection);
+    }
+    connect(job, &AbstractClipJob::jobCanceled, this, &ProcessRunner::cancel, Qt::DirectConnection);
+    connect(job, &AbstractClipJob::jobPaused, this, &ProcessRunner::pause, Qt::DirectConnection);
+    connect(job, &AbstractClipJob::jobResumed, this, &ProcessRunner::resume, Qt::DirectConnection);
+}
+
+void ProcessRunner::setThreadPool(QThreadPool *pool)
+{
+    m_pool = pool;
+}
+
+// static
+QSemaphore &ProcessRunner::processSlots(Tool tool)
+{
+    // Encoders are multithreaded themselves, only run a few of them at once
+    static QSemaphore ffmpegSlots(qMax(1, QThread::idealThreadCount() / 4));
+    static QSemaphore meltSlots(qMax(1, QThread::idealThreadCount() / 4));
+    return tool == FFmpeg ? ffmpegSlots : meltSlots;
+}
+
+bool ProcessRunner::run(const QString &program, QStringList arguments)
+{
+    // Wait for a free process slot, keeping the pool thread so that queued jobs stay queued
+    QSemaphore &available = processSlots(m_tool);
+    while (!available.tryAcquire(1, 200)) {
+        if (isCanceled()) {
+            return false;
+        }
+    }
+    bool result = runProcess(program, std::move(arguments));
+    available.release();
+    return result;
+}
+
+bool ProcessRunner::runProcess(const QString &program, QStringList arguments)
+{
+    if (isCanceled()) {
+        return false;
+    }
+    if (m_tool == FFmpeg) {
+        // Machine readable progress on stdout, stderr only keeps the error messages
+        arguments.removeAll(QStringLiteral("-stats"));
+        arguments.prepend(QStringLiteral("-nostats"));
+        arguments.prepend(QStringLiteral("pipe:1"));
+        arguments.prepend(QStringLiteral("-progress"));
+    }
+    QProcess process;
+    m_process = &process;
+    QEventLoop loop;
+    connect(&process, &QProcess::readyReadStandardOutput, this, &ProcessRunner::processOutput);
+    connect(&process, &QProcess::readyReadStandardError, this, &ProcessRunner::processLogInfo);
+    connect(&process, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), &loop, &QEventLoop::quit);
+    connect(&process, &QProcess::errorOccurred, &loop, [&loop](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            loop.quit();
+        }
+    });
+    if (!m_partialFile.isEmpty()) {
+        QFile::remove(m_partialFile);
+    }
+    process.start(program, arguments, QIODevice::ReadOnly);
+    if (process.waitForStarted()) {
+        m_pid.storeRelease(process.processId());
+        if (isCanceled()) {
+            process.kill();
+        } else if (pCore->jobManager()->isPaused()) {
+            pause();
+        }
+        // Waiting on the encoder does not use any cpu. The pool can start another job meanwhile,
+        // the number of running encoders is bounded by the process slots
+        if (m_pool) {
+            m_pool->releaseThread();
+        }
+        loop.exec();
+        if (m_pool) {
+            m_pool->reserveThread();
+        }
+    }
+    m_pid.storeRelease(0);
+    m_process = nullptr;
+    bool result = !isCanceled() && process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+    if (result) {
+        result = commitOutput();
+    }
+    if (!result && !m_partialFile.isEmpty()) {
+        QFile::remove(m_partialFile);
+    }
+    return result;
+}
+
+bool ProcessRunner::commitOutput()
+{
+    if (m_destination.isEmpty()) {
+        return true;
+    }
+    if (QFileInfo(m_partialFile).size() == 0) {
+        return false;
+    }
+    // rename() atomically replaces an existing destination on POSIX systems
+    if (std::rename(QFile::encodeName(m_partialFile).constData(), QFile::encodeName(m_destination).constData()) == 0) {
+        return true;
+    }
+    QFile::remove(m_destination);
+    return QFile::rename(m_partialFile, m_destination);
+}
+
+void ProcessRunner::processOutput()
+{
+    m_progressBuffer.append(m_process->readAllStandardOutput());
+    int ix = m_progressBuffer.lastIndexOf('\n');
+    if (ix < 0) {
+        return;
+    }
+    const QList<QByteArray> lines = m_progressBuffer.left(ix).split('\n');
+    m_progressBuffer.remove(0, ix + 1);
+    qint64 position = -1;
+    for (const QByteArray &line : lines) {
+        // out_time_ms is also expressed in microseconds
+        if (line.startsWith("out_time_us=") || line.startsWith("out_time_ms=")) {
+            bool ok;
+            qint64 value = line.mid(12).trimmed().toLongLong(&ok);
+            if (ok) {
+                position = value;
+            }
+        } else if (line.startsWith("progress=end")) {
+            emit progress(100);
+            return;
+        }
+    }
+    if (position >= 0 && m_durationUs > 0) {
+        emit progress(int(qBound(qint64(0), 100 * position / m_durationUs, qint64(99))));
+    }
+}
+
+void ProcessRunner::processLogInfo()
+{
+    const QString buffer = QString::fromUtf8(m_process->readAllStandardError());
+    m_log.append(buffer);
+    if (m_tool == Melt && buffer.contains(QLatin1String("percentage:"))) {
+        int value = buffer.section(QStringLiteral("percentage:"), -1).simplified().section(QLatin1Char(' '), 0, 0).toInt();
+        emit progress(value);
+    }
+}
+
+bool ProcessRunner::signalProcess(int sig)
+{
+#ifndef Q_OS_WIN
+    qint64 pid = m_pid.loadAcquire();
+    if (pid > 0) {
+        return ::kill(pid_t(pid), sig) == 0;
+    }
+#else
+    Q_UNUSED(sig)
+#endif
+    return false;
+}
+
+void ProcessRunner::cancel()
+{
+    if (!m_canceled.testAndSetOrdered(0, 1)) {
+        return;
+    }
+    if (m_paused.loadAcquire() != 0) {
+        resume();
+    }
+    // The process belongs to the job thread, kill it from there
+    QMetaObject::invokeMethod(this, [this]() {
+        if (m_process) {
+            m_process->kill();
+        }
+    }, Qt::QueuedConnection);
+}
+
+void ProcessRunner::pause()
+{
+#ifndef Q_OS_WIN
+    if (m_paused.testAndSetOrdered(0, 1) && !signalProcess(SIGSTOP)) {
+        m_paused.storeRelease(0);
+    }
+#endif
+}
+
+void ProcessRunner::resume()
+{
+#ifndef Q_OS_WIN
+    if (m_paused.testAndSetOrdered(1, 0) && !signalProcess(SIGCONT)) {
+        m_paused.storeRelease(1);
+    }
+#endif
+}
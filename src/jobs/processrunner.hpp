@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QProcess>
+
+class QSemaphore;
+class QThreadPool;
+
+class AbstractClipJob;
+
+/**
+ * @class ProcessRunner
+ * @brief Runs the external encoder (FFmpeg or melt) of a clip job.
+ *
+ * The process is driven by a local event loop instead of waitForFinished(), and the worker
+ * thread is released from the thread pool while waiting so that other jobs can start.
+ * The number of processes running at once is bounded per tool: a job waits for a free
+ * slot while still holding its pool thread, so the pool limits the number of waiting jobs.
+ * Progress is parsed from FFmpeg's -progress key/value output or from melt's percentage output.
+ * The encoder writes to a temporary file that is only renamed to the destination on success.
+ * Analysis processes that do not create a file are run with an empty destination.
+ */
+class ProcessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Tool { FFmpeg, Melt };
+    /** @param destination is the final file that the process creates, or an empty string if it does not create any */
+    ProcessRunner(Tool tool, QString destination, QObject *parent = nullptr);
+    ~ProcessRunner() override;
+
+    /** @brief Returns the temporary file that must be passed to the encoder as output */
+    const QString &partialFile() const;
+    /** @brief Returns the temporary name used while writing @param path */
+    static QString partialPath(const QString &path);
+    /** @brief Set the duration of the processed media, used to compute FFmpeg progress */
+    void setDuration(double seconds);
+    /** @brief Forward the cancel and pause requests of @param job to the process
+        @param forwardProgress if true, the process progress is also reported as the job progress */
+    void connectJob(AbstractClipJob *job, bool forwardProgress = true);
+    /** @brief Set the pool whose worker thread calls run(), the global pool by default.
+        The thread is given back to this pool while the process runs, nullptr keeps it */
+    void setThreadPool(QThreadPool *pool);
+    /** @brief Start the process and wait until it exits.
+        @return true if the process exited normally and the output file was moved to its destination */
+    bool run(const QString &program, QStringList arguments);
+    /** @brief The standard error output of the process */
+    const QString &log() const;
+    /** @brief Returns true if the process was stopped by a call to cancel() */
+    bool isCanceled() const;
+
+public slots:
+    /** @brief Stop the process and discard its output. Can be called from any thread */
+    void cancel();
+    /** @brief Suspend the running process. Can be called from any thread */
+    void pause();
+    /** @brief Continue a paused process. Can be called from any thread */
+    void resume();
+
+private slots:
+    void processOutput();
+    void processLogInfo();
+
+private:
+    Tool m_tool;
+    QString m_destination;
+    QString m_partialFile;
+    QProcess *m_process;
+    QThreadPool *m_pool;
+    qint64 m_durationUs;
+    QAtomicInt m_canceled;
+    QAtomicInt m_paused;
+    QAtomicInteger<qint64> m_pid;
+    QString m_log;
+    QByteArray m_progressBuffer;
+    /** @brief Send a signal to the running process */
+    bool signalProcess(int sig);
+    /** @brief Move the temporary output to its destination */
+    bool commitOutput();
+    /** @brief Start the process once a slot is available */
+    bool runProcess(const QString &program, QStringList arguments);
+    /** @brief The slots limiting the number of processes of a tool running at once */
+    static QSemaphore &processSlots(Tool tool);
+
+signals:
+    /** @brief Sends an int between 0 and 100 to reflect process progress */
+    void progress(int);
+};
@@ -27,18 +27,20 @@
 #include "kdenlive_debug.h"
 #include "kdenlivesettings.h"
 #include "macros.hpp"
+#include "processrunner.hpp"
 
+#include <QMutex>
 #include <QProcess>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
 
 #include <klocalizedstring.h>
 
 ProxyJob::ProxyJob(const QString &binId)
     : AbstractClipJob(PROXYJOB, binId)
-    , m_jobDuration(0)
-    , m_isFfmpegJob(true)
-    , m_jobProcess(nullptr)
     , m_done(false)
 {
 }
@@ -59,14 +61,16 @@ bool ProxyJob::startJob()
         return true;
     }
     ClipType::ProducerType type = binClip->clipType();
-    bool result;
+    QString program;
+    QStringList arguments;
+    ProcessRunner::Tool tool = ProcessRunner::FFmpeg;
+    std::unique_ptr<QTemporaryFile> playlist;
     QString source = binClip->getProducerProperty(QStringLiteral("kdenlive:originalurl"));
     int exif = binClip->getProducerIntProperty(QStringLiteral("_exif_orientation"));
     if (type == ClipType::Playlist || type == ClipType::SlideShow) {
         // change FFmpeg params to MLT format
-        m_isFfmpegJob = false;
+        tool = ProcessRunner::Melt;
         QStringList mltParameters;
-        QTemporaryFile *playlist = nullptr;
         // set clip origin
         if (type == ClipType::Playlist) {
             // Special case: playlists use the special 'consumer' producer to support resizing
@@ -76,18 +80,18 @@ bool ProxyJob::startJob()
             // we save a temporary .mlt clip for rendering
             QDomDocument doc;
             QDomElement xml = binClip->toXml(doc, false);
-            playlist = new QTemporaryFile();
+            playlist.reset(new QTemporaryFile());
             playlist->setFileTemplate(playlist->fileTemplate() + QStringLiteral(".mlt"));
             if (playlist->open()) {
                 source = playlist->fileName();
-                QTextStream out(playlist);
+                QTextStream out(playlist.get());
                 out << doc.toString();
                 playlist->close();
             }
         }
         mltParameters << source;
-        // set destination
-        mltParameters << QStringLiteral("-consumer") << QStringLiteral("avformat:") + dest;
+        // set destination, the encoder writes to a temporary file that is renamed once complete
+        mltParameters << QStringLiteral("-consumer") << QStringLiteral("avformat:") + ProcessRunner::partialPath(dest);
         QString parameter = pCore->currentDoc()->getDocumentProperty(QStringLiteral("proxyparams")).simplified();
         if (parameter.isEmpty()) {
             // Automatic setting, decide based on hw support
@@ -159,17 +163,9 @@ bool ProxyJob::startJob()
 
         // Ask for progress reporting
         mltParameters << QStringLiteral("progress=1");
-
-        m_jobProcess = new QProcess;
-        // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-        connect(this, &ProxyJob::jobCanceled, m_jobProcess, &QProcess::kill, Qt::DirectConnection);
-        connect(m_jobProcess, &QProcess::readyReadStandardError, this, &ProxyJob::processLogInfo);
-        m_jobProcess->start(KdenliveSettings::rendererpath(), mltParameters);
-        m_jobProcess->waitForFinished(-1);
-        result = m_jobProcess->exitStatus() == QProcess::NormalExit;
-        delete playlist;
+        program = KdenliveSettings::rendererpath();
+        arguments = mltParameters;
     } else if (type == ClipType::Image) {
-        m_isFfmpegJob = false;
         // Image proxy
         QImage i(source);
         if (i.isNull()) {
@@ -224,7 +220,6 @@ bool ProxyJob::startJob()
         m_done = true;
         return true;
     } else {
-        m_isFfmpegJob = true;
         if (!QFileInfo(KdenliveSettings::ffmpegpath()).isFile()) {
             // FFmpeg not detected, cannot process the Job
             m_errorMessage.prepend(i18n("Failed to create proxy. FFmpeg not found, please set path in Kdenlive's settings Environment"));
@@ -232,8 +227,7 @@ bool ProxyJob::startJob()
             return false;
         }
         // Only output error data, make sure we don't block when proxy file already exists
-        QStringList parameters = {QStringLiteral("-hide_banner"), QStringLiteral("-y"), QStringLiteral("-stats"), QStringLiteral("-v"), QStringLiteral("error")};
-        m_jobDuration = (int)binClip->duration().seconds();
+        QStringList parameters = {QStringLiteral("-hide_banner"), QStringLiteral("-y"), QStringLiteral("-v"), QStringLiteral("error")};
         QString proxyParams = pCore->currentDoc()->getDocumentProperty(QStringLiteral("proxyparams")).simplified();
         if (proxyParams.isEmpty()) {
             // Automatic setting, decide based on hw support
@@ -290,76 +284,167 @@ bool ProxyJob::startJob()
 
         // Make sure we keep the stream order
         parameters << QStringLiteral("-sn") << QStringLiteral("-dn") << QStringLiteral("-map") << QStringLiteral("0");
-        parameters << dest;
+        double duration = binClip->duration().seconds();
+        if (KdenliveSettings::proxysegments() > 1 && duration >= KdenliveSettings::proxysegmentminduration() * 60) {
+            m_done = createSegmentedProxy(parameters, source, dest, duration, KdenliveSettings::proxysegments());
+            if (!m_done && m_errorMessage.isEmpty()) {
+                m_errorMessage.append(i18n("Failed to create proxy clip."));
+            }
+            return m_done;
+        }
+        parameters << ProcessRunner::partialPath(dest);
         qDebug()<<"/// FULL PROXY PARAMS:\n"<<parameters<<"\n------";
-        m_jobProcess = new QProcess;
-        // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-        connect(m_jobProcess, &QProcess::readyReadStandardError, this, &ProxyJob::processLogInfo);
-        connect(this, &ProxyJob::jobCanceled, m_jobProcess, &QProcess::kill, Qt::DirectConnection);
-        m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
-        m_jobProcess->waitForFinished(-1);
-        result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+        program = KdenliveSettings::ffmpegpath();
+        arguments = parameters;
     }
-    // remove temporary playlist if it exists
-    if (result) {
-        if (QFileInfo(dest).size() == 0) {
-            QFile::remove(dest);
-            // File was not created
-            m_done = false;
-            m_errorMessage.append(i18n("Failed to create proxy clip."));
-        } else {
-            m_done = true;
-        }
-    } else {
-        // Proxy process crashed
-        QFile::remove(dest);
-        m_done = false;
-        m_errorMessage.append(QString::fromUtf8(m_jobProcess->readAll()));
+    ProcessRunner runner(tool, dest);
+    runner.setDuration(binClip->duration().seconds());
+    runner.connectJob(this);
+    bool result = runner.run(program, arguments);
+    m_logDetails.append(runner.log());
+    m_done = result;
+    if (!result && !runner.isCanceled()) {
+        // Proxy process crashed or the file was not created
+        m_errorMessage.append(i18n("Failed to create proxy clip."));
     }
-    m_jobProcess->deleteLater();
     return result;
 }
 
-void ProxyJob::processLogInfo()
+// static
+double ProxyJob::nextKeyframe(const QString &source, double position)
 {
-    const QString buffer = QString::fromUtf8(m_jobProcess->readAllStandardError());
-    m_logDetails.append(buffer);
-    int progress = 0;
-    if (m_isFfmpegJob) {
-        // Parse FFmpeg output
-        if (m_jobDuration == 0) {
-            if (buffer.contains(QLatin1String("Duration:"))) {
-                QString data = buffer.section(QStringLiteral("Duration:"), 1, 1).section(QLatin1Char(','), 0, 0).simplified();
-                if (!data.isEmpty()) {
-                    QStringList numbers = data.split(QLatin1Char(':'));
-                    if (numbers.size() < 3) {
-                        return;
-                    }
-                    m_jobDuration = (int)(numbers.at(0).toInt() * 3600 + numbers.at(1).toInt() * 60 + numbers.at(2).toDouble());
-                }
-            }
-        } else if (buffer.contains(QLatin1String("time="))) {
-            QString time = buffer.section(QStringLiteral("time="), 1, 1).simplified().section(QLatin1Char(' '), 0, 0);
-            if (!time.isEmpty()) {
-                QStringList numbers = time.split(QLatin1Char(':'));
-                if (numbers.size() < 3) {
-                    progress = (int)time.toDouble();
-                    if (progress == 0) {
-                        return;
-                    }
-                } else {
-                    progress = numbers.at(0).toInt() * 3600 + numbers.at(1).toInt() * 60 + numbers.at(2).toDouble();
-                }
+    const QString ffprobe = KdenliveSettings::ffprobepath();
+    if (ffprobe.isEmpty() || !QFileInfo(ffprobe).isFile()) {
+        return position;
+    }
+    // Only decode a few seconds of key frames from the requested position
+    QStringList args = {QStringLiteral("-v"), QStringLiteral("error"), QStringLiteral("-select_streams"), QStringLiteral("v:0"), QStringLiteral("-skip_frame"),
+                        QStringLiteral("nokey"), QStringLiteral("-show_entries"), QStringLiteral("frame=pts_time"), QStringLiteral("-of"),
+                        QStringLiteral("csv=p=0"), QStringLiteral("-read_intervals"), QStringLiteral("%1%+10").arg(position, 0, 'f', 3), source};
+    QProcess probe;
+    probe.start(ffprobe, args, QIODevice::ReadOnly);
+    if (!probe.waitForFinished(30000)) {
+        probe.kill();
+        return position;
+    }
+    const QList<QByteArray> lines = probe.readAllStandardOutput().split('\n');
+    for (const QByteArray &line : lines) {
+        bool ok;
+        double time = line.split(',').constFirst().trimmed().toDouble(&ok);
+        if (ok && time >= position) {
+            return time;
+        }
+    }
+    return position;
+}
+
+bool ProxyJob::createSegmentedProxy(const QStringList &parameters, const QString &source, const QString &dest, double duration, int segments)
+{
+    QFileInfo destInfo(dest);
+    QTemporaryDir tmpDir(destInfo.absoluteDir().absoluteFilePath(QStringLiteral(".proxy-segments-XXXXXX")));
+    if (!tmpDir.isValid()) {
+        return false;
+    }
+    // Cut points are moved to the next key frame so that each part starts with a cheap seek
+    QVector<double> cuts = {0.};
+    for (int i = 1; i < segments; i++) {
+        double cut = nextKeyframe(source, duration * i / segments);
+        if (cut > cuts.constLast() && cut < duration) {
+            cuts << cut;
+        }
+    }
+    cuts << duration;
+    int inputIndex = parameters.indexOf(QStringLiteral("-i"));
+    if (inputIndex < 0) {
+        return false;
+    }
+    int count = cuts.size() - 1;
+    QStringList segmentFiles;
+    for (int i = 0; i < count; i++) {
+        segmentFiles << tmpDir.filePath(QStringLiteral("%1.%2").arg(i).arg(destInfo.suffix()));
+    }
+    QMutex runnersMutex;
+    std::vector<ProcessRunner *> runners;
+    QAtomicInt failed(0);
+    QVector<QAtomicInt> progress(count);
+    auto encodeSegment = [&](int i) {
+        if (failed.loadAcquire() != 0) {
+            return false;
+        }
+        QStringList args = parameters;
+        args.insert(inputIndex, QString::number(cuts.at(i), 'f', 3));
+        args.insert(inputIndex, QStringLiteral("-ss"));
+        args << QStringLiteral("-t") << QString::number(cuts.at(i + 1) - cuts.at(i), 'f', 3);
+        // The runner has to be created in the thread where it runs to receive the process signals
+        ProcessRunner runner(ProcessRunner::FFmpeg, segmentFiles.at(i));
+        runner.setDuration(cuts.at(i + 1) - cuts.at(i));
+        runner.connectJob(this, false);
+        // The segment pool already has a thread for each segment
+        runner.setThreadPool(nullptr);
+        // Progress is only stored here, the job thread reports it
+        connect(&runner, &ProcessRunner::progress, [&progress, i](int p) { progress[i].storeRelease(p); });
+        args << runner.partialFile();
+        {
+            QMutexLocker lock(&runnersMutex);
+            runners.push_back(&runner);
+        }
+        bool ok = runner.run(KdenliveSettings::ffmpegpath(), args);
+        QMutexLocker lock(&runnersMutex);
+        runners.erase(std::find(runners.begin(), runners.end(), &runner));
+        m_logDetails.append(runner.log());
+        ok = ok && !runner.isCanceled();
+        if (!ok && failed.testAndSetOrdered(0, 1)) {
+            // No need to finish the other parts
+            for (ProcessRunner *sibling : runners) {
+                sibling->cancel();
             }
-            emit jobProgress((int)(100.0 * progress / m_jobDuration));
         }
-    } else {
-        // Parse MLT output
-        if (buffer.contains(QLatin1String("percentage:"))) {
-            progress = buffer.section(QStringLiteral("percentage:"), 1).simplified().section(QLatin1Char(' '), 0, 0).toInt();
-            emit jobProgress(progress);
+        return ok;
+    };
+    // The segments wait for their encoder in their own pool, the number of encoders is bounded by ProcessRunner
+    QThreadPool segmentPool;
+    segmentPool.setMaxThreadCount(count);
+    QList<QFuture<bool>> futures;
+    for (int i = 0; i < count; i++) {
+        futures << QtConcurrent::run(&segmentPool, [encodeSegment, i]() { return encodeSegment(i); });
+    }
+    int lastProgress = -1;
+    while (!segmentPool.waitForDone(200)) {
+        int total = 0;
+        for (const QAtomicInt &value : qAsConst(progress)) {
+            total += value.loadAcquire();
+        }
+        if (total / count != lastProgress) {
+            lastProgress = total / count;
+            emit jobProgress(lastProgress);
         }
     }
+    bool result = true;
+    for (auto &future : futures) {
+        result = future.result() && result;
+    }
+    if (!result) {
+        return false;
+    }
+    // Join the parts without encoding
+    QFile list(tmpDir.filePath(QStringLiteral("segments.txt")));
+    if (!list.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream out(&list);
+    for (QString file : qAsConst(segmentFiles)) {
+        out << QStringLiteral("file '%1'\n").arg(file.replace(QLatin1Char('\''), QStringLiteral("'\\''")));
+    }
+    list.close();
+    ProcessRunner runner(ProcessRunner::FFmpeg, dest);
+    runner.setDuration(duration);
+    runner.connectJob(this, false);
+    QStringList args = {QStringLiteral("-hide_banner"), QStringLiteral("-y"), QStringLiteral("-v"), QStringLiteral("error"), QStringLiteral("-f"),
+                        QStringLiteral("concat"), QStringLiteral("-safe"), QStringLiteral("0"), QStringLiteral("-i"), list.fileName(),
+                        QStringLiteral("-map"), QStringLiteral("0"), QStringLiteral("-c"), QStringLiteral("copy"), runner.partialFile()};
+    result = runner.run(KdenliveSettings::ffmpegpath(), args);
+    m_logDetails.append(runner.log());
+    return result;
 }
 
 bool ProxyJob::commitResult(Fun &undo, Fun &redo)
@@ -23,8 +23,6 @@
 
 #include "abstractclipjob.h"
 
-class QProcess;
-
 class ProxyJob : public AbstractClipJob
 {
     Q_OBJECT
@@ -37,14 +35,13 @@ public:
     By design, the job should store the result of the computation but not share it with the rest of the code. This happens when we call commitResult */
     bool commitResult(Fun &undo, Fun &redo) override;
 
-private slots:
-    void processLogInfo();
-
 private:
-    int m_jobDuration;
-    bool m_isFfmpegJob;
-    QProcess *m_jobProcess;
     bool m_done;
+    /** @brief Encode the proxy of a long clip as several parts in parallel, then join them
+        @param parameters are the FFmpeg parameters without the output file */
+    bool createSegmentedProxy(const QStringList &parameters, const QString &source, const QString &dest, double duration, int segments);
+    /** @brief Returns the time in seconds of the first video key frame at or after @param position, or position if it cannot be found */
+    static double nextKeyframe(const QString &source, double position);
 };
 
 #endif
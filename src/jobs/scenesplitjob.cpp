@@ -30,18 +30,44 @@
 #include "core.h"
 #include "jobmanager.h"
 #include "kdenlivesettings.h"
-#include "project/clipstabilize.h"
+#include "profiles/profilemodel.hpp"
 #include "ui_scenecutdialog_ui.h"
 
+#include <KLocalizedString>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QScopedPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
 
+#include <cmath>
 #include <mlt++/Mlt.h>
 
+namespace {
+// Height of the decoded frames, small images are enough to compare histograms
+const int analysisHeight = 64;
+// Minimum number of frames analysed by one thread
+const int minRangeLength = 500;
+// Histogram bins for luma and each chroma plane
+const int lumaBins = 32;
+const int chromaBins = 16;
+// Number of preceding frames used to compute the adaptive threshold
+const int thresholdWindow = 24;
+// Differences below this value are never considered as a cut
+const double minThreshold = 0.2;
+} // namespace
+
 SceneSplitJob::SceneSplitJob(const QString &binId, bool subClips, int markersType, int minInterval)
-    : MeltJob(binId, STABILIZEJOB, true, -1, -1)
+    : AbstractClipJob(STABILIZEJOB, binId)
     , m_subClips(subClips)
     , m_markersType(markersType)
     , m_minInterval(minInterval)
+    , m_length(0)
+    , m_processedFrames(0)
+    , m_canceled(0)
 {
 }
 
@@ -49,35 +75,168 @@ const QString SceneSplitJob::getDescription() const
 {
     return i18n("Scene split");
 }
-void SceneSplitJob::configureConsumer()
+bool SceneSplitJob::startJob()
 {
-    m_consumer = std::make_unique<Mlt::Consumer>(*m_profile.get(), "null");
-    m_consumer->set("all", 1);
-    m_consumer->set("terminate_on_pause", 1);
-    m_consumer->set("real_time", -1);
-    // We just want to find scene change, set all methods to the fastests
-    m_consumer->set("rescale", "nearest");
-    m_consumer->set("deinterlace_method", "onefield");
-    m_consumer->set("top_field_first", -1);
+    auto binClip = pCore->projectItemModel()->getClipByBinID(m_clipId);
+    if (!binClip) {
+        m_errorMessage.append(i18n("Invalid clip"));
+        m_done = true;
+        return false;
+    }
+    QString url = binClip->url();
+    // Scene changes are visible on the proxy as well, and it is much faster to decode
+    const QString proxy = binClip->getProducerProperty(QStringLiteral("kdenlive:proxy"));
+    if (proxy.length() > 2 && QFileInfo(proxy).isFile()) {
+        url = proxy;
+    }
+    if (url.isEmpty()) {
+        m_errorMessage.append(i18n("No producer for this clip."));
+        m_done = true;
+        return false;
+    }
+    m_length = (int)binClip->frameDuration();
+    if (m_length <= 0) {
+        m_errorMessage.append(i18n("Invalid clip"));
+        m_done = true;
+        return false;
+    }
+    connect(this, &SceneSplitJob::jobCanceled, this, [this]() { m_canceled.storeRelease(1); }, Qt::DirectConnection);
+    int ranges = qBound(1, m_length / minRangeLength, QThread::idealThreadCount());
+    // The ranges run in a pool owned by the job, so that waiting for them does not block the global pool
+    QThreadPool rangePool;
+    rangePool.setMaxThreadCount(ranges);
+    QList<QFuture<std::vector<double>>> futures;
+    for (int i = 0; i < ranges; i++) {
+        int start = (int)((qint64)m_length * i / ranges);
+        int end = (int)((qint64)m_length * (i + 1) / ranges);
+        futures << QtConcurrent::run(&rangePool, this, &SceneSplitJob::analyseRange, url, start, end);
+    }
+    int lastProgress = -1;
+    while (!rangePool.waitForDone(200)) {
+        int progress = 100 * m_processedFrames.loadAcquire() / m_length;
+        if (progress != lastProgress) {
+            lastProgress = progress;
+            emit jobProgress(progress);
+        }
+    }
+    std::vector<double> differences;
+    differences.reserve((size_t)m_length);
+    for (auto &future : futures) {
+        const std::vector<double> result = future.result();
+        differences.insert(differences.end(), result.cbegin(), result.cend());
+    }
+    if (m_canceled.loadAcquire() != 0 || (int)differences.size() != m_length) {
+        m_done = true;
+        return false;
+    }
+    m_cuts = detectCuts(differences);
+    m_successful = m_done = true;
+    return true;
 }
 
-void SceneSplitJob::configureFilter()
+std::vector<double> SceneSplitJob::analyseRange(const QString &url, int start, int end)
 {
-    m_filter = std::make_unique<Mlt::Filter>(*m_profile.get(), "motion_est");
-    if ((m_filter == nullptr) || !m_filter->is_valid()) {
-        m_errorMessage.append(i18n("Cannot create filter motion_est. Cannot split scenes"));
-        return;
+    std::vector<double> differences;
+    differences.reserve(size_t(end - start));
+    // Each thread needs its own profile and producer
+    auto &projectProfile = pCore->getCurrentProfile();
+    Mlt::Profile profile;
+    profile.set_explicit(0);
+    {
+        Mlt::Producer probe(profile, url.toUtf8().constData());
+        if (!probe.is_valid()) {
+            return differences;
+        }
+        profile.from_producer(probe);
     }
-
-    m_filter->set("shot_change_list", 0);
-    m_filter->set("denoise", 0);
-    m_filter->set_in_and_out(0, length - 1);
+    profile.set_explicit(1);
+    // Positions have to match the project frame rate
+    profile.set_frame_rate(projectProfile->frame_rate_num(), projectProfile->frame_rate_den());
+    profile.set_height(analysisHeight);
+    int width = (int)(analysisHeight * profile.dar());
+    profile.set_width(width + width % 2);
+    Mlt::Producer producer(profile, url.toUtf8().constData());
+    if (!producer.is_valid()) {
+        return differences;
+    }
+    std::vector<double> previous;
+    std::vector<double> current(lumaBins + 2 * chromaBins);
+    // Also decode the frame before the range to get the difference at the range start
+    for (int pos = qMax(0, start - 1); pos < end; pos++) {
+        if (m_canceled.loadAcquire() != 0) {
+            return {};
+        }
+        producer.seek(pos);
+        std::unique_ptr<Mlt::Frame> frame(producer.get_frame());
+        // We only need rough images, use the fastest methods
+        frame->set("rescale.interp", "nearest");
+        frame->set("consumer_deinterlace", 1);
+        frame->set("deinterlace_method", "onefield");
+        frame->set("top_field_first", -1);
+        mlt_image_format format = mlt_image_yuv422;
+        int w = profile.width();
+        int h = profile.height();
+        const uchar *image = frame->get_image(format, w, h);
+        std::fill(current.begin(), current.end(), 0.);
+        if (image && format == mlt_image_yuv422) {
+            // Packed Y0 U Y1 V
+            int pairs = w * h / 2;
+            for (int i = 0; i < pairs; i++) {
+                const uchar *p = image + 4 * i;
+                current[size_t(p[0] * lumaBins / 256)] += 1.;
+                current[size_t(p[2] * lumaBins / 256)] += 1.;
+                current[size_t(lumaBins + p[1] * chromaBins / 256)] += 2.;
+                current[size_t(lumaBins + chromaBins + p[3] * chromaBins / 256)] += 2.;
+            }
+            double total = qMax(1, 2 * pairs);
+            for (double &bin : current) {
+                bin /= total;
+            }
+        }
+        if (pos >= start) {
+            double diff = 0.;
+            if (!previous.empty()) {
+                for (size_t i = 0; i < current.size(); i++) {
+                    diff += std::abs(current[i] - previous[i]);
+                }
+                // Each of the 3 normalized histograms has a maximum distance of 2
+                diff /= 6.;
+            }
+            differences.push_back(diff);
+            // Progress is reported by the job thread
+            m_processedFrames.fetchAndAddRelaxed(1);
+        }
+        std::swap(previous, current);
+        current.resize(previous.size());
+    }
+    return differences;
 }
 
-void SceneSplitJob::configureProfile()
+// static
+std::vector<int> SceneSplitJob::detectCuts(const std::vector<double> &differences)
 {
-    m_profile->set_height(160);
-    m_profile->set_width(m_profile->height() * m_profile->sar());
+    std::vector<int> cuts;
+    double sum = 0.;
+    double squareSum = 0.;
+    for (size_t i = 0; i < differences.size(); i++) {
+        double diff = differences[i];
+        size_t count = qMin(i, (size_t)thresholdWindow);
+        if (count > 0) {
+            double mean = sum / count;
+            double variance = qMax(0., squareSum / count - mean * mean);
+            if (diff > qMax(minThreshold, mean + 4 * std::sqrt(variance))) {
+                cuts.push_back((int)i);
+            }
+        }
+        sum += diff;
+        squareSum += diff * diff;
+        if (i >= (size_t)thresholdWindow) {
+            double old = differences[i - thresholdWindow];
+            sum -= old;
+            squareSum -= old * old;
+        }
+    }
+    return cuts;
 }
 
 // static
@@ -118,21 +277,18 @@ bool SceneSplitJob::commitResult(Fun &undo, Fun &redo)
     if (!m_successful) {
         return false;
     }
-    QString result = QString::fromLatin1(m_filter->get("shot_change_list"));
-    if (result.isEmpty()) {
+    if (m_cuts.empty()) {
         m_errorMessage.append(i18n("No data returned from clip analysis"));
         return false;
     }
 
     auto binClip = pCore->projectItemModel()->getClipByBinID(m_clipId);
-    QStringList markerData = result.split(QLatin1Char(';'));
     if (m_markersType >= 0) {
         // Build json data for markers
         QJsonArray list;
         int ix = 1;
         int lastCut = 0;
-        for (const QString &marker : qAsConst(markerData)) {
-            int pos = marker.section(QLatin1Char('='), 0, 0).toInt();
+        for (int pos : m_cuts) {
             if (m_minInterval > 0 && ix > 1 && pos - lastCut < m_minInterval) {
                 continue;
             }
@@ -153,8 +309,7 @@ bool SceneSplitJob::commitResult(Fun &undo, Fun &redo)
         int lastCut = 0;
         QJsonArray list;
         QJsonDocument json;
-        for (const QString &marker : qAsConst(markerData)) {
-            int pos = marker.section(QLatin1Char('='), 0, 0).toInt();
+        for (int pos : m_cuts) {
             if (pos <= lastCut + 1 || pos - lastCut < m_minInterval) {
                 continue;
             }
@@ -172,7 +327,7 @@ bool SceneSplitJob::commitResult(Fun &undo, Fun &redo)
             pCore->projectItemModel()->loadSubClips(m_clipId, dataMap, undo, redo);
         }
     }
-    qDebug() << "RESULT of the SCENESPLIT filter:" << result;
+    qDebug() << "RESULT of the scene detection:" << m_cuts.size() << "cuts";
 
     // TODO refac: reimplement add markers and subclips
     return true;
@@ -23,18 +23,21 @@
 
 #pragma once
 
-#include "meltjob.h"
-#include <unordered_map>
-#include <unordered_set>
+#include "abstractclipjob.h"
+#include <QAtomicInt>
+#include <vector>
 
 /**
  * @class SceneSplitJob
- * @brief Detects the scenes of a clip using a mlt filter
+ * @brief Detects the scenes of a clip
  *
+ * Shot boundaries are found by comparing the luma and chroma histograms of consecutive frames
+ * decoded at a very low resolution. The clip is split in several time ranges analysed in
+ * parallel, then an adaptive threshold is applied on the merged histogram differences.
  */
 
 class JobManager;
-class SceneSplitJob : public MeltJob
+class SceneSplitJob : public AbstractClipJob
 {
     Q_OBJECT
 
@@ -50,21 +53,26 @@ public:
     // Then the job is automatically put in queue. Its id is returned
     static int prepareJob(const std::shared_ptr<JobManager> &ptr, const std::vector<QString> &binIds, int parentId, QString undoString);
 
+    bool startJob() override;
     bool commitResult(Fun &undo, Fun &redo) override;
     const QString getDescription() const override;
 
 protected:
-    // @brief create and configure consumer
-    void configureConsumer() override;
-
-    // @brief create and configure filter
-    void configureFilter() override;
-
-    // @brief extra configuration of the profile (eg: resize the profile)
-    void configureProfile() override;
+    /** @brief Compute the histogram difference of each frame in [start, end[ with the previous frame
+        @param url is the file to analyse
+        @return a vector of end - start differences between 0 and 1 */
+    std::vector<double> analyseRange(const QString &url, int start, int end);
+    /** @brief Returns the frames where the difference is significantly higher than in the preceding frames */
+    static std::vector<int> detectCuts(const std::vector<double> &differences);
 
     bool m_subClips;
     int m_markersType;
     // @brief minimum scene duration.
     int m_minInterval;
+    int m_length;
+    QAtomicInt m_processedFrames;
+    QAtomicInt m_canceled;
+    // @brief detected scene cuts, in frames
+    std::vector<int> m_cuts;
+    bool m_done{false}, m_successful{false};
 };
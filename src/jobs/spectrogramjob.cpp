@@ -0,0 +1,259 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "spectrogramjob.hpp"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
+#include "core.h"
+#include "klocalizedstring.h"
+#include "lib/audio/audioStreamInfo.h"
+#include "lib/audio/fftTools.h"
+#include "macros.hpp"
+#include "profiles/profilemodel.hpp"
+#include "scopes/audioscopes/spectrogram.h"
+
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <mlt++/MltProducer.h>
+#include <mlt++/MltProfile.h>
+#include <algorithm>
+
+// Range of the displayed values, in dB
+#define SPECTROGRAM_MIN_DB -90
+#define SPECTROGRAM_MAX_DB 0
+
+SpectrogramJob::SpectrogramJob(const QString &binId)
+    : AbstractClipJob(SPECTROGRAMJOB, binId)
+    , m_stream(-1)
+    , m_frequency(48000)
+    , m_channels(2)
+    , m_length(0)
+    , m_columns(0)
+{
+}
+
+const QString SpectrogramJob::getDescription() const
+{
+    return i18n("Computing spectrogram of clip %1", m_clipId);
+}
+
+bool SpectrogramJob::startJob()
+{
+    if (m_done) {
+        return true;
+    }
+    m_binClip = pCore->projectItemModel()->getClipByBinID(m_clipId);
+    if (m_binClip == nullptr || m_binClip->audioInfo() == nullptr || m_binClip->audioChannels() == 0) {
+        // Clip was deleted or has no audio
+        m_done = true;
+        return false;
+    }
+    m_stream = m_binClip->audioInfo()->audio_index();
+    m_cachePath = m_binClip->getSpectrogramPath(m_stream);
+    if (m_cachePath.isEmpty()) {
+        m_done = true;
+        return false;
+    }
+    if (QFile::exists(m_cachePath)) {
+        m_successful = m_done = true;
+        return true;
+    }
+    std::shared_ptr<Mlt::Producer> prod = m_binClip->originalProducer();
+    if ((prod == nullptr) || !prod->is_valid()) {
+        m_errorMessage.append(i18n("Spectrogram: cannot open project file %1", m_binClip->url()));
+        m_done = true;
+        return false;
+    }
+    m_length = prod->get_length();
+    if (m_length <= 0 || m_length == INT_MAX) {
+        // This is a broken file or live feed
+        m_done = true;
+        return false;
+    }
+    m_service = prod->get("mlt_service");
+    if (m_service == QLatin1String("avformat-novalidate")) {
+        m_service = QStringLiteral("avformat");
+    } else if (m_service.startsWith(QLatin1String("xml"))) {
+        m_service = QStringLiteral("xml-nogl");
+    }
+    m_resource = prod->get("resource");
+    m_frequency = m_binClip->audioInfo()->samplingRate();
+    m_frequency = m_frequency <= 0 ? 48000 : m_frequency;
+    m_channels = m_binClip->audioInfo()->channelsForStream(m_stream);
+    m_channels = m_channels <= 0 ? 2 : m_channels;
+    m_columns = qMin(m_length, maxColumns);
+
+    connect(this, &SpectrogramJob::jobCanceled, this, [this]() { m_canceled.storeRelease(1); }, Qt::DirectConnection);
+    int ranges = qBound(1, m_columns / 64, QThread::idealThreadCount());
+    // The ranges run in a pool owned by the job, so that waiting for them does not block the global pool
+    QThreadPool rangePool;
+    rangePool.setMaxThreadCount(ranges);
+    QList<QFuture<QVector<float>>> futures;
+    for (int i = 0; i < ranges; i++) {
+        int first = m_columns * i / ranges;
+        int last = m_columns * (i + 1) / ranges;
+        futures << QtConcurrent::run(&rangePool, this, &SpectrogramJob::analyseRange, first, last);
+    }
+    int lastProgress = -1;
+    while (!rangePool.waitForDone(200)) {
+        int progress = int(100 * qint64(m_processedFrames.loadAcquire()) / m_length);
+        if (progress != lastProgress) {
+            lastProgress = progress;
+            emit jobProgress(progress);
+        }
+    }
+    const int bins = windowSize / 2;
+    m_spectrogram = QImage(m_columns, bins, QImage::Format_Indexed8);
+    m_spectrogram.setColorTable(Spectrogram::colorMap());
+    int column = 0;
+    bool ok = true;
+    for (int i = 0; i < futures.count(); i++) {
+        const QVector<float> spectra = futures[i].result();
+        const int last = m_columns * (i + 1) / ranges;
+        if (spectra.size() != (last - column) * bins) {
+            ok = false;
+            continue;
+        }
+        for (int j = 0; column < last; ++column, ++j) {
+            for (int bin = 0; bin < bins; ++bin) {
+                // Normalize the dB value, low frequencies at the bottom
+                float val = (spectra.at(j * bins + bin) - SPECTROGRAM_MIN_DB) / (SPECTROGRAM_MAX_DB - SPECTROGRAM_MIN_DB);
+                m_spectrogram.scanLine(bins - 1 - bin)[column] = uchar(qBound(0, int(val * 255), 255));
+            }
+        }
+    }
+    m_done = true;
+    if (!ok || m_canceled.loadAcquire() != 0) {
+        m_spectrogram = QImage();
+        return false;
+    }
+    if (!m_spectrogram.save(m_cachePath)) {
+        m_errorMessage.append(i18n("Spectrogram: cannot write cache file %1", m_cachePath));
+        return false;
+    }
+    m_successful = true;
+    return true;
+}
+
+QVector<float> SpectrogramJob::analyseRange(int firstColumn, int lastColumn)
+{
+    const int bins = windowSize / 2;
+    QVector<float> spectra((lastColumn - firstColumn) * bins, float(SPECTROGRAM_MIN_DB));
+    // Each thread needs its own profile and producer
+    auto &projectProfile = pCore->getCurrentProfile();
+    Mlt::Profile profile;
+    profile.set_frame_rate(projectProfile->frame_rate_num(), projectProfile->frame_rate_den());
+    Mlt::Producer producer(profile, m_service.toUtf8().constData(), m_resource.toUtf8().constData());
+    if (!producer.is_valid()) {
+        return {};
+    }
+    producer.set("video_index", -1);
+    producer.set("audio_index", m_stream);
+    const double fps = profile.fps();
+    // The configuration cache of FFTTools is not thread safe
+    FFTTools fftTools;
+    audioShortVector window(windowSize);
+    int windowFill = 0;
+    QVector<float> spectrum(bins);
+    QVector<double> sum(bins);
+    const int start = int(qint64(m_length) * firstColumn / m_columns);
+    const int end = int(qint64(m_length) * lastColumn / m_columns);
+    producer.seek(start);
+    int column = firstColumn;
+    int windows = 0;
+    // Store the average spectrum of a column
+    auto storeColumn = [&](int col) {
+        float *target = spectra.data() + (col - firstColumn) * bins;
+        if (windows > 0) {
+            for (int bin = 0; bin < bins; ++bin) {
+                target[bin] = float(sum.at(bin) / windows);
+            }
+        } else if (col > firstColumn) {
+            // Very short columns may not contain a whole window, repeat the previous one
+            std::copy(target - bins, target, target);
+        }
+    };
+    for (int pos = start; pos < end; pos++) {
+        if (m_canceled.loadAcquire() != 0) {
+            return {};
+        }
+        int frameColumn = int(qint64(pos) * m_columns / m_length);
+        if (frameColumn != column) {
+            storeColumn(column);
+            sum.fill(0.);
+            windows = 0;
+            column = frameColumn;
+        }
+        std::unique_ptr<Mlt::Frame> frame(producer.get_frame());
+        if (frame && frame->is_valid() && frame->get_int("test_audio") == 0) {
+            mlt_audio_format format = mlt_audio_s16;
+            int frequency = m_frequency;
+            int channels = m_channels;
+            int samples = mlt_sample_calculator(float(fps), m_frequency, pos);
+            const auto *audio = static_cast<const qint16 *>(frame->get_audio(format, frequency, channels, samples));
+            for (int i = 0; audio != nullptr && i < samples; ++i) {
+                // Mix the channels
+                int mono = 0;
+                for (int c = 0; c < channels; ++c) {
+                    mono += audio[i * channels + c];
+                }
+                window[windowFill++] = qint16(mono / channels);
+                if (windowFill == windowSize) {
+                    fftTools.fftNormalized(window, 0, 1, spectrum.data(), FFTTools::Window_Hamming, uint(windowSize), 0);
+                    for (int bin = 0; bin < bins; ++bin) {
+                        sum[bin] += double(spectrum.at(bin));
+                    }
+                    windows++;
+                    // Windows overlap by half
+                    std::copy(window.constBegin() + bins, window.constEnd(), window.begin());
+                    windowFill = bins;
+                }
+            }
+        }
+        m_processedFrames.fetchAndAddRelaxed(1);
+    }
+    storeColumn(column);
+    return spectra;
+}
+
+bool SpectrogramJob::commitResult(Fun &undo, Fun &redo)
+{
+    Q_ASSERT(!m_resultConsumed);
+    if (!m_done) {
+        qDebug() << "ERROR: Trying to consume invalid results";
+        return false;
+    }
+    m_resultConsumed = true;
+    if (!m_successful) {
+        return false;
+    }
+    auto operation = [clip = m_binClip]() {
+        emit clip->spectrogramReady();
+        return true;
+    };
+    bool ok = operation();
+    if (ok) {
+        UPDATE_UNDO_REDO_NOLOCK(operation, operation, undo, redo);
+    }
+    return ok;
+}
@@ -0,0 +1,76 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include "abstractclipjob.h"
+
+#include <QAtomicInt>
+#include <QImage>
+#include <QVector>
+#include <memory>
+
+/**
+ * @class SpectrogramJob
+ * @brief Computes the spectrogram of a whole clip, displayed in the clip monitor
+ *
+ * The clip is split in several time ranges, each decoded and Fourier transformed in its own
+ * thread. Each column of the resulting image is the average spectrum of the audio it covers.
+ * The image is cached next to the audio thumbnails.
+ */
+
+class ProjectClip;
+class SpectrogramJob : public AbstractClipJob
+{
+    Q_OBJECT
+
+public:
+    SpectrogramJob(const QString &binId);
+
+    const QString getDescription() const override;
+    bool startJob() override;
+    bool commitResult(Fun &undo, Fun &redo) override;
+
+    /* @brief Maximum width of the spectrogram image, one column is computed per frame for shorter clips */
+    static const int maxColumns = 8192;
+    /* @brief Size of the Fourier transform window, in samples. The image height is half of it */
+    static const int windowSize = 1024;
+
+protected:
+    /** @brief Compute the average spectra of the columns [firstColumn, lastColumn[
+        @return (lastColumn - firstColumn) * windowSize / 2 values in dB, or an empty vector on failure */
+    QVector<float> analyseRange(int firstColumn, int lastColumn);
+
+private:
+    std::shared_ptr<ProjectClip> m_binClip;
+    QString m_service;
+    QString m_resource;
+    QString m_cachePath;
+    int m_stream;
+    int m_frequency;
+    int m_channels;
+    int m_length;
+    int m_columns;
+    QAtomicInt m_processedFrames;
+    QAtomicInt m_canceled;
+    QImage m_spectrogram;
+    bool m_done{false}, m_successful{false};
+};
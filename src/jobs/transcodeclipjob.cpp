@@ -28,17 +28,14 @@
 #include "kdenlive_debug.h"
 #include "kdenlivesettings.h"
 #include "macros.hpp"
+#include "processrunner.hpp"
 
-#include <QProcess>
 #include <QThread>
 
 #include <klocalizedstring.h>
 
 TranscodeJob::TranscodeJob(const QString &binId, QString params)
     : AbstractClipJob(TRANSCODEJOB, binId)
-    , m_jobDuration(0)
-    , m_isFfmpegJob(true)
-    , m_jobProcess(nullptr)
     , m_done(false)
     , m_transcodeParams(params)
 {
@@ -77,10 +74,14 @@ bool TranscodeJob::startJob()
         m_destUrl.append(QString::number(fileCount).rightJustified(4, '0', false));
     }
 
-    bool result;
+    // The encoder writes to a temporary file that is renamed once complete
+    const QString partialUrl = ProcessRunner::partialPath(m_destUrl);
+    QString program;
+    QStringList arguments;
+    ProcessRunner::Tool tool = ProcessRunner::FFmpeg;
     if (type == ClipType::Playlist || type == ClipType::SlideShow) {
         // change FFmpeg params to MLT format
-        m_isFfmpegJob = false;
+        tool = ProcessRunner::Melt;
         // insert transcoded filename
         m_transcodeParams.replace(QStringLiteral("%1"), QString("-consumer %1"));
         // Convert param style
@@ -97,7 +98,7 @@ bool TranscodeJob::startJob()
             } else {
                 if (t.contains(QLatin1String("%1"))) {
                     // file name
-                    mltParameters.prepend(t.section(QLatin1Char(' '), 1).replace(QLatin1String("%1"), QString("avformat:%1").arg(m_destUrl)));
+                    mltParameters.prepend(t.section(QLatin1Char(' '), 1).replace(QLatin1String("%1"), QString("avformat:%1").arg(partialUrl)));
                     mltParameters.prepend(QStringLiteral("-consumer"));
                     continue;
                 }
@@ -127,15 +128,9 @@ bool TranscodeJob::startJob()
             mltParameters.prepend(QString("in=%1").arg(m_inPoint));
         }
         mltParameters.prepend(source);
-        m_jobProcess = new QProcess;
-        // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-        connect(this, &TranscodeJob::jobCanceled, m_jobProcess, &QProcess::kill, Qt::DirectConnection);
-        connect(m_jobProcess, &QProcess::readyReadStandardError, this, &TranscodeJob::processLogInfo);
-        m_jobProcess->start(KdenliveSettings::rendererpath(), mltParameters);
-        m_jobProcess->waitForFinished(-1);
-        result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+        program = KdenliveSettings::rendererpath();
+        arguments = mltParameters;
     } else {
-        m_isFfmpegJob = true;
         QStringList parameters;
         if (KdenliveSettings::ffmpegpath().isEmpty()) {
             // FFmpeg not detected, cannot process the Job
@@ -143,12 +138,11 @@ bool TranscodeJob::startJob()
             m_done = true;
             return false;
         }
-        m_jobDuration = (int)binClip->duration().seconds();
         parameters << QStringLiteral("-y");
         if (m_inPoint > -1) {
             parameters << QStringLiteral("-ss") << QString::number(GenTime(m_inPoint, pCore->getCurrentFps()).seconds());
         }
-        parameters << QStringLiteral("-stats") << QStringLiteral("-i") << source;
+        parameters << QStringLiteral("-i") << source;
         if (m_outPoint > -1) {
             parameters << QStringLiteral("-to") << QString::number(GenTime(m_outPoint - m_inPoint, pCore->getCurrentFps()).seconds());
         }
@@ -159,81 +153,31 @@ bool TranscodeJob::startJob()
         for (const QString &s : qAsConst(params)) {
             QString t = s.simplified();
             if (t.startsWith(QLatin1String("%1"))) {
-                parameters << t.replace(QLatin1String("%1"), m_destUrl);
+                parameters << t.replace(QLatin1String("%1"), partialUrl);
             } else {
                 parameters << t;
             }
         }
         qDebug()<<"/// FULL PROXY PARAMS:\n"<<parameters<<"\n------";
-        m_jobProcess = new QProcess;
-        // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-        connect(m_jobProcess, &QProcess::readyReadStandardError, this, &TranscodeJob::processLogInfo);
-        connect(this, &TranscodeJob::jobCanceled, m_jobProcess, &QProcess::kill, Qt::DirectConnection);
-        m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
-        m_jobProcess->waitForFinished(-1);
-        result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+        program = KdenliveSettings::ffmpegpath();
+        arguments = parameters;
     }
     m_destUrl.append(transcoderExt);
-    // remove temporary playlist if it exists
-    if (result) {
-        if (QFileInfo(m_destUrl).size() == 0) {
-            QFile::remove(m_destUrl);
-            // File was not created
-            m_done = false;
-            m_errorMessage.append(i18n("Failed to create file."));
-        } else {
-            m_done = true;
-        }
+    ProcessRunner runner(tool, m_destUrl);
+    if (m_inPoint > -1 && m_outPoint > -1) {
+        runner.setDuration(GenTime(m_outPoint - m_inPoint, pCore->getCurrentFps()).seconds());
     } else {
-        // Proxy process crashed
-        QFile::remove(m_destUrl);
-        m_done = false;
-        m_errorMessage.append(QString::fromUtf8(m_jobProcess->readAll()));
+        runner.setDuration(binClip->duration().seconds());
     }
-    m_jobProcess->deleteLater();
-    return result;
-}
-
-void TranscodeJob::processLogInfo()
-{
-    const QString buffer = QString::fromUtf8(m_jobProcess->readAllStandardError());
-    m_logDetails.append(buffer);
-    int progress = 0;
-    if (m_isFfmpegJob) {
-        // Parse FFmpeg output
-        if (m_jobDuration == 0) {
-            if (buffer.contains(QLatin1String("Duration:"))) {
-                QString data = buffer.section(QStringLiteral("Duration:"), 1, 1).section(QLatin1Char(','), 0, 0).simplified();
-                if (!data.isEmpty()) {
-                    QStringList numbers = data.split(QLatin1Char(':'));
-                    if (numbers.size() < 3) {
-                        return;
-                    }
-                    m_jobDuration = (int)(numbers.at(0).toInt() * 3600 + numbers.at(1).toInt() * 60 + numbers.at(2).toDouble());
-                }
-            }
-        } else if (buffer.contains(QLatin1String("time="))) {
-            QString time = buffer.section(QStringLiteral("time="), 1, 1).simplified().section(QLatin1Char(' '), 0, 0);
-            if (!time.isEmpty()) {
-                QStringList numbers = time.split(QLatin1Char(':'));
-                if (numbers.size() < 3) {
-                    progress = (int)time.toDouble();
-                    if (progress == 0) {
-                        return;
-                    }
-                } else {
-                    progress = numbers.at(0).toInt() * 3600 + numbers.at(1).toInt() * 60 + numbers.at(2).toDouble();
-                }
-            }
-            emit jobProgress((int)(100.0 * progress / m_jobDuration));
-        }
-    } else {
-        // Parse MLT output
-        if (buffer.contains(QLatin1String("percentage:"))) {
-            progress = buffer.section(QStringLiteral("percentage:"), 1).simplified().section(QLatin1Char(' '), 0, 0).toInt();
-            emit jobProgress(progress);
-        }
+    runner.connectJob(this);
+    bool result = runner.run(program, arguments);
+    m_logDetails.append(runner.log());
+    m_done = result;
+    if (!result && !runner.isCanceled()) {
+        // Transcoding process crashed or the file was not created
+        m_errorMessage.append(i18n("Failed to create file."));
     }
+    return result;
 }
 
 bool TranscodeJob::commitResult(Fun &undo, Fun &redo)
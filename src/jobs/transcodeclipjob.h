@@ -23,8 +23,6 @@
 
 #include "abstractclipjob.h"
 
-class QProcess;
-
 class TranscodeJob : public AbstractClipJob
 {
     Q_OBJECT
@@ -37,13 +35,7 @@ public:
     By design, the job should store the result of the computation but not share it with the rest of the code. This happens when we call commitResult */
     bool commitResult(Fun &undo, Fun &redo) override;
 
-private slots:
-    void processLogInfo();
-
 private:
-    int m_jobDuration;
-    bool m_isFfmpegJob;
-    QProcess *m_jobProcess;
     bool m_done;
     QString m_destUrl;
     QString m_transcodeParams;
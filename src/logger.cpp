@@ -25,6 +25,8 @@
 #include "timeline2/model/timelineitemmodel.hpp"
 #include "timeline2/model/timelinemodel.hpp"
 #include <QString>
+#include <algorithm>
+#include <csignal>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -39,18 +41,21 @@
 #pragma GCC diagnostic pop
 
 thread_local bool Logger::is_executing = false;
+thread_local uint64_t Logger::result_awaiting = 0;
+std::atomic<bool> Logger::enabled{true};
+std::atomic<size_t> Logger::capacity{0};
+std::atomic<uint64_t> Logger::sequence{0};
 std::mutex Logger::mut;
-std::vector<rttr::variant> Logger::operations;
-std::vector<Logger::Invok> Logger::invoks;
-std::unordered_map<std::string, std::vector<Logger::Constr>> Logger::constr;
+std::vector<std::shared_ptr<Logger::ThreadBuffer>> Logger::buffers;
+std::vector<rttr::variant> Logger::timelines;
 std::unordered_map<std::string, std::string> Logger::translation_table;
 std::unordered_map<std::string, std::string> Logger::back_translation_table;
 int Logger::dump_count = 0;
+std::string Logger::dump_directory;
 
-thread_local size_t Logger::result_awaiting = INT_MAX;
-
-void Logger::init()
+void Logger::init(size_t maxOperations)
 {
+    capacity = maxOperations;
     std::string cur_ind = "a";
     auto incr_ind = [&](auto &&self, size_t i = 0) {
         if (i >= cur_ind.size()) {
@@ -91,9 +96,14 @@ void Logger::init()
     }
 }
 
+void Logger::setEnabled(bool enable)
+{
+    enabled = enable;
+}
+
 bool Logger::start_logging()
 {
-    std::unique_lock<std::mutex> lk(mut);
+    // is_executing is per thread, no lock needed
     if (is_executing) {
         return false;
     }
@@ -102,9 +112,59 @@ bool Logger::start_logging()
 }
 void Logger::stop_logging()
 {
-    std::unique_lock<std::mutex> lk(mut);
     is_executing = false;
 }
+
+Logger::ThreadBuffer &Logger::buffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> local;
+    if (!local) {
+        local = std::make_shared<ThreadBuffer>();
+        // The buffer outlives the thread so that its operations can still be dumped
+        std::unique_lock<std::mutex> lk(mut);
+        buffers.push_back(local);
+    }
+    return *local;
+}
+
+void Logger::push(Operation &&op)
+{
+    op.seq = ++sequence;
+    if (op.kind == Operation::Kind::Invok) {
+        result_awaiting = op.seq;
+    }
+    ThreadBuffer &buf = buffer();
+    const size_t max = capacity.load(std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lk(buf.mut);
+    if (op.kind == Operation::Kind::Constr) {
+        buf.constructions.push_back(std::move(op));
+    } else if (max == 0 || buf.operations.size() < max) {
+        buf.operations.push_back(std::move(op));
+    } else {
+        // Ring buffer is full, overwrite the oldest operation
+        buf.operations[buf.head] = std::move(op);
+        buf.head = (buf.head + 1) % buf.operations.size();
+        buf.dropped++;
+    }
+}
+
+void Logger::unwrap_args(std::vector<rttr::variant> &args)
+{
+    for (auto &a : args) {
+        // this will rewove shared/weak/unique ptrs
+        if (a.get_type().is_wrapper()) {
+            a = a.extract_wrapped_value();
+        }
+    }
+}
+
+size_t Logger::register_timeline(const rttr::variant &ptr)
+{
+    std::unique_lock<std::mutex> lk(mut);
+    timelines.push_back(ptr);
+    return timelines.size() - 1;
+}
+
 std::string Logger::get_ptr_name(const rttr::variant &ptr)
 {
     if (ptr.can_convert<TimelineModel *>()) {
@@ -121,23 +181,31 @@ std::string Logger::get_ptr_name(const rttr::variant &ptr)
 
 void Logger::log_res(rttr::variant result)
 {
-    std::unique_lock<std::mutex> lk(mut);
-    Q_ASSERT(result_awaiting < invoks.size());
-    invoks[result_awaiting].res = std::move(result);
+    ThreadBuffer &buf = buffer();
+    std::unique_lock<std::mutex> lk(buf.mut);
+    if (buf.operations.empty()) {
+        return;
+    }
+    // The awaiting invocation is the last one recorded by this thread
+    size_t last = (buf.head + buf.operations.size() - 1) % buf.operations.size();
+    Q_ASSERT(buf.operations[last].seq == result_awaiting);
+    if (buf.operations[last].seq == result_awaiting) {
+        buf.operations[last].res = std::move(result);
+    }
 }
 
 void Logger::log_create_producer(const std::string &type, std::vector<rttr::variant> args)
 {
-    std::unique_lock<std::mutex> lk(mut);
-    for (auto &a : args) {
-        // this will rewove shared/weak/unique ptrs
-        if (a.get_type().is_wrapper()) {
-            a = a.extract_wrapped_value();
-        }
-        const std::string class_name = a.get_type().get_name().to_string();
+    if (!isEnabled()) {
+        return;
     }
-    constr[type].push_back({type, std::move(args)});
-    operations.emplace_back(ConstrId{type, constr[type].size() - 1});
+    unwrap_args(args);
+    Operation op;
+    op.kind = Operation::Kind::Constr;
+    op.name = type;
+    op.ptr = type;
+    op.args = std::move(args);
+    push(std::move(op));
 }
 
 namespace {
@@ -165,7 +233,18 @@ std::string quoted(const std::string &input)
 
 void Logger::print_trace()
 {
-    dump_count++;
+    dump_trace(false);
+}
+
+bool Logger::dump_trace(bool nonBlocking)
+{
+    // The lock is kept for the whole dump, the names of the timelines are looked up while writing
+    std::unique_lock<std::mutex> lk(mut, std::defer_lock);
+    if (!nonBlocking) {
+        lk.lock();
+    } else if (!lk.try_lock()) {
+        return false;
+    }
     auto process_args = [&](const std::vector<rttr::variant> &args, const std::unordered_set<size_t> &refs = {}) {
         std::stringstream ss;
         bool deb = true;
@@ -282,10 +361,35 @@ void Logger::print_trace()
         }
         return ss.str();
     };
+    // Gather the operations of all threads in call order
+    std::vector<Operation> operations;
+    size_t dropped = 0;
+    for (const auto &buf : buffers) {
+        std::unique_lock<std::mutex> bufLock(buf->mut, std::defer_lock);
+        if (!nonBlocking) {
+            bufLock.lock();
+        } else if (!bufLock.try_lock()) {
+            // The crash happened while this buffer was being modified
+            return false;
+        }
+        operations.insert(operations.end(), buf->constructions.begin(), buf->constructions.end());
+        for (size_t i = 0; i < buf->operations.size(); ++i) {
+            operations.push_back(buf->operations[(buf->head + i) % buf->operations.size()]);
+        }
+        dropped += buf->dropped;
+    }
+    dump_count++;
+    std::sort(operations.begin(), operations.end(), [](const Operation &a, const Operation &b) { return a.seq < b.seq; });
+
     std::ofstream fuzz_file;
-    fuzz_file.open("fuzz_case_" + std::to_string(dump_count) + ".txt");
+    fuzz_file.open(dump_directory + "fuzz_case_" + std::to_string(dump_count) + ".txt");
     std::ofstream test_file;
-    test_file.open("test_case_" + std::to_string(dump_count) + ".cpp");
+    test_file.open(dump_directory + "test_case_" + std::to_string(dump_count) + ".cpp");
+    if (dropped > 0) {
+        // Results of the replayed calls may differ from the recorded ones, since the state they started from is incomplete
+        test_file << "// " << dropped << " older operations were dropped, only the constructions and the newest operations are replayed" << std::endl;
+    }
+    const char *checkResult = dropped > 0 ? "CHECK_NOFAIL" : "REQUIRE";
     test_file << "TEST_CASE(\"Regression\") {" << std::endl;
     test_file << "auto binModel = pCore->projectItemModel();" << std::endl;
     test_file << "binModel->clean();" << std::endl;
@@ -306,28 +410,26 @@ void Logger::print_trace()
     };
     for (const auto &o : operations) {
         bool isUndo = false;
-        if (o.can_convert<Logger::Undo>()) {
+        if (o.kind == Operation::Kind::Undo) {
             isUndo = true;
-            Undo undo = o.convert<Logger::Undo>();
-            if (undo.undo) {
+            if (o.undo) {
                 test_file << "undoStack->undo();" << std::endl;
                 fuzz_file << "u" << std::endl;
             } else {
                 test_file << "undoStack->redo();" << std::endl;
                 fuzz_file << "r" << std::endl;
             }
-        } else if (o.can_convert<Logger::InvokId>()) {
-            InvokId id = o.convert<Logger::InvokId>();
-            Invok &invok = invoks[id.id];
+        } else if (o.kind == Operation::Kind::Invok) {
+            const Operation &invok = o;
             std::unordered_set<size_t> refs;
             bool is_static = false;
-            rttr::method m = invok.ptr.get_type().get_method(invok.method);
+            rttr::method m = invok.ptr.get_type().get_method(invok.name);
             if (!m.is_valid()) {
                 is_static = true;
-                m = rttr::type::get_by_name("TimelineFunctions").get_method(invok.method);
+                m = rttr::type::get_by_name("TimelineFunctions").get_method(invok.name);
             }
             if (!m.is_valid()) {
-                std::cout << "ERROR: unknown method " << invok.method << std::endl;
+                std::cout << "ERROR: unknown method " << invok.name << std::endl;
                 continue;
             }
             test_file << "{" << std::endl;
@@ -342,17 +444,17 @@ void Logger::print_trace()
                 test_file << m.get_return_type().get_name().to_string() << " res = ";
             }
             if (is_static) {
-                test_file << "TimelineFunctions::" << invok.method << "(" << get_ptr_name(invok.ptr) << ", " << process_args(invok.args, refs) << ");"
+                test_file << "TimelineFunctions::" << invok.name << "(" << get_ptr_name(invok.ptr) << ", " << process_args(invok.args, refs) << ");"
                           << std::endl;
             } else {
-                test_file << get_ptr_name(invok.ptr) << "->" << invok.method << "(" << process_args(invok.args, refs) << ");" << std::endl;
+                test_file << get_ptr_name(invok.ptr) << "->" << invok.name << "(" << process_args(invok.args, refs) << ");" << std::endl;
             }
             if (m.get_return_type() != rttr::type::get<void>() && invok.res.is_valid()) {
-                test_file << "REQUIRE( res == " << invok.res.to_string() << ");" << std::endl;
+                test_file << checkResult << "( res == " << invok.res.to_string() << ");" << std::endl;
             }
             test_file << "}" << std::endl;
 
-            std::string invok_name = invok.method;
+            std::string invok_name = invok.name;
             if (translation_table.count(invok_name) > 0) {
                 auto args = invok.args;
                 if (rttr::type::get<TimelineModel>().get_method(invok_name).is_valid() ||
@@ -370,35 +472,34 @@ void Logger::print_trace()
                 std::cout << "ERROR: unknown method " << invok_name << std::endl;
             }
 
-        } else if (o.can_convert<Logger::ConstrId>()) {
-            ConstrId id = o.convert<Logger::ConstrId>();
-            std::string constr_name = std::string("constr_") + id.type;
+        } else if (o.kind == Operation::Kind::Constr) {
+            std::string constr_name = std::string("constr_") + o.name;
             if (translation_table.count(constr_name) > 0) {
-                fuzz_file << translation_table[constr_name] << " " << process_args_fuzz(constr[id.type][id.id].second) << std::endl;
+                fuzz_file << translation_table[constr_name] << " " << process_args_fuzz(o.args) << std::endl;
             } else {
                 std::cout << "ERROR: unknown constructor " << constr_name << std::endl;
             }
-            if (id.type == "TimelineModel") {
-                test_file << "TimelineItemModel tim_" << id.id << "(&reg_profile, undoStack);" << std::endl;
-                test_file << "Mock<TimelineItemModel> timMock_" << id.id << "(tim_" << id.id << ");" << std::endl;
-                test_file << "auto timeline_" << id.id << " = std::shared_ptr<TimelineItemModel>(&timMock_" << id.id << ".get(), [](...) {});" << std::endl;
-                test_file << "TimelineItemModel::finishConstruct(timeline_" << id.id << ", guideModel);" << std::endl;
-                test_file << "Fake(Method(timMock_" << id.id << ", adjustAssetRange));" << std::endl;
+            if (o.name == "TimelineModel") {
+                test_file << "TimelineItemModel tim_" << o.id << "(&reg_profile, undoStack);" << std::endl;
+                test_file << "Mock<TimelineItemModel> timMock_" << o.id << "(tim_" << o.id << ");" << std::endl;
+                test_file << "auto timeline_" << o.id << " = std::shared_ptr<TimelineItemModel>(&timMock_" << o.id << ".get(), [](...) {});" << std::endl;
+                test_file << "TimelineItemModel::finishConstruct(timeline_" << o.id << ", guideModel);" << std::endl;
+                test_file << "Fake(Method(timMock_" << o.id << ", adjustAssetRange));" << std::endl;
                 nbrConstructedTimelines++;
-            } else if (id.type == "TrackModel") {
-                std::string params = process_args(constr[id.type][id.id].second);
+            } else if (o.name == "TrackModel") {
+                std::string params = process_args(o.args);
                 test_file << "TrackModel::construct(" << params << ");" << std::endl;
-            } else if (id.type == "ClipModel") {
-                std::string params = process_args(constr[id.type][id.id].second);
+            } else if (o.name == "ClipModel") {
+                std::string params = process_args(o.args);
                 test_file << "ClipModel::construct(" << params << ");" << std::endl;
-            } else if (id.type == "test_producer") {
-                std::string params = process_args(constr[id.type][id.id].second);
+            } else if (o.name == "test_producer") {
+                std::string params = process_args(o.args);
                 test_file << "createProducer(reg_profile, " << params << ");" << std::endl;
-            } else if (id.type == "test_producer_sound") {
-                std::string params = process_args(constr[id.type][id.id].second);
+            } else if (o.name == "test_producer_sound") {
+                std::string params = process_args(o.args);
                 test_file << "createProducerWithSound(reg_profile, " << params << ");" << std::endl;
             } else {
-                std::cout << "Error: unknown constructor " << id.type << std::endl;
+                std::cout << "Error: unknown constructor " << o.name << std::endl;
             }
         } else {
             std::cout << "Error: unknown operation" << std::endl;
@@ -414,18 +515,63 @@ void Logger::print_trace()
     test_file << "}" << std::endl;
     test_file << "pCore->m_projectManager = nullptr;" << std::endl;
     test_file << "}" << std::endl;
+    return true;
 }
 void Logger::clear()
 {
     is_executing = false;
-    invoks.clear();
-    operations.clear();
-    constr.clear();
+    std::unique_lock<std::mutex> lk(mut);
+    for (const auto &buf : buffers) {
+        std::unique_lock<std::mutex> bufLock(buf->mut);
+        buf->operations.clear();
+        buf->head = 0;
+        buf->dropped = 0;
+        buf->constructions.clear();
+    }
+    // Forget the buffers of finished threads
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const std::shared_ptr<ThreadBuffer> &buf) { return buf.use_count() == 1; }),
+                  buffers.end());
+    timelines.clear();
+}
+
+namespace {
+std::atomic<bool> crashDumped{false};
+void (*previousHandlers[4])(int) = {SIG_DFL, SIG_DFL, SIG_DFL, SIG_DFL};
+const int crashSignals[4] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL};
+
+void dumpOnCrash(int sig)
+{
+    if (!crashDumped.exchange(true)) {
+        // Not async signal safe, but the process is going down anyway and the trace is what we want.
+        // The dump is skipped rather than waiting on a lock that the crashed code may hold
+        Logger::setEnabled(false);
+        Logger::dump_trace(true);
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (crashSignals[i] == sig) {
+            // Let the previous handler (usually the crash reporter) run
+            std::signal(sig, previousHandlers[i] == SIG_ERR ? SIG_DFL : previousHandlers[i]);
+            break;
+        }
+    }
+    std::raise(sig);
+}
+} // namespace
+
+void Logger::installCrashHandler(const std::string &directory)
+{
+    dump_directory = directory;
+    if (!dump_directory.empty() && dump_directory.back() != '/') {
+        dump_directory += '/';
+    }
+    for (int i = 0; i < 4; ++i) {
+        previousHandlers[i] = std::signal(crashSignals[i], dumpOnCrash);
+    }
 }
 
 LogGuard::LogGuard()
 {
-    m_hasGuard = Logger::start_logging();
+    m_hasGuard = Logger::isEnabled() && Logger::start_logging();
 }
 LogGuard::~LogGuard()
 {
@@ -440,7 +586,11 @@ bool LogGuard::hasGuard() const
 
 void Logger::log_undo(bool undo)
 {
-    Logger::Undo u;
-    u.undo = undo;
-    operations.push_back(u);
+    if (!isEnabled()) {
+        return;
+    }
+    Operation op;
+    op.kind = Operation::Kind::Undo;
+    op.undo = undo;
+    push(std::move(op));
 }
@@ -20,11 +20,13 @@
  ***************************************************************************/
 
 #pragma once
+#include <atomic>
 #include <climits>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -38,12 +40,27 @@
 /** @brief This class is meant to provide an easy way to reproduce bugs involving the model.
  * The idea is to log any modifier function involving a model class, and trace the parameters that were passed, to be able to generate a test-case producing the
  * same behaviour. Note that many modifier functions of the models are nested. We are only interested in the top-most call, and we must ignore bottom calls.
+ * Each thread records into its own buffer, so logging never waits on another thread. When a capacity is set, each buffer only keeps the most recent
+ * operations. Tracing can be switched off at runtime with setEnabled(), or removed at compile time by defining NO_MODEL_TRACING.
  */
 class Logger
 {
 public:
-    /// @brief Inits the logger. Must be called at startup
-    static void init();
+    /** @brief Inits the logger. Must be called at startup
+     * @param capacity the maximum number of operations kept per thread, 0 to keep everything
+     */
+    static void init(size_t capacity = 0);
+
+    /// @brief Enable or disable the recording of new operations
+    static void setEnabled(bool enable);
+    static bool isEnabled()
+    {
+#ifdef NO_MODEL_TRACING
+        return false;
+#else
+        return enabled.load(std::memory_order_relaxed);
+#endif
+    }
 
     /** @brief Notify the logger that the current thread wants to start logging.
      * This function returns true if this is a top-level call, meaning that we indeed want to log it. If the function returns false, the  caller must not log.
@@ -68,7 +85,17 @@ public:
 
     /// @brief Notify that we are done with our function. Must not be called if start_logging returned false.
     static void stop_logging();
+    /// @brief Writes the recorded operations of all threads, in call order, as a test case and a fuzzer input
     static void print_trace();
+    /** @brief Same as print_trace
+     * @param nonBlocking if true, nothing is written when a lock is held, since a crash handler cannot wait for the interrupted code
+     * @return false if the trace was not written
+     */
+    static bool dump_trace(bool nonBlocking);
+    /** @brief Dump the recorded operations when the application crashes
+     * @param directory is where the test case and fuzzer input are written
+     */
+    static void installCrashHandler(const std::string &directory);
 
     /// @brief Resets the current log
     static void clear();
@@ -79,36 +106,51 @@ public:
 protected:
     /** @brief Look amongst the known instances to get the name of a given pointer */
     static std::string get_ptr_name(const rttr::variant &ptr);
+    /** @brief Index of a registered timeline, the caller must hold mut */
     template <typename T> static size_t get_id_from_ptr(T *ptr);
-    struct InvokId
-    {
-        size_t id;
-    };
-    struct ConstrId
-    {
-        std::string type;
-        size_t id;
-    };
-    struct Undo
-    {
-        bool undo;
-    };
-    // a construction log contains the pointer as first parameter, and the vector of parameters
-    using Constr = std::pair<rttr::variant, std::vector<rttr::variant>>;
-    struct Invok
+    /** @brief Remember a constructed timeline so that later calls can refer to it, returns its index */
+    static size_t register_timeline(const rttr::variant &ptr);
+    static void unwrap_args(std::vector<rttr::variant> &args);
+    struct Operation
     {
+        enum class Kind { Constr, Invok, Undo };
+        Kind kind;
+        // global order of the operation, used to interleave the buffers of different threads
+        uint64_t seq = 0;
+        // class name for a construction, method name for an invocation
+        std::string name;
         rttr::variant ptr;
-        std::string method;
         std::vector<rttr::variant> args;
         rttr::variant res;
+        bool undo = false;
+        // for a timeline construction, its index amongst the timelines
+        size_t id = 0;
+    };
+    /** @brief Operations recorded by one thread. The mutex is only contended while dumping or clearing */
+    struct ThreadBuffer
+    {
+        std::mutex mut;
+        std::vector<Operation> operations;
+        // index of the oldest operation once the buffer is full
+        size_t head = 0;
+        // number of operations overwritten in the ring
+        size_t dropped = 0;
+        // constructions are never dropped, later operations refer to the constructed objects
+        std::vector<Operation> constructions;
     };
+    static ThreadBuffer &buffer();
+    static void push(Operation &&op);
     thread_local static bool is_executing;
-    thread_local static size_t result_awaiting;
+    thread_local static uint64_t result_awaiting;
+    static std::atomic<bool> enabled;
+    static std::atomic<size_t> capacity;
+    static std::atomic<uint64_t> sequence;
+    /// @brief Protects the buffer list and the timelines, which are rarely modified
     static std::mutex mut;
-    static std::vector<rttr::variant> operations;
-    static std::unordered_map<std::string, std::vector<Constr>> constr;
-    static std::vector<Invok> invoks;
+    static std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    static std::vector<rttr::variant> timelines;
     static int dump_count;
+    static std::string dump_directory;
 };
 
 /** @brief This class provides a RAII mechanism to log the execution of a function */
@@ -124,6 +166,12 @@ protected:
     bool m_hasGuard = false;
 };
 
+#ifdef NO_MODEL_TRACING
+#define TRACE_CONSTR(ptr, ...)
+#define TRACE(...)
+#define TRACE_STATIC(ptr, ...)
+#define TRACE_RES(res)
+#else
 /// See Logger::log_constr. Note that the macro fills in the ptr instance for you.
 #define TRACE_CONSTR(ptr, ...)                                                                                                                                 \
     LogGuard __guard;                                                                                                                                          \
@@ -150,45 +198,41 @@ protected:
     if (__guard.hasGuard()) {                                                                                                                                  \
         Logger::log_res(res);                                                                                                                                  \
     }
+#endif
 
 /******* Implementations ***********/
 template <typename T> void Logger::log_constr(T *inst, std::vector<rttr::variant> args)
 {
-    std::unique_lock<std::mutex> lk(mut);
-    for (auto &a : args) {
-        // this will rewove shared/weak/unique ptrs
-        if (a.get_type().is_wrapper()) {
-            a = a.extract_wrapped_value();
-        }
+    unwrap_args(args);
+    Operation op;
+    op.kind = Operation::Kind::Constr;
+    op.name = rttr::type::get<T>().get_name().to_string();
+    op.ptr = inst;
+    op.args = std::move(args);
+    if (op.name == "TimelineModel") {
+        op.id = register_timeline(op.ptr);
     }
-    std::string class_name = rttr::type::get<T>().get_name().to_string();
-    constr[class_name].push_back({inst, std::move(args)});
-    operations.emplace_back(ConstrId{class_name, constr[class_name].size() - 1});
+    push(std::move(op));
 }
 
 template <typename T> void Logger::log(T *inst, std::string fctName, std::vector<rttr::variant> args)
 {
-    std::unique_lock<std::mutex> lk(mut);
-    for (auto &a : args) {
-        // this will rewove shared/weak/unique ptrs
-        if (a.get_type().is_wrapper()) {
-            a = a.extract_wrapped_value();
-        }
-    }
-    std::string class_name = rttr::type::get<T>().get_name().to_string();
-    invoks.push_back({inst, std::move(fctName), std::move(args), rttr::variant()});
-    operations.emplace_back(InvokId{invoks.size() - 1});
-    result_awaiting = invoks.size() - 1;
+    unwrap_args(args);
+    Operation op;
+    op.kind = Operation::Kind::Invok;
+    op.name = std::move(fctName);
+    op.ptr = inst;
+    op.args = std::move(args);
+    push(std::move(op));
 }
 
 template <typename T> size_t Logger::get_id_from_ptr(T *ptr)
 {
-    const std::string class_name = rttr::type::get<T>().get_name().to_string();
-    for (size_t i = 0; i < constr.at(class_name).size(); ++i) {
-        if (constr.at(class_name)[i].first.convert<T *>() == ptr) {
+    for (size_t i = 0; i < timelines.size(); ++i) {
+        if (timelines[i].convert<T *>() == ptr) {
             return i;
         }
     }
-    std::cerr << "Error: ptr of type " << class_name << " not found" << std::endl;
+    std::cerr << "Error: ptr of type " << rttr::type::get<T>().get_name().to_string() << " not found" << std::endl;
     return INT_MAX;
 }
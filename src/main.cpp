@@ -74,7 +74,13 @@ int main(int argc, char *argv[])
     // Force QDomDocument to use a deterministic XML attribute order
     qSetGlobalQHashSeed(0);
 
-    Logger::init();
+    // Keep the last model operations around for bug reports, KDENLIVE_NO_MODEL_TRACE disables the tracing
+    // and KDENLIVE_RECORD_MODEL_TRACE records the whole session for the trace replay benchmark
+    const bool recordSession = qEnvironmentVariableIsSet("KDENLIVE_RECORD_MODEL_TRACE");
+    Logger::init(recordSession ? 0 : 1000);
+    if (qEnvironmentVariableIsSet("KDENLIVE_NO_MODEL_TRACE")) {
+        Logger::setEnabled(false);
+    }
     QCoreApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
     //TODO: is it a good option ?
     QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts, true);
@@ -217,6 +223,10 @@ int main(int argc, char *argv[])
 #elif defined(KF5_USE_CRASH)
     KCrash::initialize();
 #endif
+    // Installed after the crash reporter, which still runs once the model trace is written
+    if (Logger::isEnabled()) {
+        Logger::installCrashHandler(QDir::tempPath().toStdString());
+    }
 
     qmlRegisterUncreatableMetaObject(PlaylistState::staticMetaObject, // static meta object
                                      "com.enums",                     // import statement
@@ -261,6 +271,9 @@ int main(int argc, char *argv[])
     });
     pCore->initGUI(url, clipsToLoad);
     int result = app.exec();
+    if (recordSession) {
+        Logger::print_trace();
+    }
     Core::clean();
 
     if (result == EXIT_RESTART || result == EXIT_CLEAN_RESTART) {
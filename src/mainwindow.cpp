@@ -28,6 +28,7 @@
 #include "core.h"
 #include "dialogs/clipcreationdialog.h"
 #include "dialogs/kdenlivesettingsdialog.h"
+#include "dialogs/latencydialog.h"
 #include "dialogs/renderwidget.h"
 #include "dialogs/wizard.h"
 #include "dialogs/subtitleedit.h"
@@ -38,6 +39,7 @@
 #include "effectslist/effectbasket.h"
 #include "hidetitlebars.h"
 #include "jobs/jobmanager.h"
+#include "jobs/loudnessjob.hpp"
 #include "jobs/scenesplitjob.hpp"
 #include "jobs/speedjob.hpp"
 #include "jobs/stabilizejob.hpp"
@@ -65,6 +67,7 @@
 #include "titler/titlewidget.h"
 #include "transitions/transitionlist/view/transitionlistwidget.hpp"
 #include "transitions/transitionsrepository.hpp"
+#include "utils/latencystats.hpp"
 #include "utils/resourcewidget.h"
 #include "utils/thememanager.h"
 #include "utils/otioconvertions.h"
@@ -202,6 +205,7 @@ void MainWindow::init()
     // QIcon::setThemeSearchPaths(QStringList() <<QStringLiteral(":/icons/"));
 
     new RenderingAdaptor(this);
+    new LatencyAdaptor(this);
     QString defaultProfile = KdenliveSettings::default_profile();
     pCore->setCurrentProfile(defaultProfile.isEmpty() ? ProjectManager::getDefaultProjectFormat() : defaultProfile);
     m_commandStack = new QUndoGroup();
@@ -1441,7 +1445,11 @@ void MainWindow::setupActions()
     addAction(QStringLiteral("scale_16_preview"), scale_16);
     scale_16->setCheckable(true);
     scale_16->setData(16);
-    connect(pCore->monitorManager(), &MonitorManager::scalingChanged, this, [scale_2, scale_4, scale_8, scale_16, scale_no]() {
+    QAction *scale_auto = new QAction(i18n("Automatic (reduced while playing)"), m_scaleGroup);
+    addAction(QStringLiteral("scale_auto_preview"), scale_auto);
+    scale_auto->setCheckable(true);
+    scale_auto->setData(-1);
+    connect(pCore->monitorManager(), &MonitorManager::scalingChanged, this, [scale_2, scale_4, scale_8, scale_16, scale_auto, scale_no]() {
         switch (KdenliveSettings::previewScaling()) {
             case 2:
                 scale_2->setChecked(true);
@@ -1455,6 +1463,9 @@ void MainWindow::setupActions()
             case 16:
                 scale_16->setChecked(true);
                 break;
+            case -1:
+                scale_auto->setChecked(true);
+                break;
             default:
                 scale_no->setChecked(true);
                 break;
@@ -1719,6 +1730,8 @@ void MainWindow::setupActions()
     // Cached data management
     addAction(QStringLiteral("manage_cache"), i18n("Manage Cached Data"), this, SLOT(slotManageCache()),
               QIcon::fromTheme(QStringLiteral("network-server-database")));
+    addAction(QStringLiteral("latency_statistics"), i18n("Operation Latency Statistics"), this, SLOT(slotShowLatencyStatistics()),
+              QIcon::fromTheme(QStringLiteral("chronometer")));
 
     QAction *disablePreview = new QAction(i18n("Disable Timeline Preview"), this);
     disablePreview->setCheckable(true);
@@ -2146,6 +2159,16 @@ void MainWindow::addTimelineClip(const QString &url)
     }
 }
 
+QString MainWindow::latencyStatistics() const
+{
+    return LatencyStats::get()->toJson();
+}
+
+void MainWindow::resetLatencyStatistics()
+{
+    LatencyStats::get()->reset();
+}
+
 void MainWindow::scriptRender(const QString &url)
 {
     slotRenderProject();
@@ -3449,6 +3472,16 @@ void MainWindow::buildDynamicActions()
                     [&]() { emit pCore->jobManager()->startJob<SceneSplitJob>(pCore->bin()->selectedClipsIds(true), {}, i18n("Scene detection")); });
         }
     }
+    if (!KdenliveSettings::ffmpegpath().isEmpty()) {
+        QAction *action = new QAction(i18n("Analyse loudness"), m_extraFactory->actionCollection());
+        ts->addAction(action->text(), action);
+        connect(action, &QAction::triggered,
+                [&]() { emit pCore->jobManager()->startJob<LoudnessJob>(pCore->bin()->selectedClipsIds(true), -1, QString(), false); });
+        action = new QAction(i18n("Normalize loudness"), m_extraFactory->actionCollection());
+        ts->addAction(action->text(), action);
+        connect(action, &QAction::triggered,
+                [&]() { emit pCore->jobManager()->startJob<LoudnessJob>(pCore->bin()->selectedClipsIds(true), -1, i18n("Normalize loudness"), true); });
+    }
     if (true /* TODO: check if timewarp producer is available */) {
         QAction *action = new QAction(i18n("Duplicate clip with speed change"), m_extraFactory->actionCollection());
         ts->addAction(action->text(), action);
@@ -4037,6 +4070,12 @@ void MainWindow::slotManageCache()
     d.exec();
 }
 
+void MainWindow::slotShowLatencyStatistics()
+{
+    LatencyDialog d(this);
+    d.exec();
+}
+
 void MainWindow::slotUpdateCompositing(QAction *compose)
 {
     int mode = compose->data().toInt();
@@ -277,6 +277,9 @@ public slots:
     Q_SCRIPTABLE void addTimelineClip(const QString &url);
     Q_SCRIPTABLE void addEffect(const QString &effectId);
     Q_SCRIPTABLE void scriptRender(const QString &url);
+    /** @brief Returns the duration statistics of the measured operations, as JSON. */
+    Q_SCRIPTABLE QString latencyStatistics() const;
+    Q_SCRIPTABLE void resetLatencyStatistics();
     Q_NOREPLY void exitApp();
 
     void slotSwitchVideoThumbs();
@@ -481,6 +484,7 @@ private slots:
     void showTimelineToolbarMenu(const QPoint &pos);
     /** @brief Open Cached Data management dialog. */
     void slotManageCache();
+    void slotShowLatencyStatistics();
     void showMenuBar(bool show);
     /** @brief Change forced icon theme setting (asks for app restart). */
     void forceIconSet(bool force);
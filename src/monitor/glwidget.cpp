@@ -27,6 +27,7 @@
 #include <QPainter>
 #include <QQmlContext>
 #include <QQuickItem>
+#include <QScreen>
 #include <QFontDatabase>
 #include <kdeclarative_version.h>
 #include <KLocalizedContext>
@@ -38,6 +39,7 @@
 #include "monitorproxy.h"
 #include "profiles/profilemodel.hpp"
 #include "timeline2/view/qml/timelineitems.h"
+#include "utils/latencystats.hpp"
 #include <mlt++/Mlt.h>
 #include <lib/localeHandling.h>
 
@@ -86,6 +88,9 @@ GLWidget::GLWidget(int id, QObject *parent)
     , m_vertexLocation(0)
     , m_texCoordLocation(0)
     , m_colorspaceLocation(0)
+    , m_reducedPreview(false)
+    , m_cacheRevision(0)
+    , m_cachedPosition(-1)
     , m_zoom(1.0f)
     , m_profileSize(1920, 1080)
     , m_colorSpace(601)
@@ -129,6 +134,14 @@ GLWidget::GLWidget(int id, QObject *parent)
     m_blackClip->set("kdenlive:id", "black");
     m_blackClip->set("out", 3);
     connect(&m_refreshTimer, &QTimer::timeout, this, &GLWidget::refresh);
+    m_scrubTimer.setSingleShot(true);
+    m_scrubTimer.setInterval(300);
+    connect(&m_scrubTimer, &QTimer::timeout, this, [this]() {
+        if (m_reducedPreview && m_producer && qFuzzyIsNull(m_producer->get_speed())) {
+            setReducedPreview(false);
+            refresh();
+        }
+    });
     m_producer = m_blackClip;
     rootContext()->setContextProperty("markersModel", 0);
     if (!initGPUAccel()) {
@@ -645,6 +658,18 @@ void GLWidget::updateRulerHeight(int addedHeight)
 
 void GLWidget::requestSeek(int position)
 {
+    if (KdenliveSettings::previewScaling() == -1 && qFuzzyIsNull(m_producer->get_speed())) {
+        // Scrubbing, render at reduced resolution until the position settles
+        setReducedPreview(true);
+        m_scrubTimer.start();
+    }
+    if (qFuzzyIsNull(m_producer->get_speed()) && showCachedFrame(position)) {
+        m_cachedPosition = position;
+        m_producer->seek(position);
+        return;
+    }
+    m_cachedPosition = -1;
+    m_cacheRevision = m_frameCache.revision();
     m_consumer->set("scrub_audio", 1);
     m_producer->seek(position);
     if (!qFuzzyIsNull(m_producer->get_speed())) {
@@ -658,7 +683,13 @@ void GLWidget::requestRefresh()
 {
     if (m_producer && qFuzzyIsNull(m_producer->get_speed())) {
         m_consumer->set("scrub_audio", 0);
-        m_refreshTimer.start();
+        // Don't postpone a pending refresh, so that continuous parameter changes are rendered at the display rate with the latest values
+        if (!m_refreshTimer.isActive()) {
+            if (screen() && screen()->refreshRate() > 1) {
+                m_refreshTimer.setInterval(qMax(16, qRound(1000. / screen()->refreshRate())));
+            }
+            m_refreshTimer.start();
+        }
     }
 }
 
@@ -670,11 +701,34 @@ QString GLWidget::frameToTime(int frames) const
 void GLWidget::refresh()
 {
     m_refreshTimer.stop();
+    if (!m_refreshLatency.isValid()) {
+        m_refreshLatency.start();
+    }
+    m_cachedPosition = -1;
+    m_cacheRevision = m_frameCache.revision();
     QMutexLocker locker(&m_mltMutex);
     restartConsumer();
     m_consumer->set("refresh", 1);
 }
 
+void GLWidget::invalidateFrameCache(int in, int out)
+{
+    m_frameCache.invalidate(in, out);
+}
+
+bool GLWidget::showCachedFrame(int position)
+{
+    if (m_glslManager || !m_frameRenderer) {
+        return false;
+    }
+    std::shared_ptr<Mlt::Frame> frame = m_frameCache.get(position, m_profileSize);
+    if (!frame || !m_frameRenderer->semaphore()->tryAcquire()) {
+        return false;
+    }
+    QMetaObject::invokeMethod(m_frameRenderer, "showFrame", Qt::QueuedConnection, Q_ARG(Mlt::Frame, *frame));
+    return true;
+}
+
 bool GLWidget::checkFrameNumber(int pos, int offset, bool isPlaying)
 {
     const double speed = m_producer->get_speed();
@@ -910,6 +964,7 @@ int GLWidget::setProducer(const std::shared_ptr<Mlt::Producer> &producer, bool i
     }
     // redundant check. postcondition of above is m_producer != null
     m_producer->set_speed(0);
+    m_frameCache.clear();
     error = reconfigure();
     if (error == 0) {
         // The profile display aspect ratio may have changed.
@@ -1129,8 +1184,8 @@ int GLWidget::reconfigure()
         }
         m_consumer->set("real_time", dropFrames);
         m_consumer->set("channels", pCore->audioChannels());
-        if (KdenliveSettings::previewScaling() > 1) {
-            m_consumer->set("scale", 1.0 / KdenliveSettings::previewScaling());
+        if (previewScaling() > 1) {
+            m_consumer->set("scale", 1.0 / previewScaling());
         }
         // C & D
         if (m_glslManager) {
@@ -1206,6 +1261,7 @@ float GLWidget::zoom() const
 
 void GLWidget::reloadProfile()
 {
+    m_frameCache.clear();
     // The profile display aspect ratio may have changed.
     bool existingConsumer = false;
     if (m_consumer) {
@@ -1257,11 +1313,27 @@ void GLWidget::setZoom(float zoom)
 
 void GLWidget::onFrameDisplayed(const SharedFrame &frame)
 {
+    if (m_refreshLatency.isValid()) {
+        // Time from the refresh request to the new frame
+        LatencyStats::get()->record("monitor.refresh", m_refreshLatency.nsecsElapsed() / 1000);
+        m_refreshLatency.invalidate();
+    }
+    if (m_cachedPosition > -1 && frame.get_int("kdenlive:cached") == 0 && frame.get_position() != m_cachedPosition) {
+        // A frame requested before seeking to a cached position, don't replace the cached one
+        return;
+    }
     m_contextSharedAccess.lock();
     m_sharedFrame = frame;
     m_sendFrame = sendFrameForAnalysis;
     m_contextSharedAccess.unlock();
     update();
+    if (m_id == Kdenlive::ProjectMonitor && !m_glslManager && frame.get_int("kdenlive:cached") == 0 && qFuzzyIsNull(m_producer->get_speed())) {
+        // Only keep the frames displayed while paused, copying each frame during playback would be too expensive
+        m_frameCache.setBudget(qint64(KdenliveSettings::monitorFrameCache()) << 20);
+        Mlt::Frame cached = frame.clone(false, true, false);
+        cached.set("kdenlive:cached", 1);
+        m_frameCache.insert(frame.get_position(), m_profileSize, cached, m_cacheRevision);
+    }
 }
 
 void GLWidget::mouseReleaseEvent(QMouseEvent *event)
@@ -1607,6 +1679,8 @@ void GLWidget::switchPlay(bool play, double speed)
             m_producer->seek(0);
         }
         double current_speed = m_producer->get_speed();
+        setReducedPreview(true);
+        m_cachedPosition = -1;
         m_producer->set_speed(speed);
         if (speed <= 1. || speed > 6.) {
             m_consumer->set("scrub_audio", 0);
@@ -1626,6 +1700,7 @@ void GLWidget::switchPlay(bool play, double speed)
         m_producer->set_speed(0);
         m_producer->seek(m_consumer->position() + 1);
         m_consumer->purge();
+        setReducedPreview(false);
         m_consumer->start();
     }
 }
@@ -1640,6 +1715,8 @@ bool GLWidget::playZone(bool loop)
     m_producer->set_speed(0);
     m_consumer->purge();
     m_producer->set("out", m_proxy->zoneOut());
+    setReducedPreview(true);
+    m_cachedPosition = -1;
     m_producer->set_speed(1.0);
     restartConsumer();
     m_consumer->set("scrub_audio", 0);
@@ -1677,6 +1754,8 @@ bool GLWidget::loopClip(QPoint inOut)
     m_producer->set_speed(0);
     m_consumer->purge();
     m_producer->set("out", inOut.y());
+    setReducedPreview(true);
+    m_cachedPosition = -1;
     m_producer->set_speed(1.0);
     restartConsumer();
     m_consumer->set("scrub_audio", 0);
@@ -1739,6 +1818,7 @@ void GLWidget::startConsumer()
 void GLWidget::stop()
 {
     m_refreshTimer.stop();
+    setReducedPreview(false);
     // why this lock?
     QMutexLocker locker(&m_mltMutex);
     if (m_producer) {
@@ -1819,7 +1899,7 @@ void GLWidget::updateScaling()
 {
 #if LIBMLT_VERSION_INT >= QT_VERSION_CHECK(6,20,0)
     int previewHeight = pCore->getCurrentFrameSize().height();
-    switch (KdenliveSettings::previewScaling()) {
+    switch (previewScaling()) {
         case 2:
             previewHeight = qMin(previewHeight, 720);
             break;
@@ -1843,6 +1923,7 @@ void GLWidget::updateScaling()
     if (m_consumer) {
         m_consumer->set("width", m_profileSize.width());
         m_consumer->set("height", m_profileSize.height());
+        m_consumer->set("scale", 1.0 / qMax(1, previewScaling()));
         resizeGL(width(), height());
     }
 #else
@@ -1853,11 +1934,36 @@ void GLWidget::updateScaling()
     }
     m_profileSize = QSize(pWidth, previewHeight);
     if (m_consumer) {
+        m_consumer->set("scale", 1.0 / qMax(1, previewScaling()));
         resizeGL(width(), height());
     }
 #endif
 }
 
+int GLWidget::previewScaling() const
+{
+    int scaling = KdenliveSettings::previewScaling();
+    if (scaling == -1) {
+        // Automatic mode: 540p while playing or scrubbing, full resolution when paused
+        return m_reducedPreview ? 4 : 1;
+    }
+    return scaling;
+}
+
+void GLWidget::setReducedPreview(bool reduced)
+{
+    if (!reduced) {
+        m_scrubTimer.stop();
+    }
+    if (m_reducedPreview == reduced) {
+        return;
+    }
+    m_reducedPreview = reduced;
+    if (KdenliveSettings::previewScaling() == -1) {
+        updateScaling();
+    }
+}
+
 void GLWidget::switchRuler(bool show)
 {
     m_rulerHeight = show ? QFontInfo(QFontDatabase::systemFont(QFontDatabase::SmallestReadableFont)).pixelSize() * 1.5 : 0;
@@ -19,6 +19,7 @@
 #ifndef GLWIDGET_H
 #define GLWIDGET_H
 
+#include <QElapsedTimer>
 #include <QFont>
 #include <QMutex>
 #include <QOffscreenSurface>
@@ -35,6 +36,7 @@
 #include "bin/model/markerlistmodel.hpp"
 #include "definitions.h"
 #include "kdenlivesettings.h"
+#include "monitorframecache.hpp"
 #include "scopes/sharedframe.h"
 
 #include <mlt++/MltProfile.h>
@@ -162,6 +164,8 @@ public slots:
     void reloadProfile();
     /** @brief Update MLT's consumer scaling */
     void updateScaling();
+    /** @brief Drop the cached frames between in and out (out = -1 meaning until the end) because the timeline changed */
+    void invalidateFrameCache(int in, int out);
 
 signals:
     void frameDisplayed(const SharedFrame &frame);
@@ -223,6 +227,18 @@ private:
     int m_colorspaceLocation;
     int m_textureLocation[3];
     QTimer m_refreshTimer;
+    /** @brief Restores the full preview resolution once scrubbing stops, in automatic preview scaling mode */
+    QTimer m_scrubTimer;
+    /** @brief True while playing or scrubbing in automatic preview scaling mode, so that a reduced resolution is rendered */
+    bool m_reducedPreview;
+    /** @brief Recently rendered frames of the project monitor, displayed again when seeking to the same position while paused */
+    MonitorFrameCache m_frameCache;
+    /** @brief The cache revision when the frame being rendered was requested */
+    quint64 m_cacheRevision;
+    /** @brief Position of the cached frame displayed by the last seek, -1 if it was rendered */
+    int m_cachedPosition;
+    /** @brief Started when a refresh is requested, to measure the delay until the frame is displayed */
+    QElapsedTimer m_refreshLatency;
     float m_zoom;
     QSize m_profileSize;
     int m_colorSpace;
@@ -243,6 +259,12 @@ private:
     void resetZoneMode();
     /** @brief Restart consumer, keeping preview scaling settings */
     bool restartConsumer();
+    /** @brief The preview scaling to apply, resolving the automatic mode (-1) to a fixed one */
+    int previewScaling() const;
+    /** @brief Switch between reduced and full resolution in automatic preview scaling mode */
+    void setReducedPreview(bool reduced);
+    /** @brief Display the frame cached for this position, returns false if there is none */
+    bool showCachedFrame(int position);
 
     /* OpenGL context management. Interfaces to MLT according to the configured render pipeline.
      */
@@ -37,6 +37,7 @@
 #include "recmanager.h"
 #include "jobs/jobmanager.h"
 #include "jobs/cutclipjob.h"
+#include "jobs/spectrogramjob.hpp"
 #include "scopes/monitoraudiolevel.h"
 #include "timeline2/model/snapmodel.hpp"
 #include "transitions/transitionsrepository.hpp"
@@ -211,7 +212,7 @@ Monitor::Monitor(Kdenlive::MonitorId id, MonitorManager *manager, QWidget *paren
     QComboBox *scalingAction = new QComboBox(this);
     scalingAction->setToolTip(i18n("Preview resolution - lower resolution means faster preview"));
     // Combobox padding is bad, so manually add a space before text
-    scalingAction->addItems({QStringLiteral(" ") + i18n("1:1"),QStringLiteral(" ") + i18n("720p"),QStringLiteral(" ") + i18n("540p"),QStringLiteral(" ") + i18n("360p"),QStringLiteral(" ") + i18n("270p")});
+    scalingAction->addItems({QStringLiteral(" ") + i18n("1:1"),QStringLiteral(" ") + i18n("720p"),QStringLiteral(" ") + i18n("540p"),QStringLiteral(" ") + i18n("360p"),QStringLiteral(" ") + i18n("270p"),QStringLiteral(" ") + i18n("Auto")});
     connect(scalingAction, QOverload<int>::of(&QComboBox::activated), this, [this] (int index) {
         switch (index) {
             case 1:
@@ -226,6 +227,9 @@ Monitor::Monitor(Kdenlive::MonitorId id, MonitorManager *manager, QWidget *paren
             case 4:
                 KdenliveSettings::setPreviewScaling(16);
                 break;
+            case 5:
+                KdenliveSettings::setPreviewScaling(-1);
+                break;
             default:
                 KdenliveSettings::setPreviewScaling(0);
         }
@@ -248,6 +252,9 @@ Monitor::Monitor(Kdenlive::MonitorId id, MonitorManager *manager, QWidget *paren
             case 16:
                 scalingAction->setCurrentIndex(4);
                 break;
+            case -1:
+                scalingAction->setCurrentIndex(5);
+                break;
             default:
                 scalingAction->setCurrentIndex(0);
                 break;
@@ -637,6 +644,15 @@ void Monitor::setupMenu(QMenu *goMenu, QMenu *overlayMenu, QAction *playZone, QA
         alwaysShowAudio->setChecked(KdenliveSettings::alwaysShowMonitorAudio());
         m_contextMenu->addAction(alwaysShowAudio);
         m_configMenu->addAction(alwaysShowAudio);
+        QAction *showSpectrogram = new QAction(i18n("Show spectrogram"), this);
+        showSpectrogram->setCheckable(true);
+        connect(showSpectrogram, &QAction::triggered, this, [this](bool checked) {
+            KdenliveSettings::setClipMonitorSpectrogram(checked);
+            prepareSpectrogram();
+        });
+        showSpectrogram->setChecked(KdenliveSettings::clipMonitorSpectrogram());
+        m_contextMenu->addAction(showSpectrogram);
+        m_configMenu->addAction(showSpectrogram);
     }
 
     if (overlayMenu) {
@@ -1436,6 +1452,11 @@ void Monitor::forceMonitorRefresh()
     m_glMonitor->refresh();
 }
 
+void Monitor::invalidateFrameCache(int in, int out)
+{
+    m_glMonitor->invalidateFrameCache(in, out);
+}
+
 void Monitor::refreshMonitorIfActive(bool directUpdate)
 {
     if (isActive()) {
@@ -1551,6 +1572,7 @@ void Monitor::slotOpenClip(const std::shared_ptr<ProjectClip> &controller, int i
     if (m_controller) {
         m_glMonitor->resetZoneMode();
         disconnect(m_controller.get(), &ProjectClip::audioThumbReady, this, &Monitor::prepareAudioThumb);
+        disconnect(m_controller.get(), &ProjectClip::spectrogramReady, this, &Monitor::prepareSpectrogram);
         disconnect(m_controller->getMarkerModel().get(), SIGNAL(dataChanged(const QModelIndex &, const QModelIndex &, const QVector<int> &)), this,
                    SLOT(checkOverlay()));
         disconnect(m_controller->getMarkerModel().get(), SIGNAL(rowsInserted(const QModelIndex &, int, int)), this, SLOT(checkOverlay()));
@@ -1599,6 +1621,7 @@ void Monitor::slotOpenClip(const std::shared_ptr<ProjectClip> &controller, int i
             //m_audioChannels->menuAction()->setVisible(false);
         }
         connect(m_controller.get(), &ProjectClip::audioThumbReady, this, &Monitor::prepareAudioThumb);
+        connect(m_controller.get(), &ProjectClip::spectrogramReady, this, &Monitor::prepareSpectrogram);
         connect(m_controller->getMarkerModel().get(), SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)), this,
                 SLOT(checkOverlay()));
         connect(m_controller->getMarkerModel().get(), SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(checkOverlay()));
@@ -1641,6 +1664,7 @@ void Monitor::slotOpenClip(const std::shared_ptr<ProjectClip> &controller, int i
                     m_glMonitor->getControllerProxy()->setAudioThumb(streamIndexes, m_controller->activeStreamChannels());
                 }
             }
+            prepareSpectrogram();
             m_glMonitor->setProducer(m_controller->originalProducer(), isActive(), in);
         } else {
             qDebug()<<"*************** CONTROLLER NOT READY";
@@ -1650,6 +1674,7 @@ void Monitor::slotOpenClip(const std::shared_ptr<ProjectClip> &controller, int i
         loadQmlScene(MonitorSceneDefault);
         m_glMonitor->setProducer(nullptr, isActive(), -1);
         m_glMonitor->getControllerProxy()->setAudioThumb();
+        m_glMonitor->getControllerProxy()->setSpectrogram(QString());
         m_audioMeterWidget->audioChannels = 0;
         m_glMonitor->getControllerProxy()->setClipProperties(-1, ClipType::Unknown, false, QString());
         //m_audioChannels->menuAction()->setVisible(false);
@@ -2275,6 +2300,23 @@ void Monitor::prepareAudioThumb()
     }
 }
 
+void Monitor::prepareSpectrogram()
+{
+    if (!m_controller || !KdenliveSettings::clipMonitorSpectrogram() || !m_controller->audioInfo() || m_controller->audioChannels() == 0) {
+        m_glMonitor->getControllerProxy()->setSpectrogram(QString());
+        return;
+    }
+    const QString path = m_controller->getSpectrogramPath(m_controller->audioInfo()->audio_index());
+    if (!path.isEmpty() && QFile::exists(path)) {
+        m_glMonitor->getControllerProxy()->setSpectrogram(QUrl::fromLocalFile(path).toString());
+        return;
+    }
+    m_glMonitor->getControllerProxy()->setSpectrogram(QString());
+    if (!path.isEmpty() && !pCore->jobManager()->hasPendingJob(m_controller->clipId(), AbstractClipJob::SPECTROGRAMJOB)) {
+        pCore->jobManager()->startJob<SpectrogramJob>({m_controller->clipId()}, -1, QString());
+    }
+}
+
 void Monitor::slotSwitchAudioMonitor()
 {
     if (!m_audioMeterWidget->isValid) {
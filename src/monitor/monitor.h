@@ -132,6 +132,8 @@ public:
     void refreshIcons();
     /** @brief Send audio thumb data to qml for on monitor display */
     void prepareAudioThumb();
+    /** @brief Display the cached spectrogram of the clip if enabled, computing it if necessary */
+    void prepareSpectrogram();
     void connectAudioSpectrum(bool activate);
     /** @brief Set a property on the Qml scene **/
     void setQmlProperty(const QString &name, const QVariant &value);
@@ -334,6 +336,8 @@ public slots:
     void checkOverlay(int pos = -1);
     void refreshMonitorIfActive(bool directUpdate = false) override;
     void forceMonitorRefresh();
+    /** @brief Drop the frames cached for scrubbing between in and out (out = -1 meaning until the end) */
+    void invalidateFrameCache(int in, int out);
     /** @brief Clear read ahead cache, to ensure up to date audio */
     void purgeCache();
 
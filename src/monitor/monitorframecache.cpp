@@ -0,0 +1,114 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "monitorframecache.hpp"
+
+void MonitorFrameCache::setBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budget = qMax(qint64(0), bytes);
+    shrink(m_budget);
+}
+
+quint64 MonitorFrameCache::revision() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_revision;
+}
+
+bool MonitorFrameCache::insert(int position, const QSize &size, const Mlt::Frame &frame, quint64 revision)
+{
+    // Mlt::Frame has no const accessors
+    auto cached = std::make_shared<Mlt::Frame>(frame);
+    const auto format = mlt_image_format(cached->get_int("format"));
+    const int width = cached->get_int("width");
+    const int height = cached->get_int("height");
+    const qint64 cost = width > 0 && height > 0 ? mlt_image_format_size(format, width, height, nullptr) : 0;
+    QMutexLocker locker(&m_mutex);
+    if (revision != m_revision || cost <= 0 || cost > m_budget) {
+        return false;
+    }
+    auto it = m_frames.find(position);
+    if (it != m_frames.end()) {
+        remove(it);
+    }
+    shrink(m_budget - cost);
+    m_usage.push_back(position);
+    m_frames[position] = Entry{cached, size, cost, std::prev(m_usage.end())};
+    m_cost += cost;
+    return true;
+}
+
+std::shared_ptr<Mlt::Frame> MonitorFrameCache::get(int position, const QSize &size)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_frames.find(position);
+    if (it == m_frames.end() || it->second.size != size) {
+        return nullptr;
+    }
+    m_usage.splice(m_usage.end(), m_usage, it->second.usage);
+    return it->second.frame;
+}
+
+void MonitorFrameCache::invalidate(int in, int out)
+{
+    QMutexLocker locker(&m_mutex);
+    m_revision++;
+    auto it = m_frames.lower_bound(in);
+    while (it != m_frames.end() && (out < 0 || it->first <= out)) {
+        remove(it++);
+    }
+}
+
+void MonitorFrameCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_revision++;
+    m_frames.clear();
+    m_usage.clear();
+    m_cost = 0;
+}
+
+int MonitorFrameCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return int(m_frames.size());
+}
+
+qint64 MonitorFrameCache::cost() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cost;
+}
+
+void MonitorFrameCache::remove(std::map<int, Entry>::iterator it)
+{
+    m_cost -= it->second.cost;
+    m_usage.erase(it->second.usage);
+    m_frames.erase(it);
+}
+
+void MonitorFrameCache::shrink(qint64 budget)
+{
+    while (m_cost > budget && !m_usage.empty()) {
+        remove(m_frames.find(m_usage.front()));
+    }
+}
@@ -0,0 +1,87 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QMutex>
+#include <QSize>
+#include <list>
+#include <map>
+#include <memory>
+#include <mlt++/MltFrame.h>
+
+/** @brief This class keeps the recently rendered frames of a monitor in memory, so that seeking again to a position does not re-render it.
+    Frames are stored with the preview size they were rendered at, and dropped when the timeline changes in their range or when the memory budget is exceeded.
+    A revision counter, increased on each invalidation, prevents caching a frame whose rendering was requested before the change.
+ */
+class MonitorFrameCache
+{
+
+public:
+    MonitorFrameCache() = default;
+
+    /* @brief Sets the maximum memory used by the cached images, in bytes. 0 disables the cache */
+    void setBudget(qint64 bytes);
+
+    /* @brief Returns the current revision, to pass to insert() when the frame is received */
+    quint64 revision() const;
+
+    /* @brief Caches a rendered frame (which should own its image, see SharedFrame::clone).
+       Returns false if the cache is disabled or if the timeline changed since @param revision was retrieved */
+    bool insert(int position, const QSize &size, const Mlt::Frame &frame, quint64 revision);
+
+    /* @brief Returns the frame cached for this position and size, or nullptr */
+    std::shared_ptr<Mlt::Frame> get(int position, const QSize &size);
+
+    /* @brief Drops the frames between @param in and @param out included, out = -1 meaning until the end */
+    void invalidate(int in, int out);
+
+    /* @brief Drops all frames */
+    void clear();
+
+    /* @brief Number of cached frames */
+    int count() const;
+
+    /* @brief Memory used by the cached images, in bytes */
+    qint64 cost() const;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<Mlt::Frame> frame;
+        QSize size;
+        qint64 cost;
+        // Position of the frame in m_usage
+        std::list<int>::iterator usage;
+    };
+
+    mutable QMutex m_mutex;
+    // Cached frames by position
+    std::map<int, Entry> m_frames;
+    // Positions from the least to the most recently used
+    std::list<int> m_usage;
+    qint64 m_budget = 0;
+    qint64 m_cost = 0;
+    quint64 m_revision = 0;
+
+    void remove(std::map<int, Entry>::iterator it);
+    void shrink(qint64 budget);
+};
@@ -106,6 +106,7 @@ void MonitorManager::focusProjectMonitor()
 
 void MonitorManager::refreshProjectRange(QPair<int, int> range)
 {
+    m_projectMonitor->invalidateFrameCache(range.first, range.second);
     if (m_projectMonitor->position() >= range.first && m_projectMonitor->position() <= range.second) {
         m_projectMonitor->refreshMonitorIfActive();
     }
@@ -113,6 +114,7 @@ void MonitorManager::refreshProjectRange(QPair<int, int> range)
 
 void MonitorManager::refreshProjectMonitor()
 {
+    m_projectMonitor->invalidateFrameCache(0, -1);
     m_projectMonitor->refreshMonitorIfActive();
 }
 
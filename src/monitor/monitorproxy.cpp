@@ -337,6 +337,15 @@ void MonitorProxy::setAudioStream(const QString &name)
     emit clipStreamChanged();
 }
 
+void MonitorProxy::setSpectrogram(const QString &url)
+{
+    if (m_spectrogram == url) {
+        return;
+    }
+    m_spectrogram = url;
+    emit spectrogramChanged();
+}
+
 
 QPoint MonitorProxy::profile()
 {
@@ -46,6 +46,9 @@ class MonitorProxy : public QObject
     Q_PROPERTY(QString markerComment READ markerComment NOTIFY markerCommentChanged)
     Q_PROPERTY(QList <int> audioStreams MEMBER m_audioStreams NOTIFY audioThumbChanged)
     Q_PROPERTY(QList <int> audioChannels MEMBER m_audioChannels NOTIFY audioThumbChanged)
+    /** @brief: Url of the spectrogram image of the clip, empty if it should not be displayed
+     * */
+    Q_PROPERTY(QString spectrogram MEMBER m_spectrogram NOTIFY spectrogramChanged)
     Q_PROPERTY(int overlayType READ overlayType WRITE setOverlayType NOTIFY overlayTypeChanged)
     Q_PROPERTY(QColor thumbColor1 READ thumbColor1 NOTIFY colorsChanged)
     Q_PROPERTY(QColor thumbColor2 READ thumbColor2 NOTIFY colorsChanged)
@@ -106,6 +109,7 @@ public:
     void setClipProperties(int clipId, ClipType::ProducerType type, bool hasAV, const QString clipName);
     void setAudioThumb(const QList <int> streamIndexes = QList <int>(), QList <int> channels = QList <int>());
     void setAudioStream(const QString &name);
+    void setSpectrogram(const QString &url);
     void setRulerHeight(int height);
 
 signals:
@@ -131,6 +135,7 @@ signals:
     void clipTypeChanged();
     void clipIdChanged();
     void audioThumbChanged();
+    void spectrogramChanged();
     void colorsChanged();
     void audioThumbFormatChanged();
     void audioThumbNormalizeChanged();
@@ -148,6 +153,7 @@ private:
     QString m_markerComment;
     QString m_clipName;
     QString m_clipStream;
+    QString m_spectrogram;
     int m_clipType;
     int m_clipId;
     bool m_seekFinished;
@@ -263,6 +263,7 @@ Item {
                     property double streamHeight: audioThumb.height / streamThumb.count
                     Item {
                         anchors.fill: parent
+                        visible: controller.spectrogram == ""
                         TimelineWaveform {
                             anchors.right: parent.right
                             anchors.left: parent.left
@@ -291,6 +292,21 @@ Item {
                         }
                     }
                 }
+                Item {
+                    id: spectrogramThumb
+                    anchors.fill: parent
+                    clip: true
+                    visible: controller.spectrogram != ""
+                    Image {
+                        source: controller.spectrogram
+                        height: parent.height
+                        width: parent.width / root.zoomFactor
+                        x: -width * root.zoomStart
+                        fillMode: Image.Stretch
+                        cache: false
+                        asynchronous: true
+                    }
+                }
                 Rectangle {
                     color: "red"
                     width: 1
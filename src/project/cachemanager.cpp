@@ -0,0 +1,218 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "cachemanager.hpp"
+#include "kdenlive_debug.h"
+#include "kdenlivesettings.h"
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QtConcurrent>
+#include <algorithm>
+#include <vector>
+
+namespace {
+// Written in the cache folder of a project each time it is opened. Its date is the last access of the project data, its content the proxy clips used
+const QString accessMarker = QStringLiteral(".lastaccess");
+// Locked in the cache folder of a project while it is open in a Kdenlive instance
+const QString inUseLock = QStringLiteral(".inuse");
+// The folders of a project cache whose files are managed one by one, proxy clips are shared by all projects
+const QStringList projectFolders = {QStringLiteral("audiothumbs"), QStringLiteral("videothumbs")};
+// The timeline preview chunks and their undo history, which are only useful together
+const QString previewFolder = QStringLiteral("preview");
+// Interval of the periodic checks while a project is open, in ms
+const int checkInterval = 10 * 60 * 1000;
+} // namespace
+
+std::unique_ptr<CacheManager> CacheManager::instance;
+std::once_flag CacheManager::m_onceFlag;
+
+CacheManager::CacheManager()
+    : m_root(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+{
+    // Previews and proxy clips are rendered while a project is open
+    m_timer.setInterval(checkInterval);
+    QObject::connect(&m_timer, &QTimer::timeout, [this]() { evict(); });
+}
+
+std::unique_ptr<CacheManager> &CacheManager::get()
+{
+    std::call_once(m_onceFlag, [] { instance.reset(new CacheManager()); });
+    return instance;
+}
+
+void CacheManager::setCurrentProject(const QString &documentId, const QStringList &proxyHashes)
+{
+    QMutexLocker lock(&m_mutex);
+    m_documentId = documentId;
+    m_proxyHashes.clear();
+    for (const QString &hash : proxyHashes) {
+        m_proxyHashes.insert(hash);
+    }
+    if (m_lock && (documentId.isEmpty() || m_lock->fileName() != m_root.absoluteFilePath(documentId + QLatin1Char('/') + inUseLock))) {
+        m_lock.reset();
+    }
+    if (documentId.isEmpty() || !m_root.exists(documentId)) {
+        m_timer.stop();
+        return;
+    }
+    m_timer.start();
+    if (!m_lock) {
+        m_lock.reset(new QLockFile(m_root.absoluteFilePath(documentId + QLatin1Char('/') + inUseLock)));
+        // The lock is held as long as the project is open, it is only stale if its instance crashed
+        m_lock->setStaleLockTime(0);
+        // An eviction of another instance may briefly hold it
+        if (!m_lock->tryLock(500)) {
+            qCDebug(KDENLIVE_LOG) << "Cannot lock the cache folder" << documentId << m_lock->error();
+        }
+    }
+    QFile marker(m_root.absoluteFilePath(documentId + QLatin1Char('/') + accessMarker));
+    if (marker.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QTextStream out(&marker);
+        for (const QString &hash : proxyHashes) {
+            out << hash << '\n';
+        }
+    }
+}
+
+QFuture<qint64> CacheManager::evict()
+{
+    qint64 budget = qint64(KdenliveSettings::cachesizelimit()) * 1024 * 1024 * 1024;
+    bool expected = false;
+    if (budget <= 0 || !m_running.compare_exchange_strong(expected, true)) {
+        return QFuture<qint64>();
+    }
+    QString documentId;
+    QSet<QString> proxyHashes;
+    {
+        QMutexLocker lock(&m_mutex);
+        documentId = m_documentId;
+        proxyHashes = m_proxyHashes;
+    }
+    QDir root = m_root;
+    return QtConcurrent::run([this, root, budget, documentId, proxyHashes]() {
+        qint64 freed = evictOldest(root, budget, documentId, proxyHashes);
+        m_running = false;
+        return freed;
+    });
+}
+
+qint64 CacheManager::evictOldest(const QDir &root, qint64 budget, const QString &documentId, const QSet<QString> &proxyHashes)
+{
+    std::vector<Artifact> artifacts;
+    qint64 total = 0;
+    // Last access of each proxy clip, from the projects using it
+    QHash<QString, qint64> proxyAccess;
+    // Proxy clips used by projects open in other instances
+    QSet<QString> usedProxies = proxyHashes;
+    // Locks of the project folders that can be evicted, held until the end so that no instance opens them meanwhile
+    std::vector<std::unique_ptr<QLockFile>> locks;
+
+    // Project cache folders are named after the document id
+    const QStringList folders = root.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &folder : folders) {
+        bool isProject = false;
+        folder.toLongLong(&isProject);
+        if (!isProject) {
+            continue;
+        }
+        QDir projectDir(root.absoluteFilePath(folder));
+        bool inUse = folder == documentId;
+        if (!inUse) {
+            std::unique_ptr<QLockFile> lock(new QLockFile(projectDir.absoluteFilePath(inUseLock)));
+            lock->setStaleLockTime(0);
+            if (lock->tryLock(0)) {
+                locks.push_back(std::move(lock));
+            } else {
+                inUse = true;
+            }
+        }
+        qint64 projectAccess = 0;
+        QFile marker(projectDir.absoluteFilePath(accessMarker));
+        if (marker.open(QIODevice::ReadOnly)) {
+            projectAccess = QFileInfo(marker).lastModified().toMSecsSinceEpoch();
+            QTextStream in(&marker);
+            while (!in.atEnd()) {
+                const QString hash = in.readLine();
+                proxyAccess[hash] = std::max(proxyAccess.value(hash), projectAccess);
+                if (inUse) {
+                    usedProxies.insert(hash);
+                }
+            }
+        }
+        for (const QString &data : projectFolders) {
+            QDirIterator it(projectDir.absoluteFilePath(data), QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                it.next();
+                const QFileInfo info = it.fileInfo();
+                total += info.size();
+                if (!inUse) {
+                    artifacts.push_back({info.absoluteFilePath(), info.size(), std::max(projectAccess, info.lastModified().toMSecsSinceEpoch())});
+                }
+            }
+        }
+        // The preview chunks of a project are deleted together
+        Artifact preview{projectDir.absoluteFilePath(previewFolder), 0, projectAccess};
+        QDirIterator it(preview.path, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            preview.size += info.size();
+            preview.lastAccess = std::max(preview.lastAccess, info.lastModified().toMSecsSinceEpoch());
+        }
+        total += preview.size;
+        if (!inUse && preview.size > 0) {
+            artifacts.push_back(preview);
+        }
+    }
+
+    QDir proxyDir(root.absoluteFilePath(QStringLiteral("proxy")));
+    const QFileInfoList proxies = proxyDir.entryInfoList(QDir::Files);
+    for (const QFileInfo &info : proxies) {
+        total += info.size();
+        // Proxy clips are named after the hash of their source
+        const QString hash = info.fileName().section(QLatin1Char('.'), 0, 0);
+        if (!usedProxies.contains(hash)) {
+            artifacts.push_back({info.absoluteFilePath(), info.size(), std::max(proxyAccess.value(hash), info.lastModified().toMSecsSinceEpoch())});
+        }
+    }
+
+    if (total <= budget) {
+        return 0;
+    }
+    std::sort(artifacts.begin(), artifacts.end(), [](const Artifact &a, const Artifact &b) { return a.lastAccess < b.lastAccess; });
+    qint64 freed = 0;
+    for (const Artifact &artifact : artifacts) {
+        if (total - freed <= budget) {
+            break;
+        }
+        bool removed = QFileInfo(artifact.path).isDir() ? QDir(artifact.path).removeRecursively() : QFile::remove(artifact.path);
+        if (removed) {
+            freed += artifact.size;
+        }
+    }
+    qCDebug(KDENLIVE_LOG) << "Cache over budget, deleted" << freed << "bytes of least recently used data";
+    return freed;
+}
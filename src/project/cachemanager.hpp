@@ -0,0 +1,88 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QDir>
+#include <QFuture>
+#include <QLockFile>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+/** @brief This class keeps the data cached by all projects (timeline previews, proxy clips, audio and video thumbnails) in a size budget.
+    When the total size goes over the budget set in the settings, the least recently used data is deleted, whatever the project it
+    belongs to. The timeline preview of a project is deleted as a whole, thumbnails and proxy clips file by file.
+    A project is marked as used when it is opened, which refreshes all its data and the proxy clips it uses.
+    The open project holds a lock file in its cache folder, so data of projects open in any Kdenlive instance is never deleted.
+    While a project is open, the cache is checked periodically.
+ * Note that this class is a Singleton
+ */
+
+class CacheManager
+{
+
+public:
+    // Returns the instance of the Singleton
+    static std::unique_ptr<CacheManager> &get();
+
+    /* @brief Sets the project whose data must be kept, and marks its data as used now
+       @param documentId the id of the project, which names its cache folder, or an empty string when the project is closed
+       @param proxyHashes the hashes of the clips of the project, which prefix the names of their proxy clips
+     */
+    void setCurrentProject(const QString &documentId, const QStringList &proxyHashes);
+
+    /* @brief Deletes the least recently used cache data in the global thread pool, until the cache fits in the budget
+       Does nothing if no budget is set or if an eviction is already running. The future holds the number of bytes freed.
+     */
+    QFuture<qint64> evict();
+
+protected:
+    // Constructor is protected because class is a Singleton
+    CacheManager();
+
+    static std::unique_ptr<CacheManager> instance;
+    static std::once_flag m_onceFlag; // flag to create the manager only once;
+
+    struct Artifact
+    {
+        QString path;
+        qint64 size;
+        qint64 lastAccess;
+    };
+
+    // Deletes data from the oldest until the data under root fits in budget, returns the freed size
+    static qint64 evictOldest(const QDir &root, qint64 budget, const QString &documentId, const QSet<QString> &proxyHashes);
+
+    QDir m_root;
+    QString m_documentId;
+    QSet<QString> m_proxyHashes;
+    // Marks the cache folder of the open project as in use
+    std::unique_ptr<QLockFile> m_lock;
+    QTimer m_timer;
+    QMutex m_mutex;
+    std::atomic<bool> m_running{false};
+};
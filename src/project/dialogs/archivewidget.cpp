@@ -25,6 +25,7 @@
 #include "core.h"
 #include "projectsettings.h"
 #include "titler/titlewidget.h"
+#include "utils/filehashcache.hpp"
 #include "xml/xml.hpp"
 
 #include "kdenlive_debug.h"
@@ -33,23 +34,115 @@
 #include <KGuiItem>
 #include <KMessageBox>
 #include <KMessageWidget>
+#include <KCompressionDevice>
 #include <KTar>
 #include <KZip>
 #include <kio/directorysizejob.h>
 #include <klocalizedstring.h>
 
+#include <QMutex>
+#include <QThreadPool>
 #include <QTreeWidget>
 #include <QtConcurrent>
+#include <algorithm>
 #include <utility>
+
+#ifdef Q_OS_LINUX
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Number of files copied at the same time when archiving to a folder
+const int copyStreams = 4;
+const qint64 copyChunkSize = 4 * 1024 * 1024;
+
+/** @brief Returns true if both files have the same content, comparing their memoized hashes before reading them. */
+bool sameContent(const QString &first, const QString &second, const std::atomic<bool> &abort)
+{
+    if (FileHashCache::get()->fileHash(first).first != FileHashCache::get()->fileHash(second).first) {
+        return false;
+    }
+    QFile a(first);
+    QFile b(second);
+    if (!a.open(QIODevice::ReadOnly) || !b.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    while (!a.atEnd()) {
+        if (abort || a.read(copyChunkSize) != b.read(copyChunkSize)) {
+            return false;
+        }
+    }
+    return b.atEnd();
+}
+
+/** @brief Copies a file, letting the kernel clone or copy the data when the filesystem supports it.
+ *  @param copied is increased by the number of bytes written as the copy progresses
+ */
+bool copyFile(const QString &source, const QString &destination, std::atomic<qint64> &copied, const std::atomic<bool> &abort)
+{
+    QFile src(source);
+    QFile dest(destination);
+    if (!src.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    if (dest.exists()) {
+        dest.remove();
+    }
+    if (!dest.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    const qint64 size = src.size();
+    qint64 done = 0;
+#ifdef Q_OS_LINUX
+#ifdef FICLONE
+    // Copy on write filesystems (btrfs, xfs) share the data blocks
+    if (ioctl(dest.handle(), FICLONE, src.handle()) == 0) {
+        done = size;
+        copied += size;
+    }
+#endif
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    while (done < size && !abort) {
+        ssize_t written = copy_file_range(src.handle(), nullptr, dest.handle(), nullptr, static_cast<size_t>(qMin(copyChunkSize, size - done)), 0);
+        if (written <= 0) {
+            // Not supported, for example across filesystems, continue with a buffered copy
+            break;
+        }
+        done += written;
+        copied += written;
+    }
+#endif
+    if (!src.seek(done) || !dest.seek(done)) {
+        return false;
+    }
+#endif
+    while (done < size && !abort) {
+        const QByteArray data = src.read(copyChunkSize);
+        if (data.isEmpty() || dest.write(data) != data.size()) {
+            return false;
+        }
+        done += data.size();
+        copied += data.size();
+    }
+    if (abort) {
+        dest.remove();
+        return false;
+    }
+    dest.setFileTime(QFileInfo(source).lastModified(), QFileDevice::FileModificationTime);
+    return true;
+}
+} // namespace
 ArchiveWidget::ArchiveWidget(const QString &projectName, const QString xmlData, const QStringList &luma_list, QWidget *parent)
     : QDialog(parent)
     , m_requestedSize(0)
-    , m_copyJob(nullptr)
+    , m_copiedSize(0)
+    , m_copyTotal(0)
     , m_name(projectName.section(QLatin1Char('.'), 0, -2))
     , m_temp(nullptr)
     , m_abortArchive(false)
     , m_extractMode(false)
-    , m_progressTimer(nullptr)
     , m_extractArchive(nullptr)
     , m_missingClips(0)
 {
@@ -59,7 +152,12 @@ ArchiveWidget::ArchiveWidget(const QString &projectName, const QString xmlData,
     archive_url->setUrl(QUrl::fromLocalFile(QDir::homePath()));
     connect(archive_url, &KUrlRequester::textChanged, this, &ArchiveWidget::slotCheckSpace);
     connect(this, &ArchiveWidget::archivingFinished, this, &ArchiveWidget::slotArchivingBoolFinished);
-    connect(this, &ArchiveWidget::archiveProgress, this, &ArchiveWidget::slotArchivingIntProgress);
+    connect(this, &ArchiveWidget::copyFinished, this, &ArchiveWidget::slotArchivingFinished);
+    connect(this, &ArchiveWidget::showMessage, this, &ArchiveWidget::slotDisplayMessage);
+    m_progressTimer = new QTimer;
+    m_progressTimer->setInterval(500);
+    m_progressTimer->setSingleShot(false);
+    connect(m_progressTimer, &QTimer::timeout, this, &ArchiveWidget::slotArchivingProgress);
     connect(proxy_only, &QCheckBox::stateChanged, this, &ArchiveWidget::slotProxyOnly);
     connect(timeline_archive, &QCheckBox::stateChanged, this, &ArchiveWidget::onlyTimelineItems);
 
@@ -226,7 +324,8 @@ ArchiveWidget::ArchiveWidget(const QString &projectName, const QString xmlData,
 ArchiveWidget::ArchiveWidget(QUrl url, QWidget *parent)
     : QDialog(parent)
     , m_requestedSize(0)
-    , m_copyJob(nullptr)
+    , m_copiedSize(0)
+    , m_copyTotal(0)
     , m_temp(nullptr)
     , m_abortArchive(false)
     , m_extractMode(true)
@@ -334,9 +433,8 @@ bool ArchiveWidget::closeAccepted()
                                                KGuiItem(i18n("Stop Archiving"))) != KMessageBox::Continue) {
             return false;
         }
-        if (m_copyJob) {
-            m_copyJob->kill();
-        }
+        m_abortArchive = true;
+        m_archiveThread.waitForFinished();
     }
     return true;
 }
@@ -528,171 +626,156 @@ void ArchiveWidget::slotCheckSpace()
     }
 }
 
-bool ArchiveWidget::slotStartArchiving(bool firstPass)
+bool ArchiveWidget::slotStartArchiving()
 {
-    if (firstPass && ((m_copyJob != nullptr) || m_archiveThread.isRunning())) {
+    if (m_archiveThread.isRunning()) {
         // archiving in progress, abort
-        if (m_copyJob) {
-            m_copyJob->kill(KJob::EmitResult);
-        }
         m_abortArchive = true;
         return true;
     }
     m_infoMessage->setMessageType(KMessageWidget::Information);
     m_infoMessage->setText(i18n("Starting archive job"));
     m_infoMessage->animatedShow();
-    
-    bool isArchive = compressed_archive->isChecked();
-    if (!firstPass) {
-        m_copyJob = nullptr;
-    } else {
-        // starting archiving
-        m_abortArchive = false;
-        m_duplicateFiles.clear();
-        m_replacementList.clear();
-        m_foldersList.clear();
-        m_filesList.clear();
-        slotDisplayMessage(QStringLiteral("system-run"), i18n("Archiving..."));
-        repaint();
-        archive_url->setEnabled(false);
-        proxy_only->setEnabled(false);
-        compressed_archive->setEnabled(false);
-    }
-    QList<QUrl> files;
-    QUrl destUrl;
-    QString destPath;
-    QTreeWidgetItem *parentItem;
-    bool isSlideshow = false;
-    int items = 0;
-
-    // We parse all files going into one folder, then start the copy job
+
+    // starting archiving
+    m_abortArchive = false;
+    m_copyTasks.clear();
+    m_dedupTargets.clear();
+    m_copyError.clear();
+    m_replacementList.clear();
+    m_foldersList.clear();
+    m_filesList.clear();
+    slotDisplayMessage(QStringLiteral("system-run"), i18n("Archiving..."));
+    repaint();
+    archive_url->setEnabled(false);
+    proxy_only->setEnabled(false);
+    compressed_archive->setEnabled(false);
+
+    // Collect all files with their path in the archive, they are then copied in a single job
     for (int i = 0; i < files_list->topLevelItemCount(); ++i) {
-        parentItem = files_list->topLevelItem(i);
-        if (parentItem->isDisabled()) {
-            parentItem->setExpanded(false);
+        QTreeWidgetItem *parentItem = files_list->topLevelItem(i);
+        parentItem->setExpanded(false);
+        if (parentItem->isDisabled() || parentItem->childCount() == 0) {
             continue;
         }
-        if (parentItem->childCount() > 0) {
-            if (parentItem->data(0, Qt::UserRole).toString() == QLatin1String("slideshows")) {
-                QUrl slideFolder = QUrl::fromLocalFile(archive_url->url().toLocalFile() + QStringLiteral("/slideshows"));
-                if (isArchive) {
-                    m_foldersList.append(QStringLiteral("slideshows"));
-                } else {
-                    QDir dir(slideFolder.toLocalFile());
-                    if (!dir.mkpath(QStringLiteral("."))) {
-                        KMessageBox::sorry(this, i18n("Cannot create directory %1", slideFolder.toLocalFile()));
-                    }
-                }
-                isSlideshow = true;
-            } else {
-                isSlideshow = false;
+        const QString destPath = parentItem->data(0, Qt::UserRole).toString() + QLatin1Char('/');
+        bool isSlideshow = parentItem->data(0, Qt::UserRole).toString() == QLatin1String("slideshows");
+        for (int j = 0; j < parentItem->childCount(); ++j) {
+            QTreeWidgetItem *item = parentItem->child(j);
+            if (item->isDisabled() || item->isHidden()) {
+                continue;
             }
-            files_list->setCurrentItem(parentItem);
-            parentItem->setExpanded(true);
-            destPath = parentItem->data(0, Qt::UserRole).toString() + QLatin1Char('/');
-            destUrl = QUrl::fromLocalFile(archive_url->url().toLocalFile() + QLatin1Char('/') + destPath);
-            QTreeWidgetItem *item;
-            for (int j = 0; j < parentItem->childCount(); ++j) {
-                item = parentItem->child(j);
-                if (item->isDisabled() || item->isHidden()) {
-                    continue;
-                }
-                // Special case: slideshows
-                items++;
-                if (isSlideshow) {
-                    destPath += item->data(0, Qt::UserRole).toString() + QLatin1Char('/');
-                    destUrl = QUrl::fromLocalFile(archive_url->url().toLocalFile() + QDir::separator() + destPath);
-                    QStringList srcFiles = item->data(0, Qt::UserRole + 1).toStringList();
-                    for (int k = 0; k < srcFiles.count(); ++k) {
-                        files << QUrl::fromLocalFile(srcFiles.at(k));
-                    }
-                    item->setDisabled(true);
-                    if (parentItem->indexOfChild(item) == parentItem->childCount() - 1) {
-                        // We have processed all slideshows
-                        parentItem->setDisabled(true);
-                    }
-                    break;
-                } else if (item->data(0, Qt::UserRole).isNull()) {
-                    files << QUrl::fromLocalFile(item->text(0));
-                } else {
-                    // We must rename the destination file, since another file with same name exists
-                    // TODO: monitor progress
-                    if (isArchive) {
-                        m_filesList.insert(item->text(0), destPath + item->data(0, Qt::UserRole).toString());
-                    } else {
-                        m_duplicateFiles.insert(QUrl::fromLocalFile(item->text(0)),
-                                                QUrl::fromLocalFile(destUrl.toLocalFile() + QLatin1Char('/') + item->data(0, Qt::UserRole).toString()));
-                    }
+            if (isSlideshow) {
+                // Slideshow frames must stay together in their own folder
+                const QString slideFolder = destPath + item->data(0, Qt::UserRole).toString() + QLatin1Char('/');
+                const QStringList srcFiles = item->data(0, Qt::UserRole + 1).toStringList();
+                for (const QString &src : srcFiles) {
+                    m_copyTasks.append({src, slideFolder + QFileInfo(src).fileName(), false});
                 }
+            } else if (item->data(0, Qt::UserRole).isNull()) {
+                m_copyTasks.append({item->text(0), destPath + QFileInfo(item->text(0)).fileName(), true});
+            } else {
+                // We must rename the destination file, since another file with same name exists
+                m_copyTasks.append({item->text(0), destPath + item->data(0, Qt::UserRole).toString(), true});
             }
-            if (!isSlideshow) {
-                parentItem->setDisabled(true);
-            }
-            break;
         }
+        parentItem->setDisabled(true);
     }
 
-    if (items == 0) {
+    if (m_copyTasks.isEmpty()) {
         // No clips to archive
-        slotArchivingFinished(nullptr, true);
+        slotArchivingFinished(true);
         return true;
     }
+    progressBar->setValue(0);
+    buttonBox->button(QDialogButtonBox::Apply)->setText(i18n("Abort"));
+    m_copiedSize = 0;
+    m_copyTotal = 0;
+    m_copyTime.start();
+    m_progressTimer->start();
+    const QString archiveFolder = archive_url->url().toLocalFile();
+    bool isArchive = compressed_archive->isChecked();
+    m_archiveThread = QtConcurrent::run([this, archiveFolder, isArchive]() { emit copyFinished(copyFiles(archiveFolder, isArchive)); });
+    return true;
+}
 
-    if (destPath.isEmpty()) {
-        if (m_duplicateFiles.isEmpty()) {
+bool ArchiveWidget::copyFiles(const QString &archiveFolder, bool isArchive)
+{
+    emit showMessage(QStringLiteral("system-run"), i18n("Looking for duplicate files..."));
+    // Identical files (same size, same hash, same content) are only archived once
+    QVector<CopyTask> uniqueTasks;
+    QMultiHash<qint64, int> sizes;
+    for (const CopyTask &task : qAsConst(m_copyTasks)) {
+        if (m_abortArchive) {
             return false;
         }
-        QMapIterator<QUrl, QUrl> i(m_duplicateFiles);
-        if (i.hasNext()) {
-            i.next();
-            QUrl startJobSrc = i.key();
-            QUrl startJobDst = i.value();
-            m_duplicateFiles.remove(startJobSrc);
-            m_infoMessage->setText(i18n("Copying %1", startJobSrc.fileName()));
-            KIO::CopyJob *job = KIO::copyAs(startJobSrc, startJobDst, KIO::HideProgressInfo);
-            connect(job, &KJob::result, this, [this] (KJob *jb) {
-                slotArchivingFinished(jb, false);
-            });
-            connect(job, &KJob::processedSize, this, &ArchiveWidget::slotArchivingProgress);
+        const qint64 size = QFileInfo(task.source).size();
+        QString sharedPath;
+        if (task.canShare) {
+            for (auto it = sizes.constFind(size); it != sizes.constEnd() && it.key() == size; ++it) {
+                const CopyTask &candidate = uniqueTasks.at(it.value());
+                if (candidate.source == task.source || sameContent(candidate.source, task.source, m_abortArchive)) {
+                    sharedPath = candidate.destination;
+                    break;
+                }
+            }
+        }
+        if (sharedPath.isEmpty()) {
+            sizes.insert(size, uniqueTasks.size());
+            uniqueTasks.append(task);
+            uniqueTasks.last().size = size;
+            m_copyTotal += size;
+        } else if (sharedPath != task.destination) {
+            m_dedupTargets.insert(task.source, sharedPath);
         }
-        return true;
+    }
+    if (!m_dedupTargets.isEmpty()) {
+        qCDebug(KDENLIVE_LOG) << "// Archiving skips" << m_dedupTargets.count() << "duplicate files";
     }
 
     if (isArchive) {
-        m_foldersList.append(destPath);
-        for (int i = 0; i < files.count(); ++i) {
-            m_filesList.insert(files.at(i).toLocalFile(), destPath + files.at(i).fileName());
-        }
-        slotArchivingFinished();
-    } else if (files.isEmpty()) {
-        slotStartArchiving(false);
-    } else {
-        QDir dir(destUrl.toLocalFile());
-        if (!dir.mkpath(QStringLiteral("."))) {
-            KMessageBox::sorry(this, i18n("Cannot create directory %1", destUrl.toLocalFile()));
+        // Files are compressed later, together with the project file
+        for (const CopyTask &task : qAsConst(uniqueTasks)) {
+            const QString folder = task.destination.section(QLatin1Char('/'), 0, -2);
+            if (!m_foldersList.contains(folder)) {
+                m_foldersList.append(folder);
+            }
+            m_filesList.insert(task.source, task.destination);
         }
-        m_copyJob = KIO::copy(files, destUrl, KIO::HideProgressInfo);
-        connect(m_copyJob, &KJob::result, this, [this] (KJob *jb) {
-            slotArchivingFinished(jb, false);
-        });
-        connect(m_copyJob, &KJob::processedSize, this, &ArchiveWidget::slotArchivingProgress);
+        return true;
     }
-    if (firstPass) {
-        progressBar->setValue(0);
-        buttonBox->button(QDialogButtonBox::Apply)->setText(i18n("Abort"));
+
+    // Copy the largest files first so that the streams end together
+    std::sort(uniqueTasks.begin(), uniqueTasks.end(), [](const CopyTask &a, const CopyTask &b) { return a.size > b.size; });
+    QThreadPool pool;
+    pool.setMaxThreadCount(copyStreams);
+    QMutex errorMutex;
+    std::atomic<bool> failed(false);
+    for (const CopyTask &task : qAsConst(uniqueTasks)) {
+        QtConcurrent::run(&pool, [this, task, archiveFolder, &errorMutex, &failed]() {
+            if (m_abortArchive || failed) {
+                return;
+            }
+            const QString dest = archiveFolder + QLatin1Char('/') + task.destination;
+            if (!QDir().mkpath(QFileInfo(dest).absolutePath()) || !copyFile(task.source, dest, m_copiedSize, m_abortArchive)) {
+                if (!m_abortArchive) {
+                    QMutexLocker lk(&errorMutex);
+                    failed = true;
+                    m_copyError = task.source;
+                }
+            }
+        });
     }
-    return true;
+    pool.waitForDone();
+    return !failed && !m_abortArchive;
 }
 
-void ArchiveWidget::slotArchivingFinished(KJob *job, bool finished)
+void ArchiveWidget::slotArchivingFinished(bool success)
 {
-    if (job == nullptr || job->error() == 0) {
-        if (!finished && slotStartArchiving(false)) {
-            // We still have files to archive
-            return;
-        }
+    if (success) {
         if (!compressed_archive->isChecked()) {
             // Archiving finished
+            m_progressTimer->stop();
             progressBar->setValue(100);
             if (processProjectFile()) {
                 slotJobResult(true, i18n("Project was successfully archived."));
@@ -700,29 +783,47 @@ void ArchiveWidget::slotArchivingFinished(KJob *job, bool finished)
                 slotJobResult(false, i18n("There was an error processing project file"));
             }
         } else {
-            processProjectFile();
+            // Compression runs in its own thread, which emits archivingFinished. Also emit it if the archive was not started
+            if (!processProjectFile()) {
+                emit archivingFinished(false);
+            }
+            return;
         }
     } else {
-        m_copyJob = nullptr;
-        slotJobResult(false, i18n("There was an error while copying the files: %1", job->errorString()));
-    }
-    if (!compressed_archive->isChecked()) {
-        buttonBox->button(QDialogButtonBox::Apply)->setText(i18n("Archive"));
-        archive_url->setEnabled(true);
-        proxy_only->setEnabled(true);
-        compressed_archive->setEnabled(true);
-        for (int i = 0; i < files_list->topLevelItemCount(); ++i) {
-            files_list->topLevelItem(i)->setDisabled(false);
-            for (int j = 0; j < files_list->topLevelItem(i)->childCount(); ++j) {
-                files_list->topLevelItem(i)->child(j)->setDisabled(false);
-            }
+        m_progressTimer->stop();
+        if (m_abortArchive) {
+            slotJobResult(false, i18n("Archiving was aborted"));
+        } else {
+            slotJobResult(false, i18n("There was an error while copying the files: %1", m_copyError));
+        }
+    }
+    buttonBox->button(QDialogButtonBox::Apply)->setText(i18n("Archive"));
+    archive_url->setEnabled(true);
+    proxy_only->setEnabled(true);
+    compressed_archive->setEnabled(true);
+    for (int i = 0; i < files_list->topLevelItemCount(); ++i) {
+        files_list->topLevelItem(i)->setDisabled(false);
+        for (int j = 0; j < files_list->topLevelItem(i)->childCount(); ++j) {
+            files_list->topLevelItem(i)->child(j)->setDisabled(false);
         }
     }
 }
 
-void ArchiveWidget::slotArchivingProgress(KJob *, qulonglong size)
+void ArchiveWidget::slotArchivingProgress()
 {
-    progressBar->setValue(static_cast<int>(100 * size / m_requestedSize));
+    qint64 total = m_copyTotal;
+    qint64 copied = m_copiedSize;
+    if (total <= 0) {
+        return;
+    }
+    progressBar->setValue(static_cast<int>(100 * copied / total));
+    qint64 elapsed = m_copyTime.elapsed();
+    if (copied == 0 || elapsed < 1000) {
+        return;
+    }
+    qint64 rate = copied * 1000 / elapsed;
+    m_infoMessage->setText(i18n("Archiving at %1/s, %2 remaining", KIO::convertSize(static_cast<KIO::filesize_t>(rate)),
+                                KIO::convertSeconds(static_cast<unsigned int>((total - copied) / qMax<qint64>(1, rate)))));
 }
 
 bool ArchiveWidget::processProjectFile()
@@ -747,6 +848,10 @@ bool ArchiveWidget::processProjectFile()
                 } else {
                     dest = QUrl::fromLocalFile(parentItem->data(0, Qt::UserRole).toString() + QLatin1Char('/') + item->data(0, Qt::UserRole).toString());
                 }
+                if (m_dedupTargets.contains(item->text(0))) {
+                    // An identical file was archived in place of this one
+                    dest = QUrl::fromLocalFile(m_dedupTargets.value(item->text(0)));
+                }
                 m_replacementList.insert(src, dest);
             }
         }
@@ -883,13 +988,26 @@ bool ArchiveWidget::processProjectFile()
     }
     m_archiveName.clear();
     if (isArchive) {
+        // Widgets and dialogs are only used from here, the archive is then written in a thread
+        const QString archiveFolder = archive_url->url().toLocalFile();
+        const bool zip = compression_type->currentIndex() == 1;
+        QString archiveName = archiveFolder + QDir::separator() + m_name + (zip ? QStringLiteral(".zip") : QStringLiteral(".tar.gz"));
+        if (QFile::exists(archiveName) &&
+            KMessageBox::questionYesNo(this, i18n("File %1 already exists.\nDo you want to overwrite it?", archiveName)) == KMessageBox::No) {
+            return false;
+        }
+        m_archiveName = archiveName;
         m_temp = new QTemporaryFile;
         if (!m_temp->open()) {
             KMessageBox::error(this, i18n("Cannot create temporary file"));
         }
         m_temp->write(playList.toUtf8());
         m_temp->close();
-        m_archiveThread = QtConcurrent::run(this, &ArchiveWidget::createArchive);
+        m_copiedSize = 0;
+        m_copyTotal = 0;
+        m_copyTime.start();
+        m_progressTimer->start();
+        m_archiveThread = QtConcurrent::run([this, archiveName, archiveFolder, zip]() { createArchive(archiveName, archiveFolder, zip); });
         return true;
     }
 
@@ -944,47 +1062,46 @@ bool ArchiveWidget::processProjectFile()
     return true;
 }
 
-void ArchiveWidget::createArchive()
+void ArchiveWidget::createArchive(const QString &archiveName, const QString &archiveFolder, bool zip)
 {
-    m_archiveName = QString(archive_url->url().toLocalFile() + QDir::separator() + m_name);
-    if (compression_type->currentIndex() == 1) {
-        m_archiveName.append(QStringLiteral(".zip"));
-    } else {
-        m_archiveName.append(QStringLiteral(".tar.gz"));
-    }
-    if (QFile::exists(m_archiveName) &&
-        KMessageBox::questionYesNo(this, i18n("File %1 already exists.\nDo you want to overwrite it?", m_archiveName)) == KMessageBox::No) {
-        return;
-    }
-    QFileInfo dirInfo(archive_url->url().toLocalFile());
+    QFileInfo dirInfo(archiveFolder);
     QString user = dirInfo.owner();
     QString group = dirInfo.group();
+    qint64 total = 0;
+    for (const QString &path : m_filesList.keys()) {
+        total += QFileInfo(path).size();
+    }
+    m_copyTotal = total;
+    // The compressed stream is written directly to the final file, without an intermediate tar file
+    std::unique_ptr<QIODevice> device;
     std::unique_ptr<KArchive> archive;
-    if (compression_type->currentIndex() == 1) {
-        archive.reset(new KZip(m_archiveName));
+    if (zip) {
+        archive.reset(new KZip(archiveName));
     } else {
-        archive.reset(new KTar(m_archiveName, QStringLiteral("application/x-gzip")));
+        device.reset(new KCompressionDevice(new QFile(archiveName), true, KCompressionDevice::GZip));
+        archive.reset(new KTar(device.get()));
     }
-    archive->open(QIODevice::WriteOnly);
+    bool success = archive->open(QIODevice::WriteOnly);
 
     // Create folders
     for (const QString &path : qAsConst(m_foldersList)) {
+        if (!success) {
+            break;
+        }
         archive->writeDir(path, user, group);
     }
 
     // Add files
-    int ix = 0;
-    bool success = true; 
     QMapIterator<QString, QString> i(m_filesList);
-    while (i.hasNext()) {
+    while (success && i.hasNext()) {
         i.next();
-        m_infoMessage->setText(i18n("Archiving %1", i.key()));
-        success = archive->addLocalFile(i.key(), i.value());
-        emit archiveProgress((int)100 * ix / m_filesList.count());
-        ix++;
-        if (!success) {
+        if (m_abortArchive) {
+            success = false;
             break;
         }
+        emit showMessage(QStringLiteral("system-run"), i18n("Archiving %1", QFileInfo(i.key()).fileName()));
+        success = archive->addLocalFile(i.key(), i.value());
+        m_copiedSize += QFileInfo(i.key()).size();
     }
 
     // Add project file
@@ -1001,11 +1118,16 @@ void ArchiveWidget::createArchive()
     } else {
         archive->close();
     }
+    archive.reset();
+    if (device) {
+        device->close();
+    }
     emit archivingFinished(success);
 }
 
 void ArchiveWidget::slotArchivingBoolFinished(bool result)
 {
+    m_progressTimer->stop();
     if (result) {
         slotJobResult(true, i18n("Project was successfully archived.\n%1", m_archiveName));
         buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
@@ -1025,11 +1147,6 @@ void ArchiveWidget::slotArchivingBoolFinished(bool result)
     }
 }
 
-void ArchiveWidget::slotArchivingIntProgress(int p)
-{
-    progressBar->setValue(p);
-}
-
 void ArchiveWidget::slotStartExtracting()
 {
     if (m_archiveThread.isRunning()) {
@@ -23,13 +23,15 @@
 #include "ui_archivewidget_ui.h"
 #include "timeline2/model/timelinemodel.hpp"
 
-#include <KIO/CopyJob>
 #include <QTemporaryFile>
 #include <kio/global.h>
 
 #include <QDialog>
 #include <QDomDocument>
+#include <QElapsedTimer>
 #include <QFuture>
+#include <QVector>
+#include <atomic>
 #include <memory>
 
 class KJob;
@@ -56,13 +58,11 @@ public:
 
 private slots:
     void slotCheckSpace();
-    bool slotStartArchiving(bool firstPass = true);
-    void slotArchivingFinished(KJob *job = nullptr, bool finished = false);
-    void slotArchivingProgress(KJob *, qulonglong);
+    bool slotStartArchiving();
+    void slotArchivingFinished(bool success);
+    void slotArchivingProgress();
     void done(int r) Q_DECL_OVERRIDE;
     bool closeAccepted();
-    void createArchive();
-    void slotArchivingIntProgress(int);
     void slotArchivingBoolFinished(bool result);
     void slotStartExtracting();
     void doExtracting();
@@ -80,14 +80,28 @@ protected:
 
 private:
     KIO::filesize_t m_requestedSize, m_timelineSize;
-    KIO::CopyJob *m_copyJob;
-    QMap<QUrl, QUrl> m_duplicateFiles;
+    /** @brief A file to archive, with its path relative to the archive folder. */
+    struct CopyTask
+    {
+        QString source;
+        QString destination;
+        /** @brief False if the file cannot be replaced by an identical one stored elsewhere (slideshow frames). */
+        bool canShare;
+        qint64 size;
+    };
+    QVector<CopyTask> m_copyTasks;
+    /** @brief Files that are not archived because an identical file is, with the path of that file in the archive. */
+    QMap<QString, QString> m_dedupTargets;
+    QString m_copyError;
+    std::atomic<qint64> m_copiedSize;
+    std::atomic<qint64> m_copyTotal;
+    QElapsedTimer m_copyTime;
     QMap<QUrl, QUrl> m_replacementList;
     QString m_name;
     QString m_archiveName;
     QDomDocument m_doc;
     QTemporaryFile *m_temp;
-    bool m_abortArchive;
+    std::atomic<bool> m_abortArchive;
     QFuture<void> m_archiveThread;
     QStringList m_foldersList;
     QMap<QString, QString> m_filesList;
@@ -103,12 +117,16 @@ private:
     void generateItems(QTreeWidgetItem *parentItem, const QStringList &items);
     /** @brief Generate tree widget subitems from a map of clip ids / urls. */
     void generateItems(QTreeWidgetItem *parentItem, const QMap<QString, QString> &items);
+    /** @brief Skip duplicate files and, when not compressing, copy the others to the archive folder. Runs in a thread. */
+    bool copyFiles(const QString &archiveFolder, bool isArchive);
     /** @brief Replace urls in project file. */
     bool processProjectFile();
+    /** @brief Write the compressed archive, runs in a thread. Emits archivingFinished on every exit path. */
+    void createArchive(const QString &archiveName, const QString &archiveFolder, bool zip);
 
 signals:
     void archivingFinished(bool);
-    void archiveProgress(int);
+    void copyFinished(bool);
     void extractingFinished();
     void showMessage(const QString &, const QString &);
 };
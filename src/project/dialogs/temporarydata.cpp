@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "kdenlivesettings.h"
 #include "core.h"
 #include "bin/bin.h"
+#include "project/cachemanager.hpp"
 
 #include <KLocalizedString>
 #include <KMessageBox>
@@ -724,6 +725,24 @@ void TemporaryData::buildGlobalCacheDialog(int minHeight)
     });
     hLay->addWidget(age);
     lay->addLayout(hLay);
+
+    // Config cache budget
+    hLay = new QHBoxLayout;
+    hLay->addWidget(new QLabel(i18n("Limit cache data to"), this));
+    QSpinBox *limit = new QSpinBox(this);
+    limit->setRange(0, 10000);
+    limit->setSpecialValueText(i18n("No limit"));
+    limit->setSuffix(i18n(" GiB"));
+    limit->setValue(KdenliveSettings::cachesizelimit());
+    limit->setToolTip(i18n("Least recently used cache data of other projects is deleted when the limit is exceeded"));
+    connect(limit, &QSpinBox::editingFinished, [limit] () {
+        if (limit->value() != KdenliveSettings::cachesizelimit()) {
+            KdenliveSettings::setCachesizelimit(limit->value());
+            CacheManager::get()->evict();
+        }
+    });
+    hLay->addWidget(limit);
+    lay->addLayout(hLay);
     lay->addStretch(10);
 
     processBackupDirectories();
@@ -18,10 +18,13 @@ the Free Software Foundation, either version 3 of the License, or
 #include "mainwindow.h"
 #include "monitor/monitormanager.h"
 #include "profiles/profilemodel.hpp"
+#include "project/cachemanager.hpp"
 #include "project/dialogs/archivewidget.h"
 #include "project/dialogs/backupwidget.h"
 #include "project/dialogs/noteswidget.h"
 #include "project/dialogs/projectsettings.h"
+#include "utils/filehashcache.hpp"
+#include "utils/latencystats.hpp"
 #include "utils/thumbnailcache.hpp"
 #include "xml/xml.hpp"
 
@@ -268,6 +271,9 @@ bool ProjectManager::closeCurrentDocument(bool saveChanges, bool quit)
     ::mlt_pool_purge();
     pCore->audioThumbCache.clear();
     pCore->jobManager()->slotCancelJobs();
+    FileHashCache::get()->save();
+    // Release the cache folder of the project
+    CacheManager::get()->setCurrentProject(QString(), QStringList());
     disconnect(pCore->window()->getMainTimeline()->controller(), &TimelineController::durationChanged, this, &ProjectManager::adjustProjectDuration);
     pCore->window()->getMainTimeline()->controller()->clipActions.clear();
     if (!quit && !qApp->isSavingSession()) {
@@ -598,6 +604,9 @@ void ProjectManager::doOpenFile(const QUrl &url, KAutoSaveFile *stale)
                                                                   m_project->getDocumentProperty(QStringLiteral("disablepreview")).toInt());
 
     emit docOpened(m_project);
+    // Keep the data of this project and trim the cache of older ones
+    CacheManager::get()->setCurrentProject(m_project->getDocumentProperty(QStringLiteral("documentid")), m_project->getProxyHashList());
+    CacheManager::get()->evict();
     pCore->displayMessage(QString(), OperationCompletedMessage, 100);
     if (openBackup) {
         slotOpenBackup(url);
@@ -679,6 +688,7 @@ void ProjectManager::slotStartAutoSave()
 
 void ProjectManager::slotAutoSave()
 {
+    LatencyProbe probe("project.autosave");
     prepareSave();
     QString saveFolder = m_project->url().adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).toLocalFile();
     QString scene = projectSceneList(saveFolder);
@@ -696,6 +706,9 @@ void ProjectManager::slotAutoSave()
     }
     m_project->slotAutoSave(scene);
     m_lastSave.start();
+    // Data created since the project was opened may have filled the cache
+    CacheManager::get()->setCurrentProject(m_project->getDocumentProperty(QStringLiteral("documentid")), m_project->getProxyHashList());
+    CacheManager::get()->evict();
 }
 
 QString ProjectManager::projectSceneList(const QString &outputFolder, const QString overlayData)
@@ -37,7 +37,7 @@
 Spectrogram::Spectrogram(QWidget *parent)
     : AbstractAudioScopeWidget(true, parent)
     , m_fftTools()
-    , m_fftHistory()
+    , m_fftHistory(SPECTROGRAM_HISTORY_SIZE)
     , m_fftHistoryImg()
 
 {
@@ -80,13 +80,22 @@ Spectrogram::Spectrogram(QWidget *parent)
 
     AbstractScopeWidget::init();
 
+    const QVector<QRgb> colors = colorMap();
+    std::copy(colors.constBegin(), colors.constEnd(), m_colorMap);
+}
+
+// static
+QVector<QRgb> Spectrogram::colorMap()
+{
+    QVector<QRgb> colors(256);
     for (int i = 0; i <= 255 / 5; ++i) {
-        m_colorMap[i + 0 * 255 / 5] = qRgb(0, 0, i * 5);         // black to blue
-        m_colorMap[i + 1 * 255 / 5] = qRgb(0, i * 5, 255);       // blue to cyan
-        m_colorMap[i + 2 * 255 / 5] = qRgb(0, 255, 255 - i * 5); // cyan to green
-        m_colorMap[i + 3 * 255 / 5] = qRgb(i * 5, 255, 0);       // green to yellow
-        m_colorMap[i + 4 * 255 / 5] = qRgb(255, 255 - i * 5, 0); // yellow to red
+        colors[i + 0 * 255 / 5] = qRgb(0, 0, i * 5);         // black to blue
+        colors[i + 1 * 255 / 5] = qRgb(0, i * 5, 255);       // blue to cyan
+        colors[i + 2 * 255 / 5] = qRgb(0, 255, 255 - i * 5); // cyan to green
+        colors[i + 3 * 255 / 5] = qRgb(i * 5, 255, 0);       // green to yellow
+        colors[i + 4 * 255 / 5] = qRgb(255, 255 - i * 5, 0); // yellow to red
     }
+    return colors;
 }
 
 Spectrogram::~Spectrogram()
@@ -319,20 +328,20 @@ QImage Spectrogram::renderAudioScope(uint, const audioShortVector &audioFrame, c
         m_ui->labelFFTSizeNumber->setText(QVariant(fftWindow).toString());
 
         if (newDataAvailable) {
-
-            auto *freqSpectrum = new float[(uint)fftWindow / 2];
+            // This method might be called also when a simple refresh is required.
+            // In this case there is no data to append to the history. Only append new data.
+            // The oldest spectrum is overwritten, its storage is only reallocated when the window size changes.
+            m_historyNewest = (m_historyNewest + 1) % SPECTROGRAM_HISTORY_SIZE;
+            QVector<float> &spectrumVector = m_fftHistory[m_historyNewest];
+            if (spectrumVector.size() != fftWindow / 2) {
+                spectrumVector.resize(fftWindow / 2);
+            }
+            m_historyCount = qMin(m_historyCount + 1, SPECTROGRAM_HISTORY_SIZE);
 
             // Get the spectral power distribution of the input samples,
             // using the given window size and function
             FFTTools::WindowType windowType = (FFTTools::WindowType)m_ui->windowFunction->itemData(m_ui->windowFunction->currentIndex()).toInt();
-            m_fftTools.fftNormalized(audioFrame, 0, (uint)num_channels, freqSpectrum, windowType, (uint)fftWindow, 0);
-
-            // This method might be called also when a simple refresh is required.
-            // In this case there is no data to append to the history. Only append new data.
-            QVector<float> spectrumVector(fftWindow / 2);
-            memcpy(spectrumVector.data(), &freqSpectrum[0], (uint)fftWindow / 2 * sizeof(float));
-            m_fftHistory.prepend(spectrumVector);
-            delete[] freqSpectrum;
+            m_fftTools.fftNormalized(audioFrame, 0, (uint)num_channels, spectrumVector.data(), windowType, (uint)fftWindow, 0);
         }
 #ifdef DEBUG_SPECTROGRAM
         else {
@@ -340,98 +349,81 @@ QImage Spectrogram::renderAudioScope(uint, const audioShortVector &audioFrame, c
         }
 #endif
 
-        // Limit the maximum history size to avoid wasting space
-        while (m_fftHistory.size() > SPECTROGRAM_HISTORY_SIZE) {
-            m_fftHistory.removeLast();
-        }
-
-        // Draw the spectrum
-        QImage spectrum(m_scopeRect.size(), QImage::Format_ARGB32);
-        spectrum.fill(qRgba(0, 0, 0, 0));
-        QPainter davinci(&spectrum);
         const int h = m_innerScopeRect.height();
         const int leftDist = m_innerScopeRect.left() - m_scopeRect.left();
         const int topDist = m_innerScopeRect.top() - m_scopeRect.top();
-        int windowSize;
-        int y;
-        bool completeRedraw = true;
-
-        if (m_fftHistoryImg.size() == m_scopeRect.size() && !m_parameterChanged) {
-            // The size of the widget and the parameters (like min/max dB) have not changed since last time,
-            // so we can re-use it, shift it by one pixel, and render the single remaining line. Usually about
-            // 10 times faster for a widget height of around 400 px.
-            if (newDataAvailable) {
-                davinci.drawImage(0, -1, m_fftHistoryImg);
-            } else {
-                // spectrum = m_fftHistoryImg does NOT work, leads to segfaults (anyone knows why, please tell me)
-                davinci.drawImage(0, 0, m_fftHistoryImg);
-            }
-            completeRedraw = false;
-        }
+        bool completeRedraw = false;
 
-        y = 0;
-        if ((newData != 0) || m_parameterChanged) {
+        if (m_fftHistoryImg.size() != m_innerScopeRect.size() || m_parameterChanged) {
+            // The size of the widget or the parameters (like min/max dB) have changed, render all the lines again from the history
             m_parameterChanged = false;
-            bool peak = false;
-
-            QVector<float> dbMap;
-            uint right;
-            ////////////////FIXME
-            for (auto &it : m_fftHistory) {
-
-                windowSize = it.size();
-
-                // Interpolate the frequency data to match the pixel coordinates
-                right = uint(((float)m_freqMax) / ((float)m_freq / 2.) * float(windowSize - 1));
-                dbMap = FFTTools::interpolatePeakPreserving(it, (uint)m_innerScopeRect.width(), 0, right, -180);
-
-                for (int i = 0; i < dbMap.size(); ++i) {
-                    float val;
-                    val = dbMap[i];
-                    peak = val > (float)m_dBmax;
-
-                    // Normalize dB value to [0 1], 1 corresponding to dbMax dB and 0 to dbMin dB
-                    val = (val - (float)m_dBmax) / (float)(m_dBmax - m_dBmin) + 1.;
-                    if (val < 0) {
-                        val = 0;
-                    } else if (val > 1) {
-                        val = 1;
-                    }
-                    if (!peak || !m_aHighlightPeaks->isChecked()) {
-                        spectrum.setPixel(leftDist + i, topDist + h - 1 - y, m_colorMap[(int)(val * 255)]);
-                    } else {
-                        spectrum.setPixel(leftDist + i, topDist + h - 1 - y, AbstractScopeWidget::colHighlightDark.rgba());
-                    }
-                }
-
-                y++;
-                if (y >= topDist + m_innerScopeRect.height()) {
-                    break;
-                }
-                if (!completeRedraw) {
-                    break;
-                }
+            completeRedraw = true;
+            m_fftHistoryImg = QImage(m_innerScopeRect.size(), QImage::Format_ARGB32);
+            m_fftHistoryImg.fill(qRgba(0, 0, 0, 0));
+            m_imgNewest = h - 1;
+            const int lines = qMin(m_historyCount, h);
+            for (int age = 0; age < lines; ++age) {
+                renderLine(m_fftHistory.at((m_historyNewest - age + SPECTROGRAM_HISTORY_SIZE) % SPECTROGRAM_HISTORY_SIZE), h - 1 - age);
             }
+        } else if (newDataAvailable) {
+            // Only render the new line, replacing the oldest one. Usually about 10 times faster for a widget height of around 400 px.
+            m_imgNewest = (m_imgNewest + 1) % h;
+            renderLine(m_fftHistory.at(m_historyNewest), m_imgNewest);
+        }
+
+        // Draw the spectrum, the lines of the history image are stored in a circular way: the oldest one follows the most recent one
+        QImage spectrum(m_scopeRect.size(), QImage::Format_ARGB32);
+        spectrum.fill(qRgba(0, 0, 0, 0));
+        QPainter davinci(&spectrum);
+        const int oldest = (m_imgNewest + 1) % h;
+        davinci.drawImage(QPoint(leftDist, topDist), m_fftHistoryImg, QRect(0, oldest, m_innerScopeRect.width(), h - oldest));
+        if (oldest > 0) {
+            davinci.drawImage(QPoint(leftDist, topDist + h - oldest), m_fftHistoryImg, QRect(0, 0, m_innerScopeRect.width(), oldest));
         }
 
 #ifdef DEBUG_SPECTROGRAM
-        qCDebug(KDENLIVE_LOG) << "Rendered " << y - topDist << "lines from " << m_fftHistory.size() << " available samples in " << start.elapsed() << " ms"
-                              << (completeRedraw ? "" : " (re-used old image)");
+        qCDebug(KDENLIVE_LOG) << "Rendered " << (completeRedraw ? qMin(m_historyCount, h) : 1) << "lines from " << m_historyCount << " available samples in "
+                              << timer.elapsed() << " ms" << (completeRedraw ? "" : " (re-used old image)");
         uint storedBytes = 0;
-        for (QList<QVector<float>>::iterator it = m_fftHistory.begin(); it != m_fftHistory.end(); ++it) {
-            storedBytes += (*it).size() * sizeof((*it)[0]);
+        for (const QVector<float> &line : qAsConst(m_fftHistory)) {
+            storedBytes += uint(line.size()) * sizeof(float);
         }
         qCDebug(KDENLIVE_LOG) << QString("Total storage used: %1 kB").arg((double)storedBytes / 1000, 0, 'f', 2);
+#else
+        Q_UNUSED(completeRedraw)
 #endif
 
-        m_fftHistoryImg = spectrum;
-
         emit signalScopeRenderingFinished((uint)timer.elapsed(), 1);
         return spectrum;
     }
     emit signalScopeRenderingFinished(0, 1);
     return QImage();
 }
+void Spectrogram::renderLine(const QVector<float> &spectrum, int line)
+{
+    // Interpolate the frequency data to match the pixel coordinates
+    const uint right = uint(((float)m_freqMax) / ((float)m_freq / 2.) * float(spectrum.size() - 1));
+    const QVector<float> dbMap = FFTTools::interpolatePeakPreserving(spectrum, (uint)m_fftHistoryImg.width(), 0, right, -180);
+    const bool highlightPeaks = m_aHighlightPeaks->isChecked();
+    const QRgb peakColor = AbstractScopeWidget::colHighlightDark.rgba();
+    auto *pixels = reinterpret_cast<QRgb *>(m_fftHistoryImg.scanLine(line));
+    for (int i = 0; i < dbMap.size(); ++i) {
+        float val = dbMap[i];
+        if (highlightPeaks && val > (float)m_dBmax) {
+            pixels[i] = peakColor;
+            continue;
+        }
+        // Normalize dB value to [0 1], 1 corresponding to dbMax dB and 0 to dbMin dB
+        val = (val - (float)m_dBmax) / (float)(m_dBmax - m_dBmin) + 1.;
+        if (val < 0) {
+            val = 0;
+        } else if (val > 1) {
+            val = 1;
+        }
+        pixels[i] = m_colorMap[(int)(val * 255)];
+    }
+}
+
 QImage Spectrogram::renderBackground(uint)
 {
     return QImage();
@@ -39,6 +39,8 @@ public:
     ~Spectrogram() override;
 
     QString widgetName() const override;
+    /** @brief The colors of the power levels, from the lowest to the highest */
+    static QVector<QRgb> colorMap();
 
 protected:
     ///// Implemented methods /////
@@ -63,8 +65,13 @@ private:
     QAction *m_aTrackMouse;
     QAction *m_aHighlightPeaks;
 
-    QList<QVector<float>> m_fftHistory;
+    /** @brief Circular buffer of the last spectra, m_historyNewest being the most recent one */
+    QVector<QVector<float>> m_fftHistory;
+    int m_historyNewest{-1};
+    int m_historyCount{0};
+    /** @brief One line per spectrum, circular like the history: m_imgNewest is the most recent line */
     QImage m_fftHistoryImg;
+    int m_imgNewest{0};
 
     int m_dBmin{-70};
     int m_dBmax{0};
@@ -77,6 +84,9 @@ private:
     QRect m_innerScopeRect;
     QRgb m_colorMap[256];
 
+    /** @brief Draws a spectrum on a line of the history image */
+    void renderLine(const QVector<float> &spectrum, int line);
+
 private slots:
     void slotResetMaxFreq();
 };
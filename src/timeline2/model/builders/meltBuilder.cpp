@@ -310,14 +310,28 @@ bool constructTrackFromMelt(const std::shared_ptr<TimelineItemModel> &timeline,
                             const std::unordered_map<QString, QString> &binIdCorresp, Fun &undo, Fun &redo, bool audioTrack, QString originalDecimalPoint, int playlist, QProgressDialog *progressDialog)
 {
     int max = track.count();
+    // Clips are created first, then inserted on the track in one pass
+    std::vector<std::pair<int, int>> loadedClips;
+    bool valid = true;
+    int pendingProgress = 0;
+    auto reportProgress = [&pendingProgress, progressDialog]() {
+        if (pendingProgress == 0) {
+            return;
+        }
+        if (progressDialog) {
+            progressDialog->setValue(progressDialog->value() + pendingProgress);
+        } else {
+            emit pCore->loadingMessageUpdated(QString(), pendingProgress);
+        }
+        pendingProgress = 0;
+    };
     for (int i = 0; i < max; i++) {
         if (track.is_blank(i)) {
             continue;
         }
-        if (progressDialog) {
-            progressDialog->setValue(progressDialog->value() + 1);
-        } else {
-            emit pCore->loadingMessageUpdated(QString(), 1);
+        // Updating the progress dialog processes events, don't do it for each clip
+        if (++pendingProgress == 50) {
+            reportProgress();
         }
         std::shared_ptr<Mlt::Producer> clip(track.get_clip(i));
         int position = track.clip_start(i);
@@ -353,20 +367,13 @@ bool constructTrackFromMelt(const std::shared_ptr<TimelineItemModel> &timeline,
                 clip->parent().set("kdenlive:id", binId.toUtf8().constData());
                 clip->parent().set("_kdenlive_processed", 1);
             }
-            bool ok = false;
-            int cid = -1;
             if (pCore->bin()->getBinClip(binId)) {
                 PlaylistState::ClipState st = inferState(clip, audioTrack);
-                cid = ClipModel::construct(timeline, binId, clip, st, tid, originalDecimalPoint, playlist);
-                ok = timeline->requestClipMove(cid, tid, position, true, true, false, true, undo, redo);
+                int cid = ClipModel::construct(timeline, binId, clip, st, tid, originalDecimalPoint, playlist);
+                loadedClips.push_back({cid, position});
             } else {
                 qWarning() << "can't find bin clip" << binId << clip->get("id");
             }
-            if (!ok && cid > -1) {
-                timeline->requestItemDeletion(cid, false);
-                m_errorMessage << i18n("Invalid clip %1 found on track %2 at %3.", clip->parent().get("id"), track.get("id"), position);
-                break;
-            }
             break;
         }
         case tractor_type: {
@@ -376,10 +383,28 @@ bool constructTrackFromMelt(const std::shared_ptr<TimelineItemModel> &timeline,
         }
         default:
             qWarning() << "unexpected object found in playlist";
-            return false;
+            valid = false;
+            break;
+        }
+        if (!valid) {
             break;
         }
     }
+    reportProgress();
+    if (!timeline->requestClipsLoad(tid, loadedClips, playlist, undo, redo)) {
+        // Some clips cannot be inserted as they are, go through the regular checks to find and remove them
+        qWarning() << "falling back to individual clip moves to load track" << track.get("id");
+        for (const auto &item : loadedClips) {
+            int cid = item.first;
+            if (!timeline->requestClipMove(cid, tid, item.second, true, true, false, true, undo, redo)) {
+                m_errorMessage << i18n("Invalid clip %1 found on track %2 at %3.", timeline->getClipBinId(cid), track.get("id"), item.second);
+                timeline->requestItemDeletion(cid, false);
+            }
+        }
+    }
+    if (!valid) {
+        return false;
+    }
     std::shared_ptr<Mlt::Service> serv = std::make_shared<Mlt::Service>(track.get_service());
     timeline->importTrackEffects(tid, serv);
     return true;
@@ -20,9 +20,52 @@
  ***************************************************************************/
 #include "snapmodel.hpp"
 #include <QDebug>
+#include <algorithm>
 #include <climits>
 #include <cstdlib>
 
+namespace {
+void incrementPoint(std::map<int, int> &points, int position)
+{
+    points[position]++;
+}
+
+void decrementPoint(std::map<int, int> &points, int position)
+{
+    auto it = points.find(position);
+    if (it == points.end()) {
+        return;
+    }
+    if (it->second == 1) {
+        points.erase(it);
+    } else {
+        it->second--;
+    }
+}
+
+int countIn(const std::vector<int> &sorted, int position)
+{
+    auto range = std::equal_range(sorted.begin(), sorted.end(), position);
+    return int(range.second - range.first);
+}
+
+// Forwards the points it receives to one layer of a SnapModel
+class SnapLayer : public SnapInterface
+{
+public:
+    SnapLayer(SnapModel *model, SnapModel::SnapType type)
+        : m_model(model)
+        , m_type(type)
+    {
+    }
+    void addPoint(int position) override { m_model->addPoint(position, m_type); }
+    void removePoint(int position) override { m_model->removePoint(position, m_type); }
+
+private:
+    SnapModel *m_model;
+    SnapModel::SnapType m_type;
+};
+} // namespace
 
 SnapInterface::SnapInterface() = default;
 SnapInterface::~SnapInterface() = default;
@@ -31,36 +74,120 @@ SnapModel::SnapModel() = default;
 
 void SnapModel::addPoint(int position)
 {
-    if (m_snaps.count(position) == 0) {
-        m_snaps[position] = 1;
-    } else {
-        m_snaps[position]++;
-    }
+    addPoint(position, Other);
+}
+
+void SnapModel::addPoint(int position, SnapType type, int trackId)
+{
+    incrementPoint(m_snaps, position);
+    incrementPoint(m_layers[{type, trackId}], position);
 }
 
 void SnapModel::removePoint(int position)
+{
+    removePoint(position, Other);
+}
+
+void SnapModel::removePoint(int position, SnapType type, int trackId)
 {
     Q_ASSERT(m_snaps.count(position) > 0);
-    if (m_snaps[position] == 1) {
-        m_snaps.erase(position);
+    decrementPoint(m_snaps, position);
+    auto layer = m_layers.find({type, trackId});
+    Q_ASSERT(layer != m_layers.end() && layer->second.count(position) > 0);
+    if (layer != m_layers.end()) {
+        decrementPoint(layer->second, position);
+    }
+}
+
+std::shared_ptr<SnapInterface> SnapModel::layer(SnapType type)
+{
+    auto &layerInterface = m_layerInterfaces[type];
+    if (!layerInterface) {
+        layerInterface = std::make_shared<SnapLayer>(this, type);
+    }
+    return layerInterface;
+}
+
+void SnapModel::setTypeEnabled(SnapType type, bool enabled)
+{
+    if (enabled) {
+        m_disabledTypes.erase(type);
     } else {
-        m_snaps[position]--;
+        m_disabledTypes.insert(type);
     }
 }
 
-int SnapModel::getClosestPoint(int position)
+void SnapModel::setTrackEnabled(int trackId, bool enabled)
 {
-    if (m_snaps.empty()) {
-        return -1;
+    if (enabled) {
+        m_disabledTracks.erase(trackId);
+    } else {
+        m_disabledTracks.insert(trackId);
     }
-    auto it = m_snaps.lower_bound(position);
+}
+
+int SnapModel::enabledCount(int position) const
+{
+    int count = 0;
+    for (const auto &layer : m_layers) {
+        if (m_disabledTypes.count(layer.first.first) > 0 || m_disabledTracks.count(layer.first.second) > 0) {
+            continue;
+        }
+        auto it = layer.second.find(position);
+        if (it != layer.second.end()) {
+            count += it->second;
+        }
+    }
+    return count;
+}
+
+int SnapModel::getClosestPoint(int position)
+{
+    return getClosestPoint(position, INT_MAX, {});
+}
+
+int SnapModel::getClosestPoint(int position, int maxDistance, const std::vector<int> &excluded, const std::vector<int> &extraPoints) const
+{
+    bool allEnabled = m_disabledTypes.empty() && m_disabledTracks.empty();
+    // A position is available if some of its points are neither excluded nor in a disabled layer
+    auto isAvailable = [&](const std::pair<const int, int> &point) {
+        int hidden = countIn(excluded, point.first) + countIn(m_ignore, point.first);
+        int count = point.second - hidden;
+        if (!allEnabled) {
+            count = std::min(count, enabledCount(point.first));
+        }
+        return count > 0;
+    };
     long long int prev = INT_MIN, next = INT_MAX;
-    if (it != m_snaps.end()) {
-        next = (*it).first;
+    auto it = m_snaps.lower_bound(position);
+    for (auto nextIt = it; nextIt != m_snaps.end() && (long long)nextIt->first - position <= maxDistance; ++nextIt) {
+        if (isAvailable(*nextIt)) {
+            next = nextIt->first;
+            break;
+        }
     }
-    if (it != m_snaps.begin()) {
-        --it;
-        prev = (*it).first;
+    for (auto prevIt = it; prevIt != m_snaps.begin();) {
+        --prevIt;
+        if ((long long)position - prevIt->first > maxDistance) {
+            break;
+        }
+        if (isAvailable(*prevIt)) {
+            prev = prevIt->first;
+            break;
+        }
+    }
+    for (int point : extraPoints) {
+        if (std::llabs((long long)point - position) > maxDistance) {
+            continue;
+        }
+        if (point >= position) {
+            next = std::min(next, (long long)point);
+        } else {
+            prev = std::max(prev, (long long)point);
+        }
+    }
+    if (prev == INT_MIN && next == INT_MAX) {
+        return -1;
     }
     if (std::llabs((long long)position - prev) < std::llabs((long long)position - next)) {
         return (int)prev;
@@ -98,57 +225,37 @@ int SnapModel::getPreviousPoint(int position)
 void SnapModel::ignore(const std::vector<int> &pts)
 {
     for (int pt : pts) {
-        removePoint(pt);
-        m_ignore.push_back(pt);
+        Q_ASSERT(m_snaps.count(pt) > 0);
+        m_ignore.insert(std::upper_bound(m_ignore.begin(), m_ignore.end(), pt), pt);
     }
 }
 
 void SnapModel::unIgnore()
 {
-    for (const auto &pt : m_ignore) {
-        addPoint(pt);
-    }
     m_ignore.clear();
 }
 
 int SnapModel::proposeSize(int in, int out, int size, bool right, int maxSnapDist)
 {
-    ignore({in, out});
-    int proposed_size = -1;
-    if (right) {
-        int target_pos = in + size - 1;
-        int snapped_pos = getClosestPoint(target_pos);
-        if (snapped_pos != -1 && qAbs(target_pos - snapped_pos) <= maxSnapDist) {
-            proposed_size = snapped_pos - in;
-        }
-    } else {
-        int target_pos = out + 1 - size;
-        int snapped_pos = getClosestPoint(target_pos);
-        if (snapped_pos != -1 && qAbs(target_pos - snapped_pos) <= maxSnapDist) {
-            proposed_size = out - snapped_pos;
-        }
-    }
-    unIgnore();
-    return proposed_size;
+    return proposeSize(in, out, {in, out}, size, right, maxSnapDist);
 }
 
-int SnapModel::proposeSize(int in, int out, const std::vector<int> boundaries, int size, bool right, int maxSnapDist)
+int SnapModel::proposeSize(int in, int out, std::vector<int> boundaries, int size, bool right, int maxSnapDist, const std::vector<int> &extraPoints)
 {
-    ignore(boundaries);
+    std::sort(boundaries.begin(), boundaries.end());
     int proposed_size = -1;
     if (right) {
         int target_pos = in + size - 1;
-        int snapped_pos = getClosestPoint(target_pos);
-        if (snapped_pos != -1 && qAbs(target_pos - snapped_pos) <= maxSnapDist) {
+        int snapped_pos = getClosestPoint(target_pos, maxSnapDist, boundaries, extraPoints);
+        if (snapped_pos != -1) {
             proposed_size = snapped_pos - in;
         }
     } else {
         int target_pos = out + 1 - size;
-        int snapped_pos = getClosestPoint(target_pos);
-        if (snapped_pos != -1 && qAbs(target_pos - snapped_pos) <= maxSnapDist) {
+        int snapped_pos = getClosestPoint(target_pos, maxSnapDist, boundaries, extraPoints);
+        if (snapped_pos != -1) {
             proposed_size = out - snapped_pos;
         }
     }
-    unIgnore();
     return proposed_size;
 }
@@ -23,6 +23,8 @@
 #define SNAPMODEL_H
 
 #include <map>
+#include <memory>
+#include <unordered_set>
 #include <vector>
 
 /** @brief This is a base class for snap models (timeline, clips)
@@ -50,17 +52,42 @@ public:
 class SnapModel : public virtual SnapInterface
 {
 public:
+    /* @brief The kind of item a snappoint comes from. Points of each kind (and of each track) are stored in their own layer, that can be
+       enabled or disabled independently */
+    enum SnapType { Other = 0, ClipEdge, Marker, Guide, Subtitle };
+
     SnapModel();
 
     /* @brief Adds a snappoint at given position */
     void addPoint(int position) override;
+    /* @brief Adds a snappoint at given position in the layer of the given type and track */
+    void addPoint(int position, SnapType type, int trackId = -1);
 
     /* @brief Removes a snappoint from given position */
     void removePoint(int position) override;
+    /* @brief Removes a snappoint from given position in the layer of the given type and track */
+    void removePoint(int position, SnapType type, int trackId = -1);
+
+    /* @brief Returns an interface that adds and removes points in the layer of the given type.
+       This is meant to be registered in models that only know about SnapInterface (guides, subtitles)
+     */
+    std::shared_ptr<SnapInterface> layer(SnapType type);
+
+    /* @brief Enables or disables the snappoints of the given type */
+    void setTypeEnabled(SnapType type, bool enabled);
+    /* @brief Enables or disables the snappoints of the given track */
+    void setTrackEnabled(int trackId, bool enabled);
 
     /* @brief Retrieves closest point. Returns -1 if there is no snappoint available */
     int getClosestPoint(int position);
 
+    /* @brief Retrieves the closest point that is at most maxDistance away from position, without modifying the model.
+       Returns -1 if there is no such snappoint.
+       @param excluded sorted list of points to leave out. A position appearing n times hides n of the points at this position
+       @param extraPoints points that are only taken into account for this query (for example the playhead)
+     */
+    int getClosestPoint(int position, int maxDistance, const std::vector<int> &excluded, const std::vector<int> &extraPoints = {}) const;
+
     /* @brief Retrieves next snap point. Returns position if there is no snappoint available */
     int getNextPoint(int position);
 
@@ -84,18 +111,28 @@ public:
        @param size is the size requested before snapping
        @param right true if we resize the right end of the item
        @param maxSnapDist maximal number of frames we are allowed to snap to
+       @param boundaries snappoints of the item itself, that are not taken into account
+       @param extraPoints points that are only taken into account for this query (for example the playhead)
     */
     int proposeSize(int in, int out, int size, bool right, int maxSnapDist);
-    int proposeSize(int in, int out, const std::vector<int> boundaries, int size, bool right, int maxSnapDist);
+    int proposeSize(int in, int out, std::vector<int> boundaries, int size, bool right, int maxSnapDist, const std::vector<int> &extraPoints = {});
 
     // For testing only
     std::map<int, int> _snaps() { return m_snaps; }
 
 private:
+    /* @brief Returns the number of points at the given position that belong to an enabled layer */
+    int enabledCount(int position) const;
+
     std::map<int, int> m_snaps; // This represents the snappoints internally. The keys are the positions and the values are the number of elements at this
                                 // position. Note that it is important that the datastructure is ordered. QMap is NOT ordered, and therefore not suitable.
 
-    std::vector<int> m_ignore;
+    std::map<std::pair<int, int>, std::map<int, int>> m_layers; // Same as m_snaps, split by (type, trackId)
+    std::map<SnapType, std::shared_ptr<SnapInterface>> m_layerInterfaces;
+    std::unordered_set<int> m_disabledTypes;
+    std::unordered_set<int> m_disabledTracks;
+
+    std::vector<int> m_ignore; // sorted
 };
 
 #endif
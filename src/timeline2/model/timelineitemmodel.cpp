@@ -64,7 +64,7 @@ void TimelineItemModel::finishConstruct(const std::shared_ptr<TimelineItemModel>
 {
     ptr->weak_this_ = ptr;
     ptr->m_groups = std::make_unique<GroupsModel>(ptr);
-    guideModel->registerSnapModel(std::static_pointer_cast<SnapInterface>(ptr->m_snaps));
+    guideModel->registerSnapModel(ptr->m_snaps->layer(SnapModel::Guide));
 }
 
 std::shared_ptr<TimelineItemModel> TimelineItemModel::construct(Mlt::Profile *profile, std::shared_ptr<MarkerListModel> guideModel,
@@ -36,6 +36,7 @@
 #include "snapmodel.hpp"
 #include "timelinefunctions.hpp"
 #include "trackmodel.hpp"
+#include "utils/latencystats.hpp"
 
 #include <QDebug>
 #include <QThread>
@@ -46,6 +47,7 @@
 #include <mlt++/MltProfile.h>
 #include <mlt++/MltTractor.h>
 #include <mlt++/MltTransition.h>
+#include <algorithm>
 #include <queue>
 
 #include "macros.hpp"
@@ -90,7 +92,10 @@ RTTR_REGISTRATION
             parameter_names("clipId", "trackId", "position", "updateView", "logUndo", "invalidateTimeline"))
         .method("requestFakeGroupMove", select_overload<bool(int, int, int, int, bool, bool)>(&TimelineModel::requestFakeGroupMove))(
             parameter_names("clipId", "groupId", "delta_track", "delta_pos", "updateView", "logUndo"))
-        .method("suggestClipMove", &TimelineModel::suggestClipMove)(parameter_names("clipId", "trackId", "position", "cursorPosition", "snapDistance", "moveMirrorTracks"))
+        .method("suggestClipMove", &TimelineModel::suggestClipMove)(
+            parameter_names("clipId", "trackId", "position", "cursorPosition", "snapDistance", "moveMirrorTracks", "dragPreview"))
+        .method("requestClipDragEnd", &TimelineModel::requestClipDragEnd)(
+            parameter_names("clipId", "sourceTrackId", "sourcePosition", "position", "moveMirrorTracks"))
         .method("suggestCompositionMove",
                 &TimelineModel::suggestCompositionMove)(parameter_names("compoId", "trackId", "position", "cursorPosition", "snapDistance"))
         // .method("addSnap", &TimelineModel::addSnap)(parameter_names("pos"))
@@ -1017,6 +1022,7 @@ bool TimelineModel::requestFakeClipMove(int clipId, int trackId, int position, b
 
 bool TimelineModel::requestClipMove(int clipId, int trackId, int position, bool moveMirrorTracks, bool updateView, bool logUndo, bool invalidateTimeline)
 {
+    LatencyProbe probe("timeline.requestClipMove");
     QWriteLocker locker(&m_lock);
     TRACE(clipId, trackId, position, updateView, logUndo, invalidateTimeline);
     Q_ASSERT(m_allClips.count(clipId) > 0);
@@ -1129,10 +1135,242 @@ bool TimelineModel::requestClipMoveAttempt(int clipId, int trackId, int position
     return res;
 }
 
+namespace {
+// Returns true if one of the [start, end[ ranges in moved intersects one in others
+bool rangesIntersect(std::vector<std::pair<int, int>> &moved, std::vector<std::pair<int, int>> &others)
+{
+    std::sort(moved.begin(), moved.end());
+    std::sort(others.begin(), others.end());
+    size_t j = 0;
+    for (const auto &range : moved) {
+        while (j < others.size() && others[j].second <= range.first) {
+            ++j;
+        }
+        if (j < others.size() && others[j].first < range.second) {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+bool TimelineModel::isClipMoveFeasible(int clipId, int trackId, int position, bool moveMirrorTracks) const
+{
+    std::unordered_map<int, std::pair<int, int>> targets;
+    return getClipMoveTargets(clipId, trackId, position, moveMirrorTracks, targets);
+}
+
+bool TimelineModel::getClipMoveTargets(int clipId, int trackId, int position, bool moveMirrorTracks,
+                                       std::unordered_map<int, std::pair<int, int>> &targets) const
+{
+    READ_LOCK();
+    if (!isClip(clipId) || !isTrack(trackId)) {
+        return false;
+    }
+    const auto clip = m_allClips.at(clipId);
+    const int sourceTrackId = clip->getCurrentTrackId();
+    std::unordered_set<int> moving = {clipId};
+    if (m_groups->isInGroup(clipId)) {
+        moving = m_groups->getLeaves(m_groups->getRootId(clipId));
+    }
+    // Track offsets, computed like in requestGroupMove: when the master clip moves up, the clips of the other type move down
+    int audio_delta = 0;
+    int video_delta = 0;
+    if (sourceTrackId > -1) {
+        const int delta_track = getTrackPosition(trackId) - getTrackPosition(sourceTrackId);
+        const bool masterIsAudio = getTrackById_const(sourceTrackId)->isAudioTrack();
+        audio_delta = masterIsAudio ? delta_track : -delta_track;
+        video_delta = masterIsAudio ? -delta_track : delta_track;
+    }
+    const int delta = position - clip->getPosition();
+    // Target ranges of the moved items, by track
+    std::unordered_map<int, std::vector<std::pair<int, int>>> clipTargets;
+    std::unordered_map<int, std::vector<std::pair<int, int>>> compoTargets;
+    // Clips allowed to overlap a moved clip, because they share a mix with it
+    std::unordered_set<int> mixPartners;
+    targets.clear();
+    for (int id : moving) {
+        const bool isClipItem = isClip(id);
+        if (!isClipItem && !isComposition(id)) {
+            // Subtitle
+            continue;
+        }
+        const int currentTrack = getItemTrackId(id);
+        int tid = id == clipId ? trackId : currentTrack;
+        if (id != clipId && currentTrack != -1) {
+            int d = getTrackById_const(currentTrack)->isAudioTrack() ? audio_delta : video_delta;
+            if (!moveMirrorTracks) {
+                d = 0;
+            }
+            const int targetPos = getTrackPosition(currentTrack) + d;
+            if (targetPos < 0 || targetPos >= getTracksCount()) {
+                return false;
+            }
+            tid = getTrackIndexFromPosition(targetPos);
+        }
+        if (tid == -1) {
+            continue;
+        }
+        const auto track = getTrackById_const(tid);
+        int start = 0;
+        int playtime = 0;
+        if (isClipItem) {
+            const auto item = m_allClips.at(id);
+            if (item->clipState() == PlaylistState::Disabled) {
+                if ((track->trackType() == PlaylistState::AudioOnly && !item->canBeAudio()) ||
+                    (track->trackType() == PlaylistState::VideoOnly && !item->canBeVideo())) {
+                    return false;
+                }
+            } else if (track->trackType() != item->clipState()) {
+                // Audio / video mismatch
+                return false;
+            }
+            start = item->getPosition() + delta;
+            playtime = item->getPlaytime();
+            if (tid == currentTrack && track->hasMix(id)) {
+                std::pair<MixInfo, MixInfo> mixData = track->getMixInfo(id);
+                mixPartners.insert(mixData.first.firstClipId);
+                mixPartners.insert(mixData.second.secondClipId);
+            }
+            targets[id] = {tid, start};
+        } else {
+            if (track->isAudioTrack()) {
+                return false;
+            }
+            start = m_allCompositions.at(id)->getPosition() + delta;
+            playtime = m_allCompositions.at(id)->getPlaytime();
+        }
+        if (start < 0 || track->isLocked()) {
+            return false;
+        }
+        (isClipItem ? clipTargets : compoTargets)[tid].push_back({start, start + playtime});
+    }
+    for (auto &target : clipTargets) {
+        std::vector<std::pair<int, int>> others;
+        for (const auto &c : getTrackById_const(target.first)->m_allClips) {
+            if (moving.count(c.first) == 0 && mixPartners.count(c.first) == 0) {
+                others.push_back({c.second->getPosition(), c.second->getPosition() + c.second->getPlaytime()});
+            }
+        }
+        if (rangesIntersect(target.second, others)) {
+            return false;
+        }
+    }
+    for (auto &target : compoTargets) {
+        std::vector<std::pair<int, int>> others;
+        for (const auto &c : getTrackById_const(target.first)->m_allCompositions) {
+            if (moving.count(c.first) == 0) {
+                others.push_back({c.second->getPosition(), c.second->getPosition() + c.second->getPlaytime()});
+            }
+        }
+        if (rangesIntersect(target.second, others)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TimelineModel::canPreviewClipMove(int clipId) const
+{
+    READ_LOCK();
+    std::unordered_set<int> moving = {clipId};
+    if (m_groups->isInGroup(clipId)) {
+        moving = m_groups->getLeaves(m_groups->getRootId(clipId));
+    }
+    for (int id : moving) {
+        if (!isClip(id) || m_allClips.at(id)->getCurrentTrackId() == -1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TimelineModel::requestClipMovePreview(int clipId, int trackId, int position, bool moveMirrorTracks)
+{
+    QWriteLocker locker(&m_lock);
+    std::unordered_map<int, std::pair<int, int>> targets;
+    if (!getClipMoveTargets(clipId, trackId, position, moveMirrorTracks, targets)) {
+        return false;
+    }
+    for (const auto &target : targets) {
+        const auto clip = m_allClips.at(target.first);
+        QVector<int> roles{FakePositionRole};
+        if (clip->getFakeTrackId() != target.second.first) {
+            clip->setFakeTrackId(target.second.first);
+            roles << FakeTrackIdRole;
+        }
+        clip->setFakePosition(target.second.second);
+        QModelIndex modelIndex = makeClipIndexFromID(target.first);
+        notifyChange(modelIndex, modelIndex, roles);
+    }
+    return true;
+}
+
+void TimelineModel::clearClipMovePreview(int clipId)
+{
+    QWriteLocker locker(&m_lock);
+    std::unordered_set<int> moving = {clipId};
+    if (m_groups->isInGroup(clipId)) {
+        moving = m_groups->getLeaves(m_groups->getRootId(clipId));
+    }
+    for (int id : moving) {
+        if (isClip(id) && m_allClips.at(id)->getFakeTrackId() > -1) {
+            m_allClips.at(id)->setFakeTrackId(-1);
+            QModelIndex modelIndex = makeClipIndexFromID(id);
+            notifyChange(modelIndex, modelIndex, FakeTrackIdRole);
+        }
+    }
+}
+
+int TimelineModel::getBlankSizeNear(int trackId, int start, int end, bool after, const std::unordered_set<int> &ignored) const
+{
+    READ_LOCK();
+    int limit = after ? INT_MAX : 0;
+    for (const auto &c : getTrackById_const(trackId)->m_allClips) {
+        if (ignored.count(c.first) > 0) {
+            continue;
+        }
+        const int in = c.second->getPosition();
+        const int out = in + c.second->getPlaytime();
+        if (in < end && out > start) {
+            return 0;
+        }
+        if (after && in >= end) {
+            limit = qMin(limit, in);
+        } else if (!after && out <= start) {
+            limit = qMax(limit, out);
+        }
+    }
+    if (after) {
+        return limit == INT_MAX ? INT_MAX : limit - end;
+    }
+    return start - limit;
+}
+
+bool TimelineModel::requestClipDragEnd(int clipId, int sourceTrackId, int sourcePosition, int position, bool moveMirrorTracks)
+{
+    QWriteLocker locker(&m_lock);
+    TRACE(clipId, sourceTrackId, sourcePosition, position, moveMirrorTracks);
+    Q_ASSERT(isClip(clipId));
+    int trackId = m_allClips[clipId]->getFakeTrackId();
+    if (m_editMode == TimelineMode::NormalEdit && trackId > -1) {
+        // The drag only moved a preview, the clips are still at their original place
+        clearClipMovePreview(clipId);
+    } else {
+        // The clips were moved during the drag, put them back so that the undo entry covers the whole move
+        trackId = getClipTrackId(clipId);
+        requestClipMove(clipId, sourceTrackId, sourcePosition, moveMirrorTracks, true, false, false);
+    }
+    bool res = requestClipMove(clipId, trackId, position, moveMirrorTracks, true, true, true);
+    TRACE_RES(res);
+    return res;
+}
+
 QVariantList TimelineModel::suggestItemMove(int itemId, int trackId, int position, int cursorPosition, int snapDistance)
 {
     if (isClip(itemId)) {
-        return suggestClipMove(itemId, trackId, position, cursorPosition, snapDistance);
+        // The spacer moves groups with compositions and subtitles, that have no preview
+        return suggestClipMove(itemId, trackId, position, cursorPosition, snapDistance, true, false);
     }
     if (isComposition(itemId)) {
         return suggestCompositionMove(itemId, trackId, position, cursorPosition, snapDistance);
@@ -1198,15 +1436,18 @@ int TimelineModel::suggestSubtitleMove(int subId, int position, int cursorPositi
     return position;
 }
 
-QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int position, int cursorPosition, int snapDistance, bool moveMirrorTracks)
+QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int position, int cursorPosition, int snapDistance, bool moveMirrorTracks, bool dragPreview)
 {
     QWriteLocker locker(&m_lock);
-    TRACE(clipId, trackId, position, cursorPosition, snapDistance);
+    TRACE(clipId, trackId, position, cursorPosition, snapDistance, moveMirrorTracks, dragPreview);
     Q_ASSERT(isClip(clipId));
     Q_ASSERT(isTrack(trackId));
-    int currentPos = m_editMode == TimelineMode::NormalEdit ? getClipPosition(clipId) : m_allClips[clipId]->getFakePosition();
+    // In normal edit mode, the drag only moves a preview of the clips in the model. The playlists are modified once, on drop
+    const bool preview = m_editMode == TimelineMode::NormalEdit && dragPreview && canPreviewClipMove(clipId);
+    const bool fakeMove = m_editMode != TimelineMode::NormalEdit || (preview && m_allClips[clipId]->getFakeTrackId() > -1);
+    int currentPos = fakeMove ? m_allClips[clipId]->getFakePosition() : getClipPosition(clipId);
     int offset = m_editMode == TimelineMode::NormalEdit ? 0 : getClipPosition(clipId) - currentPos;
-    int sourceTrackId = (m_editMode != TimelineMode::NormalEdit) ? m_allClips[clipId]->getFakeTrackId() : getClipTrackId(clipId);
+    int sourceTrackId = fakeMove ? m_allClips[clipId]->getFakeTrackId() : getClipTrackId(clipId);
     if (sourceTrackId > -1 && getTrackById_const(trackId)->isAudioTrack() != getTrackById_const(sourceTrackId)->isAudioTrack()) {
         // Trying move on incompatible track type, stay on same track
         trackId = sourceTrackId;
@@ -1248,7 +1489,9 @@ QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int positio
                 ignored_pts.push_back(in + getItemPlaytime(current_clipId));*/
             }
         }
-        int snapped = getBestSnapPos(currentPos, position - currentPos, ignored_pts, cursorPosition, snapDistance);
+        // The drag preview does not move the snap points, so in normal mode the moved items snap from their model position
+        int snapReference = m_editMode == TimelineMode::NormalEdit ? getClipPosition(clipId) : currentPos;
+        int snapped = getBestSnapPos(snapReference, position - snapReference, ignored_pts, cursorPosition, snapDistance);
         if (snapped >= 0) {
             position = snapped;
         }
@@ -1274,9 +1517,15 @@ QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int positio
             }
         }
     }
+    auto tryMove = [&](int tid, int pos) {
+        if (preview) {
+            return requestClipMovePreview(clipId, tid, pos, moveMirrorTracks);
+        }
+        // Positions that fail are rejected from the model data, so that the MLT playlists are only modified by moves that succeed
+        return isClipMoveFeasible(clipId, tid, pos, moveMirrorTracks) && requestClipMove(clipId, tid, pos, moveMirrorTracks, true, false, false);
+    };
     // we check if move is possible
-    bool possible = (m_editMode == TimelineMode::NormalEdit) ? requestClipMove(clipId, trackId, position, moveMirrorTracks, true, false, false)
-                                                           : requestFakeClipMove(clipId, trackId, position, true, false, false);
+    bool possible = (m_editMode == TimelineMode::NormalEdit) ? tryMove(trackId, position) : requestFakeClipMove(clipId, trackId, position, true, false, false);
 
     if (possible) {
         TRACE_RES(position);
@@ -1295,7 +1544,7 @@ QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int positio
         // Try same track move
         if (trackId != sourceTrackId && sourceTrackId != -1) {
             trackId = sourceTrackId;
-            possible = requestClipMove(clipId, trackId, position, moveMirrorTracks, true, false, false);
+            possible = tryMove(trackId, position);
             if (!possible) {
                 qWarning() << "can't move clip" << clipId << "on track" << trackId << "at" << position;
             } else {
@@ -1304,7 +1553,7 @@ QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int positio
             }
         }
 
-        int blank_length = getTrackById_const(trackId)->getBlankSizeNearClip(clipId, after);
+        int blank_length = getBlankSizeNear(trackId, currentPos, currentPos + m_allClips[clipId]->getPlaytime(), after, {clipId});
         if (blank_length < INT_MAX) {
             if (after) {
                 position = currentPos + blank_length;
@@ -1315,7 +1564,7 @@ QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int positio
             TRACE_RES(currentPos);
             return {currentPos, sourceTrackId};
         }
-        possible = requestClipMove(clipId, trackId, position, moveMirrorTracks, true, false, false);
+        possible = tryMove(trackId, position);
         TRACE_RES(possible ? position : currentPos);
         if (possible) {
             return {position, trackId};
@@ -1324,7 +1573,7 @@ QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int positio
     }
     if (trackId != sourceTrackId) {
         // Try same track move
-        possible = requestClipMove(clipId, sourceTrackId, position, moveMirrorTracks, true, false, false);
+        possible = tryMove(sourceTrackId, position);
         if (possible) {
             return {position, sourceTrackId};
         }
@@ -1338,14 +1587,19 @@ QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int positio
     // First pass, sort clips by track and keep only the first / last depending on move direction
     for (int current_clipId : all_items) {
         int clipTrack = getItemTrackId(current_clipId);
+        int in = getItemPosition(current_clipId);
+        if (fakeMove && isClip(current_clipId)) {
+            // Use the place of the preview
+            clipTrack = m_allClips[current_clipId]->getFakeTrackId();
+            in = m_allClips[current_clipId]->getFakePosition();
+        }
         if (clipTrack == -1) {
             continue;
         }
-        int in = getItemPosition(current_clipId);
+        int out = in + getItemPlaytime(current_clipId);
         if (trackPosition.contains(clipTrack)) {
             if (after) {
                 // keep only last clip position for track
-                int out = in + getItemPlaytime(current_clipId);
                 if (trackPosition.value(clipTrack) < out) {
                     trackPosition.insert(clipTrack, out);
                 }
@@ -1356,28 +1610,18 @@ QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int positio
                 }
             }
         } else {
-            trackPosition.insert(clipTrack, after ? in + getItemPlaytime(current_clipId) - 1 : in);
+            trackPosition.insert(clipTrack, after ? out : in);
         }
     }
 
-    // Now check space on each track
+    // Now check space on each track, the moved items are ignored since they can be away from their preview
     QMapIterator<int, int> i(trackPosition);
     int blank_length = 0;
     while (i.hasNext()) {
         i.next();
-        int track_space;
-        if (!after) {
-            // Check space before the position
-            track_space = i.value() - getTrackById_const(i.key())->getBlankStart(i.value() - 1);
-            if (blank_length == 0 || blank_length > track_space) {
-                blank_length = track_space;
-            }
-        } else {
-            // Check space after the position
-            track_space = getTrackById(i.key())->getBlankEnd(i.value() + 1) - i.value() - 1;
-            if (blank_length == 0 || blank_length > track_space) {
-                blank_length = track_space;
-            }
+        int track_space = getBlankSizeNear(i.key(), i.value(), i.value(), after, all_items);
+        if (blank_length == 0 || blank_length > track_space) {
+            blank_length = track_space;
         }
     }
     if (snapDistance > 0) {
@@ -1389,7 +1633,7 @@ QVariantList TimelineModel::suggestClipMove(int clipId, int trackId, int positio
     }
     if (blank_length != 0) {
         int updatedPos = currentPos + (after ? blank_length : -blank_length);
-        possible = requestClipMove(clipId, trackId, updatedPos, moveMirrorTracks, true, false, false);
+        possible = tryMove(trackId, updatedPos);
         if (possible) {
             TRACE_RES(updatedPos);
             return {updatedPos, trackId};
@@ -1498,6 +1742,7 @@ bool TimelineModel::requestClipCreation(const QString &binClipId, int &id, Playl
 
 bool TimelineModel::requestClipInsertion(const QString &binClipId, int trackId, int position, int &id, bool logUndo, bool refreshView, bool useTargets)
 {
+    LatencyProbe probe("timeline.requestClipInsertion");
     QWriteLocker locker(&m_lock);
     TRACE(binClipId, trackId, position, id, logUndo, refreshView, useTargets);
     Fun undo = []() { return true; };
@@ -1805,6 +2050,7 @@ bool TimelineModel::requestItemDeletion(int itemId, Fun &undo, Fun &redo, bool l
 
 bool TimelineModel::requestItemDeletion(int itemId, bool logUndo)
 {
+    LatencyProbe probe("timeline.requestItemDeletion");
     QWriteLocker locker(&m_lock);
     TRACE(itemId, logUndo);
     Q_ASSERT(isItem(itemId));
@@ -2081,6 +2327,7 @@ bool TimelineModel::requestFakeGroupMove(int clipId, int groupId, int delta_trac
 
 bool TimelineModel::requestGroupMove(int itemId, int groupId, int delta_track, int delta_pos, bool moveMirrorTracks, bool updateView, bool logUndo)
 {
+    LatencyProbe probe("timeline.requestGroupMove");
     QWriteLocker locker(&m_lock);
     TRACE(itemId, groupId, delta_track, delta_pos, updateView, logUndo);
     std::function<bool(void)> undo = []() { return true; };
@@ -2481,6 +2728,7 @@ bool TimelineModel::requestGroupMove(int itemId, int groupId, int delta_track, i
 
 bool TimelineModel::requestGroupDeletion(int clipId, bool logUndo)
 {
+    LatencyProbe probe("timeline.requestGroupDeletion");
     QWriteLocker locker(&m_lock);
     TRACE(clipId, logUndo);
     if (!m_groups->isInGroup(clipId)) {
@@ -2798,9 +3046,7 @@ int TimelineModel::requestItemResizeInfo(int itemId, int in, int out, int size,
             }
         }
         int timelinePos = pCore->getTimelinePosition();
-        m_snaps->addPoint(timelinePos);
-        int proposed_size = m_snaps->proposeSize(in, out, getBoundaries(itemId), size, right, snapDistance);
-        m_snaps->removePoint(timelinePos);
+        int proposed_size = m_snaps->proposeSize(in, out, getBoundaries(itemId), size, right, snapDistance, {timelinePos});
         if (proposed_size > 0) {
             // only test move if proposed_size is valid
             bool success = false;
@@ -2849,9 +3095,7 @@ int TimelineModel::requestItemSpeedChange(int itemId, int size, bool right, int
         }
     }
     int timelinePos = pCore->getTimelinePosition();
-    m_snaps->addPoint(timelinePos);
-    int proposed_size = m_snaps->proposeSize(in, out, getBoundaries(itemId), size, right, snapDistance);
-    m_snaps->removePoint(timelinePos);
+    int proposed_size = m_snaps->proposeSize(in, out, getBoundaries(itemId), size, right, snapDistance, {timelinePos});
     return proposed_size > 0 ? proposed_size : size;
 }
 
@@ -2878,6 +3122,7 @@ bool TimelineModel::removeMix(int cid)
 
 int TimelineModel::requestItemResize(int itemId, int size, bool right, bool logUndo, int snapDistance, bool allowSingleResize)
 {
+    LatencyProbe probe("timeline.requestItemResize");
     QWriteLocker locker(&m_lock);
     TRACE(itemId, size, right, logUndo, snapDistance, allowSingleResize)
     Q_ASSERT(isItem(itemId));
@@ -3171,6 +3416,7 @@ bool TimelineModel::requestItemResize(int itemId, int size, bool right, bool log
 
 int TimelineModel::requestClipsGroup(const std::unordered_set<int> &ids, bool logUndo, GroupType type)
 {
+    LatencyProbe probe("timeline.requestClipsGroup");
     QWriteLocker locker(&m_lock);
     TRACE(ids, logUndo, type);
     if (type == GroupType::Selection || type == GroupType::Leaf) {
@@ -3249,6 +3495,7 @@ int TimelineModel::requestClipsGroup(const std::unordered_set<int> &ids, Fun &un
 
 bool TimelineModel::requestClipsUngroup(const std::unordered_set<int> &itemIds, bool logUndo)
 {
+    LatencyProbe probe("timeline.requestClipsUngroup");
     QWriteLocker locker(&m_lock);
     TRACE(itemIds, logUndo);
     Fun undo = []() { return true; };
@@ -3275,6 +3522,7 @@ bool TimelineModel::requestClipsUngroup(const std::unordered_set<int> &itemIds,
 
 bool TimelineModel::requestClipUngroup(int itemId, bool logUndo)
 {
+    LatencyProbe probe("timeline.requestClipUngroup");
     QWriteLocker locker(&m_lock);
     TRACE(itemId, logUndo);
     requestClearSelection();
@@ -3308,6 +3556,7 @@ bool TimelineModel::requestClipUngroup(int itemId, Fun &undo, Fun &redo)
 
 bool TimelineModel::requestTrackInsertion(int position, int &id, const QString &trackName, bool audioTrack)
 {
+    LatencyProbe probe("timeline.requestTrackInsertion");
     QWriteLocker locker(&m_lock);
     TRACE(position, id, trackName, audioTrack);
     Fun undo = []() { return true; };
@@ -3410,6 +3659,7 @@ bool TimelineModel::requestTrackInsertion(int position, int &id, const QString &
 
 bool TimelineModel::requestTrackDeletion(int trackId)
 {
+    LatencyProbe probe("timeline.requestTrackDeletion");
     // TODO: make sure we disable overlayTrack before deleting a track
     QWriteLocker locker(&m_lock);
     TRACE(trackId);
@@ -3840,21 +4090,24 @@ int TimelineModel::suggestSnapPoint(int pos, int snapDistance)
 
 int TimelineModel::getBestSnapPos(int referencePos, int diff, std::vector<int> pts, int cursorPosition, int snapDistance)
 {
-    if (!pts.empty()) {
-        if (m_editMode == TimelineMode::NormalEdit) {
-            m_snaps->ignore(pts);
-        }
-    } else {
+    if (pts.empty()) {
         return -1;
     }
-    // Sort and remove duplicates
     std::sort(pts.begin(), pts.end());
+    // In normal mode, the points of the moved items must not attract themselves. Duplicates are kept so that each of them hides one point
+    std::vector<int> excluded;
+    if (m_editMode == TimelineMode::NormalEdit) {
+        excluded = pts;
+    }
+    // Remove duplicates
     pts.erase( std::unique(pts.begin(), pts.end()), pts.end());
-    m_snaps->addPoint(cursorPosition);
     int closest = -1;
     int lowestDiff = snapDistance + 1;
     for (int point : pts) {
-        int snapped = m_snaps->getClosestPoint(point + diff);
+        int snapped = m_snaps->getClosestPoint(point + diff, lowestDiff - 1, excluded, {cursorPosition});
+        if (snapped == -1) {
+            continue;
+        }
         int currentDiff = qAbs(point + diff - snapped);
         if (currentDiff < lowestDiff) {
             lowestDiff = currentDiff;
@@ -3864,10 +4117,6 @@ int TimelineModel::getBestSnapPos(int referencePos, int diff, std::vector<int> p
             }
         }
     }
-    if (m_editMode == TimelineMode::NormalEdit) {
-        m_snaps->unIgnore();
-    }
-    m_snaps->removePoint(cursorPosition);
     return closest;
 }
 
@@ -3988,6 +4237,7 @@ void TimelineModel::registerComposition(const std::shared_ptr<CompositionModel>
 bool TimelineModel::requestCompositionInsertion(const QString &transitionId, int trackId, int position, int length, std::unique_ptr<Mlt::Properties> transProps,
                                                 int &id, bool logUndo)
 {
+    LatencyProbe probe("timeline.requestCompositionInsertion");
     QWriteLocker locker(&m_lock);
     // TRACE(transitionId, trackId, position, length, transProps.get(), id, logUndo);
     Fun undo = []() { return true; };
@@ -4099,6 +4349,7 @@ int TimelineModel::getTrackCompositionsCount(int trackId) const
 
 bool TimelineModel::requestCompositionMove(int compoId, int trackId, int position, bool updateView, bool logUndo)
 {
+    LatencyProbe probe("timeline.requestCompositionMove");
     QWriteLocker locker(&m_lock);
     Q_ASSERT(isComposition(compoId));
     if (m_allCompositions[compoId]->getPosition() == position && getCompositionTrackId(compoId) == trackId) {
@@ -4143,6 +4394,20 @@ bool TimelineModel::isAudioTrack(int trackId) const
     return (*it)->isAudioTrack();
 }
 
+bool TimelineModel::requestClipsLoad(int trackId, const std::vector<std::pair<int, int>> &clips, int playlist, Fun &undo, Fun &redo)
+{
+    QWriteLocker locker(&m_lock);
+    if (!isTrack(trackId)) {
+        return false;
+    }
+    for (const auto &item : clips) {
+        if (!isClip(item.first) || getClipTrackId(item.first) != -1) {
+            return false;
+        }
+    }
+    return getTrackById(trackId)->loadClips(clips, playlist, undo, redo);
+}
+
 bool TimelineModel::requestCompositionMove(int compoId, int trackId, int compositionTrack, int position, bool updateView, bool finalMove, Fun &undo, Fun &redo)
 {
     QWriteLocker locker(&m_lock);
@@ -4719,6 +4984,7 @@ bool TimelineModel::requestClipTimeWarp(int clipId, double speed, bool pitchComp
 
 bool TimelineModel::requestClipTimeWarp(int clipId, double speed, bool pitchCompensate, bool changeDuration)
 {
+    LatencyProbe probe("timeline.requestClipTimeWarp");
     QWriteLocker locker(&m_lock);
     if (qFuzzyCompare(speed, m_allClips[clipId]->getSpeed()) && pitchCompensate == m_allClips[clipId]->getIntProperty("warp_pitch")) {
         return true;
@@ -4972,6 +5238,7 @@ void TimelineModel::requestRemoveFromSelection(int itemId)
 
 bool TimelineModel::requestSetSelection(const std::unordered_set<int> &ids)
 {
+    LatencyProbe probe("timeline.requestSetSelection");
     QWriteLocker locker(&m_lock);
     TRACE(ids);
 
@@ -5196,7 +5463,7 @@ std::pair<int, int> TimelineModel::getMixInOut(int cid) const
 void TimelineModel::setSubModel(std::shared_ptr<SubtitleModel> model)
 {
     m_subtitleModel = std::move(model);
-    m_subtitleModel->registerSnap(std::static_pointer_cast<SnapInterface>(m_snaps));
+    m_subtitleModel->registerSnap(m_snaps->layer(SnapModel::Subtitle));
 }
 
 int TimelineModel::getSubtitleIndex(int subId) const
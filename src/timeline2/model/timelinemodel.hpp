@@ -384,6 +384,15 @@ public:
     bool requestClipMove(int clipId, int trackId, int position, bool moveMirrorTracks, bool updateView, bool invalidateTimeline, bool finalMove, Fun &undo, Fun &redo, bool groupMove = false, QMap <int, int> moving_clips = QMap <int, int>());
     bool requestCompositionMove(int transid, int trackId, int compositionTrack, int position, bool updateView, bool finalMove, Fun &undo, Fun &redo);
 
+    /* @brief Inserts the clips of a track while loading a project, in one pass
+       Unlike requestClipMove, this doesn't check for groups, mixes or snaps and doesn't notify the view, which must be reset afterwards.
+       Returns true on success. If it fails, nothing is modified.
+       @param trackId is the ID of the track
+       @param clips the ids of clips that are not inserted yet, with their position. They must be sorted by position and not overlap
+       @param playlist the sub playlist of the track receiving the clips
+    */
+    bool requestClipsLoad(int trackId, const std::vector<std::pair<int, int>> &clips, int playlist, Fun &undo, Fun &redo);
+
     /* When timeline edit mode is insert or overwrite, we fake the move (as it will overlap existing clips, and only process the real move on drop */
     bool requestFakeClipMove(int clipId, int trackId, int position, bool updateView, bool invalidateTimeline, Fun &undo, Fun &redo);
     bool requestFakeClipMove(int clipId, int trackId, int position, bool updateView, bool logUndo, bool invalidateTimeline);
@@ -400,10 +409,19 @@ public:
        @param snapDistance the maximum distance for a snap result, -1 for no snapping
         of the clip
        @param dontRefreshMasterClip when false, no view refresh is attempted
+       @param dragPreview in normal edit mode, only move a preview of the clips (fake position and track) in the model.
+        The playlists are then modified once, by requestClipDragEnd
        @returns  a list in the form {position, trackId}
         */
     Q_INVOKABLE QVariantList suggestItemMove(int itemId, int trackId, int position, int cursorPosition, int snapDistance = -1);
-    Q_INVOKABLE QVariantList suggestClipMove(int clipId, int trackId, int position, int cursorPosition, int snapDistance = -1, bool moveMirrorTracks = true);
+    Q_INVOKABLE QVariantList suggestClipMove(int clipId, int trackId, int position, int cursorPosition, int snapDistance = -1, bool moveMirrorTracks = true,
+                                             bool dragPreview = true);
+    /** @brief Ends a clip drag done with suggestClipMove, moving the clip (and its group) to its final place in one undoable operation
+       @param sourceTrackId the track of the clip when the drag started
+       @param sourcePosition the position of the clip when the drag started
+       @param position the final position of the clip
+    */
+    Q_INVOKABLE bool requestClipDragEnd(int clipId, int sourceTrackId, int sourcePosition, int position, bool moveMirrorTracks = true);
     Q_INVOKABLE int suggestSubtitleMove(int subId, int position, int cursorPosition, int snapDistance);
     Q_INVOKABLE QVariantList suggestCompositionMove(int compoId, int trackId, int position, int cursorPosition, int snapDistance = -1);
     /** @brief returns the frame pos adjusted to edit mode
@@ -801,6 +819,23 @@ protected:
 
     /** @brief Attempt to make a clip move without ever updating the view */
     bool requestClipMoveAttempt(int clipId, int trackId, int position);
+    /** @brief Checks from the track occupancy of the model, without touching the MLT playlists, whether a clip (and its group) can move to a given place. */
+    bool isClipMoveFeasible(int clipId, int trackId, int position, bool moveMirrorTracks = true) const;
+    /** @brief Computes the places of the clips of a group (or of a single clip) moved with @param clipId, from the model only.
+       @param targets receives the target track and position of each moved clip
+       @returns false if one of the moved items cannot go to its place
+    */
+    bool getClipMoveTargets(int clipId, int trackId, int position, bool moveMirrorTracks, std::unordered_map<int, std::pair<int, int>> &targets) const;
+    /** @brief Returns true if a clip and the items grouped with it are all clips in the timeline, which can be moved as a preview */
+    bool canPreviewClipMove(int clipId) const;
+    /** @brief Moves the preview of a clip (and its group) to a given place if it is free, the clips themselves stay in place */
+    bool requestClipMovePreview(int clipId, int trackId, int position, bool moveMirrorTracks);
+    /** @brief Removes the preview of a clip (and its group) */
+    void clearClipMovePreview(int clipId);
+    /** @brief Returns the length of the blank before @param start (or after @param end) on a track, INT_MAX if there is nothing after @param end.
+       The items in @param ignored are not considered, so that the blank can be measured around a preview.
+    */
+    int getBlankSizeNear(int trackId, int start, int end, bool after, const std::unordered_set<int> &ignored) const;
     
     int getSubtitleIndex(int subId) const;
     std::pair<int, GenTime> getSubtitleIdFromIndex(int index) const;
@@ -182,8 +182,8 @@ Fun TrackModel::requestClipInsertion_lambda(int clipId, int position, bool updat
             }
             int new_in = clip->getPosition();
             int new_out = new_in + clip->getPlaytime();
-            ptr->m_snaps->addPoint(new_in);
-            ptr->m_snaps->addPoint(new_out);
+            ptr->m_snaps->addPoint(new_in, SnapModel::ClipEdge, m_id);
+            ptr->m_snaps->addPoint(new_out, SnapModel::ClipEdge, m_id);
             if (updateView) {
                 int clip_index = getRowfromClip(clipId);
                 ptr->_beginInsertRows(ptr->makeTrackIndexFromID(m_id), clip_index, clip_index);
@@ -301,6 +301,87 @@ bool TrackModel::requestClipInsertion(int clipId, int position, bool updateView,
     return false;
 }
 
+bool TrackModel::loadClips(const std::vector<std::pair<int, int>> &clips, int playlist, Fun &undo, Fun &redo)
+{
+    QWriteLocker locker(&m_lock);
+    auto ptr = m_parent.lock();
+    if (!ptr || isLocked() || playlist < 0 || playlist > 1) {
+        return false;
+    }
+    // Check everything first, so that nothing is modified on failure
+    int end = m_playlists[playlist].get_playtime();
+    for (const auto &item : clips) {
+        std::shared_ptr<ClipModel> clip = ptr->getClipPtr(item.first);
+        bool typeMatches = clip->clipState() == PlaylistState::Disabled ? (isAudioTrack() ? clip->canBeAudio() : clip->canBeVideo())
+                                                                          : clip->clipState() == trackType();
+        if (!typeMatches || item.second < end || clip->getCurrentTrackId() != -1 || clip->getSubPlaylistIndex() != playlist) {
+            return false;
+        }
+        end = item.second + clip->getPlaytime();
+    }
+    Fun operation = [this, clips, playlist]() { return appendClips(clips, playlist); };
+    bool result = operation();
+    // Track effects are imported after the clips, so there is no stack length to adjust
+    std::vector<Fun> deletions;
+    deletions.reserve(clips.size());
+    for (const auto &item : clips) {
+        if (m_allClips.count(item.first) > 0) {
+            deletions.push_back(requestClipDeletion_lambda(item.first, false, true, true, true));
+        }
+    }
+    Fun reverse = [this, deletions]() {
+        bool deleted = true;
+        for (auto it = deletions.rbegin(); it != deletions.rend(); ++it) {
+            deleted = (*it)() && deleted;
+        }
+        if (auto timeline = m_parent.lock()) {
+            timeline->updateDuration();
+        }
+        return deleted;
+    };
+    if (!result) {
+        bool undone = reverse();
+        Q_ASSERT(undone);
+        return false;
+    }
+    UPDATE_UNDO_REDO(operation, reverse, undo, redo);
+    return true;
+}
+
+bool TrackModel::appendClips(const std::vector<std::pair<int, int>> &clips, int playlist)
+{
+    auto ptr = m_parent.lock();
+    if (!ptr || isLocked()) {
+        return false;
+    }
+    // Appending with explicit blanks avoids looking up and consolidating the blanks of the playlist for each clip
+    Mlt::Playlist &target = m_playlists[playlist];
+    target.lock();
+    int end = target.get_playtime();
+    bool ok = true;
+    for (const auto &item : clips) {
+        std::shared_ptr<ClipModel> clip = ptr->getClipPtr(item.first);
+        if (item.second > end) {
+            target.blank(item.second - end - 1);
+        }
+        clip->setCurrentTrackId(m_id, true);
+        if (target.append(*clip) != 0) {
+            clip->setCurrentTrackId(-1);
+            ok = false;
+            break;
+        }
+        m_allClips[item.first] = clip;
+        clip->setPosition(item.second);
+        clip->setSubPlaylistIndex(playlist, m_id);
+        end = item.second + clip->getPlaytime();
+        ptr->m_snaps->addPoint(item.second, SnapModel::ClipEdge, m_id);
+        ptr->m_snaps->addPoint(end, SnapModel::ClipEdge, m_id);
+    }
+    target.unlock();
+    ptr->updateDuration();
+    return ok;
+}
+
 void TrackModel::temporaryUnplugClip(int clipId)
 {
     QWriteLocker locker(&m_lock);
@@ -396,8 +477,8 @@ Fun TrackModel::requestClipDeletion_lambda(int clipId, bool updateView, bool fin
             delete prod;
             m_playlists[target_track].unlock();
             if (auto ptr = m_parent.lock()) {
-                ptr->m_snaps->removePoint(old_in);
-                ptr->m_snaps->removePoint(old_out);
+                ptr->m_snaps->removePoint(old_in, SnapModel::ClipEdge, m_id);
+                ptr->m_snaps->removePoint(old_out, SnapModel::ClipEdge, m_id);
                 if (finalMove) {
                     if (!audioOnly && !isAudioTrack()) {
                         emit ptr->invalidateZone(old_in, old_out);
@@ -594,11 +675,11 @@ Fun TrackModel::requestClipResize_lambda(int clipId, int in, int out, bool right
     auto update_snaps = [old_in, old_out, checkRefresh, right, clipId, this](int new_in, int new_out) {
         if (auto ptr = m_parent.lock()) {
             if (right) {
-                ptr->m_snaps->removePoint(old_out);
-                ptr->m_snaps->addPoint(new_out);
+                ptr->m_snaps->removePoint(old_out, SnapModel::ClipEdge, m_id);
+                ptr->m_snaps->addPoint(new_out, SnapModel::ClipEdge, m_id);
             } else {
-                ptr->m_snaps->removePoint(old_in);
-                ptr->m_snaps->addPoint(new_in);
+                ptr->m_snaps->removePoint(old_in, SnapModel::ClipEdge, m_id);
+                ptr->m_snaps->addPoint(new_in, SnapModel::ClipEdge, m_id);
             }
             if (checkRefresh) {
                 if (right) {
@@ -1197,10 +1278,10 @@ Fun TrackModel::requestCompositionResize_lambda(int compoId, int in, int out, bo
 
     auto update_snaps = [old_in, old_out, logUndo, this](int new_in, int new_out) {
         if (auto ptr = m_parent.lock()) {
-            ptr->m_snaps->removePoint(old_in);
-            ptr->m_snaps->removePoint(old_out + 1);
-            ptr->m_snaps->addPoint(new_in);
-            ptr->m_snaps->addPoint(new_out);
+            ptr->m_snaps->removePoint(old_in, SnapModel::ClipEdge, m_id);
+            ptr->m_snaps->removePoint(old_out + 1, SnapModel::ClipEdge, m_id);
+            ptr->m_snaps->addPoint(new_in, SnapModel::ClipEdge, m_id);
+            ptr->m_snaps->addPoint(new_out, SnapModel::ClipEdge, m_id);
             ptr->checkRefresh(old_in, old_out);
             ptr->checkRefresh(new_in, new_out);
             if (logUndo) {
@@ -1305,8 +1386,8 @@ Fun TrackModel::requestCompositionDeletion_lambda(int compoId, bool updateView,
         m_allCompositions[compoId]->setCurrentTrackId(-1);
         m_allCompositions.erase(compoId);
         m_compoPos.erase(old_in);
-        ptr->m_snaps->removePoint(old_in);
-        ptr->m_snaps->removePoint(old_out);
+        ptr->m_snaps->removePoint(old_in, SnapModel::ClipEdge, m_id);
+        ptr->m_snaps->removePoint(old_out, SnapModel::ClipEdge, m_id);
         if (finalMove) {
             emit ptr->invalidateZone(old_in, old_out);
         }
@@ -1357,8 +1438,8 @@ Fun TrackModel::requestCompositionInsertion_lambda(int compoId, int position, bo
                     ptr->_beginInsertRows(ptr->makeTrackIndexFromID(composition->getCurrentTrackId()), composition_index, composition_index);
                     ptr->_endInsertRows();
                 }
-                ptr->m_snaps->addPoint(new_in);
-                ptr->m_snaps->addPoint(new_out);
+                ptr->m_snaps->addPoint(new_in, SnapModel::ClipEdge, m_id);
+                ptr->m_snaps->addPoint(new_out, SnapModel::ClipEdge, m_id);
                 m_compoPos[new_in] = composition->getId();
                 if (finalMove) {
                     emit ptr->invalidateZone(new_in, new_out);
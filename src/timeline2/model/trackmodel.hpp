@@ -178,6 +178,18 @@ protected:
     /* @brief This function returns a lambda that performs the requested operation */
     Fun requestClipInsertion_lambda(int clipId, int position, bool updateView, bool finalMove, bool groupMove = false);
 
+    /* @brief Appends clips to a sub playlist while loading a project.
+       This skips the checks and notifications of an interactive insertion, the view must be reset afterwards.
+       Returns true if the operation succeeded, and otherwise, the track is not modified.
+       @param clips the ids of the clips with their position, sorted by position, not overlapping and after the current end of the playlist
+       @param playlist the sub playlist receiving the clips
+       @param undo Lambda function containing the current undo stack. Will be updated with current operation
+       @param redo Lambda function containing the current redo queue. Will be updated with current operation
+    */
+    bool loadClips(const std::vector<std::pair<int, int>> &clips, int playlist, Fun &undo, Fun &redo);
+    /* @brief Performs the insertion of loadClips, without checks */
+    bool appendClips(const std::vector<std::pair<int, int>> &clips, int playlist);
+
     /* @brief Performs an deletion of the given clip.
        Returns true if the operation succeeded, and otherwise, the track is not modified.
        This method is protected because it shouldn't be called directly. Call the function in the timeline instead.
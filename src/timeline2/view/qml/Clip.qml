@@ -63,6 +63,7 @@ Rectangle {
     property int trackId: -1 // Id of the parent track in the model
     property int fakeTid: -1
     property int fakePosition: 0
+    property var previewParent
     property int originalTrackId: -1
     property int originalX: x
     property int originalDuration: clipDuration
@@ -146,6 +147,7 @@ Rectangle {
         if (clipRoot.fakeTid > -1 && parentTrack) {
             if (clipRoot.parent != dragContainer) {
                 var pos = clipRoot.mapToGlobal(clipRoot.x, clipRoot.y);
+                clipRoot.previewParent = clipRoot.parent
                 clipRoot.parent = dragContainer
                 pos = clipRoot.mapFromGlobal(pos.x, pos.y)
                 clipRoot.x = pos.x
@@ -153,6 +155,13 @@ Rectangle {
             }
             clipRoot.y = Logic.getTrackById(clipRoot.fakeTid).y
             clipRoot.height = Logic.getTrackById(clipRoot.fakeTid).height
+        } else if (clipRoot.fakeTid == -1 && clipRoot.previewParent && clipRoot.parent == dragContainer) {
+            // The drag preview ended without recreating this item, put it back in its track
+            clipRoot.parent = clipRoot.previewParent
+            clipRoot.previewParent = undefined
+            clipRoot.x = clipRoot.modelStart * clipRoot.timeScale
+            clipRoot.y = 0
+            clipRoot.height = Qt.binding(function() { return parentTrack.height })
         }
     }
 
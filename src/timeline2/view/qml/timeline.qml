@@ -479,7 +479,8 @@ Rectangle {
             if (clipBeingDroppedId != -1) {
                 var frame = controller.getClipPosition(clipBeingDroppedId)
                 var track = controller.getClipTrackId(clipBeingDroppedId)
-                if (!controller.normalEdit()) {
+                if (!controller.normalEdit() || fakeTrack > -1) {
+                    // The clip was moved as a preview, drop it at the place of the preview
                     frame = fakeFrame
                     track = fakeTrack
                 }
@@ -547,6 +548,8 @@ Rectangle {
             if (clipBeingDroppedId != -1 && drag.y < drag.x) {
                 // If we exit on top, remove clip
                 controller.requestItemDeletion(clipBeingDroppedId, false)
+                fakeTrack = -1
+                fakeFrame = -1
                 clearDropData()
             } else {
                 // Clip is dropped
@@ -1384,7 +1387,7 @@ Rectangle {
                                             var posx = Math.round((parent.x)/ root.timeScale)
                                             var posy = Math.min(Math.max(0, dragProxyArea.mouseY + parent.y - dragProxy.verticalOffset), tracksContainerArea.height)
                                             var tId = Logic.getTrackIdFromPos(posy)
-                                            if (dragProxy.masterObject && tId == dragProxy.masterObject.trackId) {
+                                            if (dragProxy.masterObject && tId == timeline.getItemMovingTrack(dragProxy.draggedItem)) {
                                                 if (posx == dragFrame && controller.normalEdit()) {
                                                     return
                                                 }
@@ -1428,8 +1431,8 @@ Rectangle {
                                                 controller.requestCompositionMove(dragProxy.draggedItem, tId, dragFrame , true, true, true)
                                             } else {
                                                 if (controller.normalEdit()) {
-                                                    controller.requestClipMove(dragProxy.draggedItem, dragProxy.sourceTrack, dragProxy.sourceFrame, moveMirrorTracks, true, false, false)
-                                                    controller.requestClipMove(dragProxy.draggedItem, tId, dragFrame , moveMirrorTracks, true, true, true)
+                                                    // The drag only moved a preview, move the clips in one operation
+                                                    controller.requestClipDragEnd(dragProxy.draggedItem, dragProxy.sourceTrack, dragProxy.sourceFrame, dragFrame, moveMirrorTracks)
                                                 } else {
                                                     // Fake move, only process final move
                                                     timeline.endFakeMove(dragProxy.draggedItem, dragFrame, true, true, true)
@@ -1104,8 +1104,22 @@ void TimelineController::addAsset(const QVariantMap &data)
             }
         }
         bool foundMatch = false;
-        for (int id : qAsConst(effectSelection)) {
-            if (m_model->addClipEffect(id, effect, false)) {
+        if (EffectsRepository::get()->isGroup(effect)) {
+            for (int id : qAsConst(effectSelection)) {
+                if (m_model->addClipEffect(id, effect, false)) {
+                    foundMatch = true;
+                }
+            }
+        } else {
+            // Add the effect to all selected clips in one operation
+            std::vector<std::shared_ptr<EffectStackModel>> stacks;
+            for (int id : qAsConst(effectSelection)) {
+                stacks.push_back(m_model->getClipEffectStackModel(id));
+            }
+            Fun undo = []() { return true; };
+            Fun redo = []() { return true; };
+            if (EffectStackModel::appendEffects(stacks, {EffectStackModel::describeEffect(effect)}, undo, redo, true) > 0) {
+                pCore->pushUndo(undo, redo, i18n("Add effect %1", EffectsRepository::get()->getName(effect)));
                 foundMatch = true;
             }
         }
@@ -1988,7 +2002,7 @@ void TimelineController::removeSpace(int trackId, int frame, bool affectAllTrack
 
 void TimelineController::invalidateItem(int cid)
 {
-    if (!m_timelinePreview || !m_model->isItem(cid)) {
+    if (!m_model->isItem(cid)) {
         return;
     }
     const int tid = m_model->getItemTrackId(cid);
@@ -1997,12 +2011,15 @@ void TimelineController::invalidateItem(int cid)
     }
     int start = m_model->getItemPosition(cid);
     int end = start + m_model->getItemPlaytime(cid);
-    m_timelinePreview->invalidatePreview(start, end);
+    pCore->monitorManager()->projectMonitor()->invalidateFrameCache(start, end);
+    if (m_timelinePreview) {
+        m_timelinePreview->invalidatePreview(start, end);
+    }
 }
 
 void TimelineController::invalidateTrack(int tid)
 {
-    if (!m_timelinePreview || !m_model->isTrack(tid) || m_model->getTrackById_const(tid)->isAudioTrack()) {
+    if (!m_model->isTrack(tid) || m_model->getTrackById_const(tid)->isAudioTrack()) {
         return;
     }
     for (const auto &clp : m_model->getTrackById_const(tid)->m_allClips) {
@@ -2012,6 +2029,7 @@ void TimelineController::invalidateTrack(int tid)
 
 void TimelineController::invalidateZone(int in, int out)
 {
+    pCore->monitorManager()->projectMonitor()->invalidateFrameCache(in, out);
     if (!m_timelinePreview) {
         return;
     }
@@ -2848,13 +2866,12 @@ void TimelineController::pasteEffects(int targetId)
             effects.appendChild(subs.at(0));
         }
     }
-    int insertedEffects = 0;
+    // Parse the effects once and add them to all targets in a single operation
+    std::vector<std::shared_ptr<EffectStackModel>> stacks;
     for (int target : targetIds) {
-        std::shared_ptr<EffectStackModel> destStack = m_model->getClipEffectStackModel(target);
-        if (destStack->fromXml(effects, undo, redo)) {
-            insertedEffects++;
-        }
+        stacks.push_back(m_model->getClipEffectStackModel(target));
     }
+    int insertedEffects = EffectStackModel::appendEffects(stacks, EffectStackModel::parseEffects(effects), undo, redo);
     if (insertedEffects > 0) {
         pCore->pushUndo(undo, redo, i18n("Paste effects"));
     } else {
@@ -3133,10 +3150,8 @@ void TimelineController::grabCurrent()
 int TimelineController::getItemMovingTrack(int itemId) const
 {
     if (m_model->isClip(itemId)) {
-        int trackId = -1;
-        if (m_model->m_editMode != TimelineMode::NormalEdit) {
-            trackId = m_model->m_allClips[itemId]->getFakeTrackId();
-        }
+        // In normal edit mode, the fake track is the one of the drag preview
+        int trackId = m_model->m_allClips[itemId]->getFakeTrackId();
         return trackId < 0 ? m_model->m_allClips[itemId]->getCurrentTrackId() : trackId;
     }
     return m_model->m_allCompositions[itemId]->getCurrentTrackId();
@@ -0,0 +1,279 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "titlebatch.hpp"
+#include "core.h"
+#include "doc/kdenlivedoc.h"
+#include "klocalizedstring.h"
+
+#include <QCryptographicHash>
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <memory>
+#include <mlt++/MltFrame.h>
+#include <mlt++/MltProducer.h>
+#include <mlt++/MltProfile.h>
+
+bool TitleBatch::readData(const QString &path, Data &data, QString &error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = i18n("Cannot read file %1", path);
+        return false;
+    }
+    const QByteArray content = file.readAll();
+    file.close();
+    if (QFileInfo(path).suffix().toLower() == QLatin1String("json")) {
+        if (!parseJson(content, data, error)) {
+            return false;
+        }
+    } else {
+        data = parseCsv(QString::fromUtf8(content));
+    }
+    if (data.columns.isEmpty() || data.rows.isEmpty()) {
+        error = i18n("No data found in %1", path);
+        return false;
+    }
+    return true;
+}
+
+TitleBatch::Data TitleBatch::parseCsv(const QString &content)
+{
+    Data data;
+    // Guess the separator from the header line
+    const QString header = content.section(QLatin1Char('\n'), 0, 0);
+    QChar separator = QLatin1Char(',');
+    if (header.count(QLatin1Char('\t')) > header.count(separator)) {
+        separator = QLatin1Char('\t');
+    }
+    if (header.count(QLatin1Char(';')) > header.count(separator)) {
+        separator = QLatin1Char(';');
+    }
+    QStringList line;
+    QString field;
+    bool quoted = false;
+    auto endLine = [&]() {
+        line << field;
+        field.clear();
+        if (line.count() > 1 || !line.first().trimmed().isEmpty()) {
+            if (data.columns.isEmpty()) {
+                for (const QString &column : qAsConst(line)) {
+                    data.columns << column.trimmed();
+                }
+            } else {
+                while (line.count() < data.columns.count()) {
+                    line << QString();
+                }
+                data.rows << line.mid(0, data.columns.count());
+            }
+        }
+        line.clear();
+    };
+    for (int i = 0; i < content.length(); ++i) {
+        const QChar c = content.at(i);
+        if (quoted) {
+            if (c != QLatin1Char('"')) {
+                field.append(c);
+            } else if (i + 1 < content.length() && content.at(i + 1) == QLatin1Char('"')) {
+                // Escaped quote
+                field.append(c);
+                ++i;
+            } else {
+                quoted = false;
+            }
+        } else if (c == QLatin1Char('"')) {
+            quoted = true;
+        } else if (c == separator) {
+            line << field;
+            field.clear();
+        } else if (c == QLatin1Char('\n')) {
+            endLine();
+        } else if (c != QLatin1Char('\r')) {
+            field.append(c);
+        }
+    }
+    if (!field.isEmpty() || !line.isEmpty()) {
+        endLine();
+    }
+    return data;
+}
+
+bool TitleBatch::parseJson(const QByteArray &content, Data &data, QString &error)
+{
+    QJsonParseError parseError;
+    const QJsonDocument json = QJsonDocument::fromJson(content, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        error = parseError.errorString();
+        return false;
+    }
+    if (!json.isArray()) {
+        error = i18n("The data must be an array of objects");
+        return false;
+    }
+    const QJsonArray array = json.array();
+    for (const QJsonValue &value : array) {
+        const QStringList keys = value.toObject().keys();
+        for (const QString &key : keys) {
+            if (!data.columns.contains(key)) {
+                data.columns << key;
+            }
+        }
+    }
+    for (const QJsonValue &value : array) {
+        const QJsonObject object = value.toObject();
+        QStringList row;
+        for (const QString &column : qAsConst(data.columns)) {
+            row << object.value(column).toVariant().toString();
+        }
+        data.rows << row;
+    }
+    return true;
+}
+
+QString TitleBatch::applyRow(const QString &titleXml, const QStringList &columns, const QStringList &row)
+{
+    QDomDocument doc;
+    if (!doc.setContent(titleXml) || columns.isEmpty()) {
+        return titleXml;
+    }
+    // The first column with a name is used for its placeholder
+    QHash<QString, int> columnIndex;
+    for (int j = columns.count() - 1; j >= 0; --j) {
+        columnIndex.insert(columns.at(j), j);
+    }
+    QDomNodeList items = doc.documentElement().elementsByTagName(QStringLiteral("item"));
+    for (int i = 0; i < items.count(); ++i) {
+        QDomElement item = items.item(i).toElement();
+        if (item.attribute(QStringLiteral("type")) != QLatin1String("QGraphicsTextItem")) {
+            continue;
+        }
+        QDomElement content = item.firstChildElement(QStringLiteral("content"));
+        const QString text = content.text();
+        if (!text.contains(QLatin1Char('%')) && !text.contains(QLatin1Char('{'))) {
+            continue;
+        }
+        // Substitute in a single pass, so that values containing placeholders are inserted as is
+        QString filled;
+        filled.reserve(text.length());
+        for (int pos = 0; pos < text.length(); ++pos) {
+            if (text.at(pos) == QLatin1Char('%') && pos + 1 < text.length() && text.at(pos + 1) == QLatin1Char('s')) {
+                filled.append(row.value(0));
+                ++pos;
+                continue;
+            }
+            if (text.at(pos) == QLatin1Char('{')) {
+                int end = text.indexOf(QLatin1Char('}'), pos + 1);
+                int column = end > pos ? columnIndex.value(text.mid(pos + 1, end - pos - 1), -1) : -1;
+                if (column > -1) {
+                    filled.append(row.value(column));
+                    pos = end;
+                    continue;
+                }
+            }
+            filled.append(text.at(pos));
+        }
+        while (content.hasChildNodes()) {
+            content.removeChild(content.firstChild());
+        }
+        content.appendChild(doc.createTextNode(filled));
+    }
+    return doc.toString();
+}
+
+bool TitleBatch::isStatic(const QString &titleXml)
+{
+    QDomDocument doc;
+    if (!doc.setContent(titleXml)) {
+        return false;
+    }
+    QDomElement root = doc.documentElement();
+    const QString start = root.firstChildElement(QStringLiteral("startviewport")).attribute(QStringLiteral("rect"));
+    const QString end = root.firstChildElement(QStringLiteral("endviewport")).attribute(QStringLiteral("rect"));
+    if (start != end) {
+        return false;
+    }
+    QDomNodeList contents = root.elementsByTagName(QStringLiteral("content"));
+    for (int i = 0; i < contents.count(); ++i) {
+        if (contents.item(i).toElement().hasAttribute(QStringLiteral("typewriter"))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString TitleBatch::cacheKey(const QString &titleXml, const QSize &size)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(titleXml.toUtf8());
+    hash.addData(QStringLiteral("%1x%2").arg(size.width()).arg(size.height()).toUtf8());
+    return hash.result().toHex();
+}
+
+QString TitleBatch::cachePath(const QString &titleXml)
+{
+    if (pCore->currentDoc() == nullptr) {
+        return QString();
+    }
+    bool ok = false;
+    QDir dir = pCore->currentDoc()->getCacheDir(CacheThumbs, &ok);
+    if (!ok) {
+        return QString();
+    }
+    return cachePath(dir, titleXml, pCore->getCurrentFrameSize());
+}
+
+QString TitleBatch::cachePath(const QDir &cacheDir, const QString &titleXml, const QSize &size)
+{
+    return cacheDir.absoluteFilePath(QStringLiteral("title-%1.png").arg(cacheKey(titleXml, size)));
+}
+
+QImage TitleBatch::render(const QString &titleXml, const QSize &size)
+{
+    Mlt::Profile profile;
+    profile.set_explicit(1);
+    profile.set_width(size.width());
+    profile.set_height(size.height());
+    profile.set_sample_aspect(1, 1);
+    profile.set_display_aspect(size.width(), size.height());
+    Mlt::Producer producer(profile, "kdenlivetitle");
+    if (!producer.is_valid()) {
+        return QImage();
+    }
+    producer.set("xmldata", titleXml.toUtf8().constData());
+    std::unique_ptr<Mlt::Frame> frame(producer.get_frame());
+    if (frame == nullptr || !frame->is_valid()) {
+        return QImage();
+    }
+    mlt_image_format format = mlt_image_rgba;
+    int width = size.width();
+    int height = size.height();
+    const uchar *image = frame->get_image(format, width, height);
+    if (image == nullptr || format != mlt_image_rgba) {
+        return QImage();
+    }
+    // The frame owns the data
+    return QImage(image, width, height, QImage::Format_RGBA8888).copy();
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QDir>
+#include <QImage>
+#include <QSize>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @class TitleBatch
+ * @brief Generates titles from a template and a table of values (CSV or JSON file)
+ *
+ * In the text items of the template, %s is replaced by the value of the first column and {name}
+ * by the value of the column called name. Titles without animation are rendered once to the
+ * project cache, under a key derived from their content, and the thumbnails of the clips are
+ * then read from these images.
+ */
+
+class TitleBatch
+{
+public:
+    struct Data
+    {
+        QStringList columns;
+        QVector<QStringList> rows;
+    };
+
+    /** @brief Reads a data file, CSV with a header line or JSON array of objects
+        @return false and sets error if the file cannot be read */
+    static bool readData(const QString &path, Data &data, QString &error);
+    /** @brief Parses CSV content. The first line holds the column names, the separator is a comma, semicolon or tab */
+    static Data parseCsv(const QString &content);
+    /** @brief Parses a JSON array of objects. The columns are the keys of the objects, in alphabetical order */
+    static bool parseJson(const QByteArray &content, Data &data, QString &error);
+
+    /** @brief Returns the xml of a title where the placeholders are replaced by the values of a row */
+    static QString applyRow(const QString &titleXml, const QStringList &columns, const QStringList &row);
+    /** @brief Returns true if the title has no animation, so that all its frames are identical */
+    static bool isStatic(const QString &titleXml);
+
+    /** @brief Returns the key of the render of a title at the given frame size */
+    static QString cacheKey(const QString &titleXml, const QSize &size);
+    /** @brief Returns the path of the render of a title at the project frame size in the project cache, empty if the cache is not available */
+    static QString cachePath(const QString &titleXml);
+    static QString cachePath(const QDir &cacheDir, const QString &titleXml, const QSize &size);
+    /** @brief Renders the first frame of a title. Each call uses its own producer, so it can run in any thread */
+    static QImage render(const QString &titleXml, const QSize &size);
+};
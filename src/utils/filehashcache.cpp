@@ -0,0 +1,203 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "filehashcache.hpp"
+#include "kdenlive_debug.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#ifndef Q_OS_WIN
+#include <sys/stat.h>
+#endif
+
+namespace {
+// Bump when the hashing or the file format change
+const qint32 cacheVersion = 1;
+// Above this, entries that were not used in the session are not saved
+const int maxEntries = 100000;
+} // namespace
+
+std::unique_ptr<FileHashCache> FileHashCache::instance;
+std::once_flag FileHashCache::m_onceFlag;
+
+FileHashCache::FileHashCache()
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    m_path = dir.absoluteFilePath(QStringLiteral("filehashes"));
+    load();
+}
+
+std::unique_ptr<FileHashCache> &FileHashCache::get()
+{
+    std::call_once(m_onceFlag, [] { instance.reset(new FileHashCache()); });
+    return instance;
+}
+
+bool FileHashCache::signature(const QString &path, Signature &result)
+{
+    QFileInfo info(path);
+    if (!info.isFile() || !info.isReadable()) {
+        return false;
+    }
+    result.size = info.size();
+    result.modified = info.lastModified().toMSecsSinceEpoch();
+#ifndef Q_OS_WIN
+    struct stat st;
+    if (::stat(QFile::encodeName(path).constData(), &st) == 0) {
+        result.device = quint64(st.st_dev);
+        result.inode = quint64(st.st_ino);
+    }
+#endif
+    return true;
+}
+
+QByteArray FileHashCache::computeHash(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    /*
+     * 1 MB = 1 second per 450 files (or faster)
+     * 10 MB = 9 seconds per 450 files (or faster)
+     */
+    QByteArray fileData;
+    if (file.size() > 2000000) {
+        fileData = file.read(1000000);
+        if (file.seek(file.size() - 1000000)) {
+            fileData.append(file.readAll());
+        }
+    } else {
+        fileData = file.readAll();
+    }
+    file.close();
+    return QCryptographicHash::hash(fileData, QCryptographicHash::Md5);
+}
+
+QPair<QByteArray, qint64> FileHashCache::fileHash(const QString &path)
+{
+    Signature current;
+    if (!signature(path, current)) {
+        return {QByteArray(), 0};
+    }
+    {
+        QMutexLocker lock(&m_mutex);
+        auto it = m_entries.find(path);
+        if (it != m_entries.end() && it->signature == current) {
+            it->used = true;
+            return {it->hash, current.size};
+        }
+    }
+    const QByteArray hash = computeHash(path);
+    if (!hash.isEmpty()) {
+        QMutexLocker lock(&m_mutex);
+        Entry &entry = m_entries[path];
+        entry.signature = current;
+        entry.hash = hash;
+        entry.used = true;
+        m_changed = true;
+    }
+    return {hash, current.size};
+}
+
+QFuture<void> FileHashCache::prefetch(const QStringList &paths)
+{
+    QStringList files = paths;
+    files.removeDuplicates();
+    return QtConcurrent::run([this, files]() {
+        QtConcurrent::blockingMap(files, [this](const QString &path) { fileHash(path); });
+        save();
+    });
+}
+
+void FileHashCache::load()
+{
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDataStream in(&file);
+    qint32 version;
+    in >> version;
+    if (version != cacheVersion) {
+        return;
+    }
+    qint32 count;
+    in >> count;
+    m_entries.reserve(count);
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Entry entry;
+        in >> path >> entry.signature.device >> entry.signature.inode >> entry.signature.size >> entry.signature.modified >> entry.hash;
+        m_entries.insert(path, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qCDebug(KDENLIVE_LOG) << "Discarding corrupted file hash cache" << m_path;
+        m_entries.clear();
+    }
+}
+
+void FileHashCache::save()
+{
+    QMutexLocker saveLock(&m_saveMutex);
+    QHash<QString, Entry> entries;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (!m_changed || m_path.isEmpty()) {
+            return;
+        }
+        // Implicitly shared, the copy is cheap and detaches only if hashes are added while writing
+        entries = m_entries;
+        m_changed = false;
+    }
+    bool prune = entries.size() > maxEntries;
+    qint32 count = 0;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (!prune || it->used) {
+            count++;
+        }
+    }
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile file(m_path);
+    if (file.open(QIODevice::WriteOnly)) {
+        QDataStream out(&file);
+        out << cacheVersion << count;
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            if (prune && !it->used) {
+                continue;
+            }
+            const Signature &sig = it->signature;
+            out << it.key() << sig.device << sig.inode << sig.size << sig.modified << it->hash;
+        }
+        if (file.commit()) {
+            return;
+        }
+    }
+    qCDebug(KDENLIVE_LOG) << "Cannot write file hash cache" << m_path;
+    QMutexLocker lock(&m_mutex);
+    m_changed = true;
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <mutex>
+
+/** @brief This class memoizes the hashes of media files, which are used to detect changed or moved clips.
+    Hashing a file reads its first and last megabyte, which is slow on network storage. The hashes are stored with the signature of the
+    file (device, inode, size and modification time), and only recomputed when it changes.
+    The memo is shared by all projects and saved in the cache folder.
+ * Note that this class is a Singleton
+ */
+
+class FileHashCache
+{
+
+public:
+    // Returns the instance of the Singleton
+    static std::unique_ptr<FileHashCache> &get();
+
+    /* @brief Returns the hash of a file and its size, computing it only if the file changed since it was last hashed
+       Returns an empty hash if the file cannot be read
+     */
+    QPair<QByteArray, qint64> fileHash(const QString &path);
+
+    /* @brief Hashes the files that are not in the memo yet, in parallel, in the global thread pool, without waiting for the result */
+    QFuture<void> prefetch(const QStringList &paths);
+
+    /* @brief Writes the memo to disk if it changed. Called when a document is closed */
+    void save();
+
+protected:
+    // Constructor is protected because class is a Singleton
+    FileHashCache();
+
+    static std::unique_ptr<FileHashCache> instance;
+    static std::once_flag m_onceFlag; // flag to create the cache only once;
+
+    struct Signature
+    {
+        quint64 device = 0;
+        quint64 inode = 0;
+        qint64 size = 0;
+        qint64 modified = 0;
+        bool operator==(const Signature &other) const
+        {
+            return device == other.device && inode == other.inode && size == other.size && modified == other.modified;
+        }
+    };
+    struct Entry
+    {
+        Signature signature;
+        QByteArray hash;
+        bool used = false; // Whether the entry was used in this session
+    };
+
+    // Returns the signature of a file, or false if it is not a readable file
+    static bool signature(const QString &path, Signature &result);
+    // Hashes the first and last megabyte of a file
+    static QByteArray computeHash(const QString &path);
+
+    void load();
+
+    QString m_path;
+    QHash<QString, Entry> m_entries;
+    bool m_changed = false;
+    mutable QMutex m_mutex;
+    // Serializes the writes of the memo, which happen outside of m_mutex
+    QMutex m_saveMutex;
+};
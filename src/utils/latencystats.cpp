@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "latencystats.hpp"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QtAlgorithms>
+
+std::unique_ptr<LatencyStats> LatencyStats::instance;
+std::once_flag LatencyStats::m_onceFlag;
+thread_local int LatencyProbe::s_depth = 0;
+
+std::unique_ptr<LatencyStats> &LatencyStats::get()
+{
+    std::call_once(m_onceFlag, [] { instance.reset(new LatencyStats()); });
+    return instance;
+}
+
+void LatencyStats::record(const char *operation, qint64 usecs)
+{
+    int bucket = usecs <= 0 ? 0 : qMin(bucketCount - 1, 64 - int(qCountLeadingZeroBits(quint64(usecs))));
+    QMutexLocker lk(&m_mutex);
+    Histogram &histogram = m_histograms[operation];
+    histogram.count++;
+    histogram.totalUs += usecs;
+    histogram.maxUs = qMax(histogram.maxUs, usecs);
+    histogram.buckets[size_t(bucket)]++;
+}
+
+QVector<LatencyStats::Summary> LatencyStats::summaries() const
+{
+    QVector<Summary> result;
+    QMutexLocker lk(&m_mutex);
+    for (const auto &entry : m_histograms) {
+        const Histogram &histogram = entry.second;
+        Summary summary;
+        summary.operation = QString::fromStdString(entry.first);
+        summary.count = histogram.count;
+        summary.totalUs = histogram.totalUs;
+        summary.maxUs = histogram.maxUs;
+        summary.buckets.reserve(bucketCount);
+        qint64 p50 = -1, p95 = -1, p99 = -1;
+        qint64 seen = 0;
+        for (int i = 0; i < bucketCount; ++i) {
+            qint64 count = histogram.buckets[size_t(i)];
+            summary.buckets << count;
+            seen += count;
+            // The maximum is more accurate than the bound of the last bucket
+            qint64 bound = qMin(histogram.maxUs, qint64(1) << i);
+            if (p50 < 0 && seen * 100 >= histogram.count * 50) {
+                p50 = bound;
+            }
+            if (p95 < 0 && seen * 100 >= histogram.count * 95) {
+                p95 = bound;
+            }
+            if (p99 < 0 && seen * 100 >= histogram.count * 99) {
+                p99 = bound;
+            }
+        }
+        summary.p50Us = p50;
+        summary.p95Us = p95;
+        summary.p99Us = p99;
+        result << summary;
+    }
+    return result;
+}
+
+QString LatencyStats::toJson() const
+{
+    QJsonArray list;
+    for (const Summary &summary : summaries()) {
+        QJsonObject operation;
+        operation.insert(QStringLiteral("operation"), summary.operation);
+        operation.insert(QStringLiteral("count"), summary.count);
+        operation.insert(QStringLiteral("total_us"), summary.totalUs);
+        operation.insert(QStringLiteral("max_us"), summary.maxUs);
+        operation.insert(QStringLiteral("p50_us"), summary.p50Us);
+        operation.insert(QStringLiteral("p95_us"), summary.p95Us);
+        operation.insert(QStringLiteral("p99_us"), summary.p99Us);
+        QJsonArray buckets;
+        for (qint64 count : summary.buckets) {
+            buckets.append(count);
+        }
+        operation.insert(QStringLiteral("buckets"), buckets);
+        list.append(operation);
+    }
+    return QString::fromUtf8(QJsonDocument(list).toJson(QJsonDocument::Compact));
+}
+
+void LatencyStats::reset()
+{
+    QMutexLocker lk(&m_mutex);
+    m_histograms.clear();
+}
+
+LatencyProbe::LatencyProbe(const char *operation)
+    : m_operation(operation)
+    , m_outermost(s_depth == 0)
+{
+    s_depth++;
+    if (m_outermost) {
+        m_timer.start();
+    }
+}
+
+LatencyProbe::~LatencyProbe()
+{
+    s_depth--;
+    if (m_outermost) {
+        LatencyStats::get()->record(m_operation, m_timer.nsecsElapsed() / 1000);
+    }
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/** @brief This class aggregates the duration of user operations (timeline edits, jobs, autosaves, monitor refreshes) in histograms.
+    The statistics can be displayed in the application or collected over D-Bus, to find which operations are slow in real sessions.
+ * Note that this class is a Singleton
+ */
+
+class LatencyStats
+{
+
+public:
+    // Returns the instance of the Singleton
+    static std::unique_ptr<LatencyStats> &get();
+
+    /* @brief Number of histogram buckets. Bucket 0 counts durations below 1µs, bucket i durations between 2^(i-1) and 2^i µs */
+    static const int bucketCount = 32;
+
+    struct Summary
+    {
+        QString operation;
+        qint64 count;
+        qint64 totalUs;
+        qint64 maxUs;
+        // Percentiles are the upper bound of the bucket they fall in
+        qint64 p50Us;
+        qint64 p95Us;
+        qint64 p99Us;
+        QVector<qint64> buckets;
+    };
+
+    /* @brief Adds the duration of an operation, in microseconds, to its histogram */
+    void record(const char *operation, qint64 usecs);
+
+    /* @brief Returns the statistics of all the measured operations, sorted by name */
+    QVector<Summary> summaries() const;
+
+    /* @brief Returns the statistics as a JSON document */
+    QString toJson() const;
+
+    /* @brief Forgets all measurements */
+    void reset();
+
+protected:
+    // Constructor is protected because class is a Singleton
+    LatencyStats() = default;
+
+    static std::unique_ptr<LatencyStats> instance;
+    static std::once_flag m_onceFlag; // flag to create the statistics only once;
+
+    struct Histogram
+    {
+        qint64 count = 0;
+        qint64 totalUs = 0;
+        qint64 maxUs = 0;
+        std::array<qint64, bucketCount> buckets{};
+    };
+    mutable QMutex m_mutex;
+    std::map<std::string, Histogram> m_histograms;
+};
+
+/** @brief Measures the time until it goes out of scope, and records it in the LatencyStats.
+    Only the outermost probe of a thread records, so that an operation calling other probed operations is measured once.
+ */
+class LatencyProbe
+{
+public:
+    explicit LatencyProbe(const char *operation);
+    ~LatencyProbe();
+
+private:
+    const char *m_operation;
+    QElapsedTimer m_timer;
+    bool m_outermost;
+    static thread_local int s_depth;
+};
@@ -0,0 +1,108 @@
+/***************************************************************************
+ *   Copyright (C) 2021 by the Kdenlive developers                         *
+ *   This file is part of Kdenlive. See www.kdenlive.org.                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3 or any later version accepted by the       *
+ *   membership of KDE e.V. (or its successor approved  by the membership  *
+ *   of KDE e.V.), which shall act as a proxy defined in Section 14 of     *
+ *   version 3 of the license.                                             *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * @class TickTime
+ * @brief An exact time position, stored as an integer number of ticks.
+ * A second is divided in 705600000 ticks, so that the frame duration of all common frame rates (24, 25, 30, 48, 50, 60, 120
+ * and their 1000/1001 NTSC variants) is a whole number of ticks. Frame arithmetic is exact and comparisons are plain integer
+ * comparisons, which makes this type suitable as the key of ordered containers.
+ */
+class TickTime
+{
+public:
+    /** @brief Creates a time of 0 */
+    constexpr TickTime() = default;
+
+    static constexpr qint64 ticksPerSecond() { return 705600000; }
+
+    static constexpr TickTime fromTicks(qint64 ticks) { return TickTime(ticks); }
+
+    /** @brief Returns the position of a frame for a frame rate of num / den, rounded to the nearest tick */
+    static constexpr TickTime fromFrames(qint64 frames, int num, int den)
+    {
+        // Split the computation so that the intermediate values cannot overflow
+        return TickTime(frames / num * den * ticksPerSecond() + roundedDiv(frames % num * den * ticksPerSecond(), num));
+    }
+
+    /** @brief Returns the position of a frame for a frame rate given as a double, rounded to the nearest tick */
+    static constexpr TickTime fromFrames(qint64 frames, double fps) { return TickTime(roundToInt(double(frames) * ticksPerSecond() / fps)); }
+
+    static constexpr TickTime fromSeconds(double seconds) { return TickTime(roundToInt(seconds * ticksPerSecond())); }
+
+    constexpr qint64 ticks() const { return m_ticks; }
+
+    constexpr double seconds() const { return double(m_ticks) / ticksPerSecond(); }
+
+    constexpr double ms() const { return double(m_ticks) * 1000 / ticksPerSecond(); }
+
+    /** @brief Returns the nearest frame for a frame rate of num / den */
+    constexpr qint64 frames(int num, int den) const
+    {
+        return floorDiv(m_ticks, den * ticksPerSecond()) * num + roundedDiv(floorMod(m_ticks, den * ticksPerSecond()) * num, den * ticksPerSecond());
+    }
+
+    /** @brief Returns the nearest frame for a frame rate given as a double */
+    constexpr int frames(double fps) const { return int(roundToInt(double(m_ticks) * fps / ticksPerSecond())); }
+
+    /** @brief Returns this time moved to the start of the nearest frame */
+    constexpr TickTime roundedToFrame(double fps) const { return fromFrames(frames(fps), fps); }
+
+    constexpr TickTime operator-() const { return TickTime(-m_ticks); }
+    constexpr TickTime operator+(TickTime op) const { return TickTime(m_ticks + op.m_ticks); }
+    constexpr TickTime operator-(TickTime op) const { return TickTime(m_ticks - op.m_ticks); }
+    TickTime &operator+=(TickTime op)
+    {
+        m_ticks += op.m_ticks;
+        return *this;
+    }
+    TickTime &operator-=(TickTime op)
+    {
+        m_ticks -= op.m_ticks;
+        return *this;
+    }
+
+    constexpr bool operator<(TickTime op) const { return m_ticks < op.m_ticks; }
+    constexpr bool operator>(TickTime op) const { return m_ticks > op.m_ticks; }
+    constexpr bool operator<=(TickTime op) const { return m_ticks <= op.m_ticks; }
+    constexpr bool operator>=(TickTime op) const { return m_ticks >= op.m_ticks; }
+    constexpr bool operator==(TickTime op) const { return m_ticks == op.m_ticks; }
+    constexpr bool operator!=(TickTime op) const { return m_ticks != op.m_ticks; }
+
+private:
+    constexpr explicit TickTime(qint64 ticks)
+        : m_ticks(ticks)
+    {
+    }
+
+    static constexpr qint64 floorDiv(qint64 a, qint64 b) { return a / b - ((a % b != 0 && a < 0) ? 1 : 0); }
+    static constexpr qint64 floorMod(qint64 a, qint64 b) { return a - floorDiv(a, b) * b; }
+    /** @brief Division of a by a positive b, rounded to the nearest integer (halves are rounded up, like frame rounding in GenTime) */
+    static constexpr qint64 roundedDiv(qint64 a, qint64 b) { return floorDiv(2 * a + b, 2 * b); }
+    /** @brief Same as floor(value + 0.5) */
+    static constexpr qint64 roundToInt(double value) { return qint64(value + 0.5) - (double(qint64(value + 0.5)) > value + 0.5 ? 1 : 0); }
+
+    qint64 m_ticks{0};
+};
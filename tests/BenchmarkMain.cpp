@@ -0,0 +1,55 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+
+#include "benchmarkreport.hpp"
+#include <QApplication>
+#include <QLoggingCategory>
+#include <iostream>
+#include <mlt++/MltFactory.h>
+#include <mlt++/MltRepository.h>
+#define private public
+#define protected public
+#include "core.h"
+#include "logger.hpp"
+#include "src/effects/effectsrepository.hpp"
+#include "src/mltcontroller/clipcontroller.h"
+/* This file is intended to remain empty.
+Write your benchmarks in a file with a name corresponding to what you're measuring */
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("kdenlive"));
+    std::unique_ptr<Mlt::Repository> repo(Mlt::Factory::init(nullptr));
+    qputenv("MLT_TESTS", QByteArray("1"));
+    Core::build(false);
+    Logger::init();
+    // Tracing every model operation would be measured too
+    Logger::setEnabled(false);
+    // Same for debug output
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+    // if Kdenlive is not installed, ensure we have one keyframable effect
+    EffectsRepository::get()->reloadCustom(QFileInfo("../data/effects/audiobalance.xml").absoluteFilePath());
+
+    Catch::Session session;
+    std::string jsonFile;
+    using namespace Catch::clara;
+    auto cli = session.cli() | Opt(jsonFile, "file")["--json"]("write the measurements to this file instead of the standard output") |
+               Opt(BenchmarkReport::maxClips, "clips")["--max-clips"]("skip the timelines with more clips than this");
+    session.cli(cli);
+    int result = session.applyCommandLine(argc, argv);
+    if (result == 0) {
+        result = session.run();
+        if (jsonFile.empty()) {
+            std::cout << BenchmarkReport::toJson().constData();
+        } else if (!BenchmarkReport::write(QString::fromStdString(jsonFile))) {
+            std::cerr << "Cannot write " << jsonFile << std::endl;
+            result = 1;
+        }
+    }
+    ClipController::mediaUnavailable.reset();
+
+    Core::m_self.reset();
+    Mlt::Factory::close();
+    return (result < 0xff ? result : 0xff);
+}
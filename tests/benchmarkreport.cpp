@@ -0,0 +1,83 @@
+#include "benchmarkreport.hpp"
+
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QThread>
+#include <chrono>
+#include <iostream>
+
+int BenchmarkReport::maxClips = 50000;
+QJsonArray BenchmarkReport::results;
+
+void BenchmarkReport::add(const QString &suite, const QString &operation, int clips, int tracks, double milliseconds, int count)
+{
+    QJsonObject result;
+    result.insert(QStringLiteral("suite"), suite);
+    result.insert(QStringLiteral("operation"), operation);
+    result.insert(QStringLiteral("clips"), clips);
+    result.insert(QStringLiteral("tracks"), tracks);
+    result.insert(QStringLiteral("count"), count);
+    result.insert(QStringLiteral("total_ms"), milliseconds);
+    result.insert(QStringLiteral("per_operation_ms"), count > 0 ? milliseconds / count : milliseconds);
+    results.append(result);
+    std::cout << suite.toStdString() << " / " << operation.toStdString() << " (" << clips << " clips, " << tracks << " tracks): " << milliseconds << " ms"
+              << std::endl;
+}
+
+void BenchmarkReport::addItems(const QString &suite, const QString &operation, int items, double milliseconds, int count)
+{
+    QJsonObject result;
+    result.insert(QStringLiteral("suite"), suite);
+    result.insert(QStringLiteral("operation"), operation);
+    result.insert(QStringLiteral("items"), items);
+    result.insert(QStringLiteral("count"), count);
+    result.insert(QStringLiteral("total_ms"), milliseconds);
+    result.insert(QStringLiteral("per_operation_ms"), count > 0 ? milliseconds / count : milliseconds);
+    results.append(result);
+    std::cout << suite.toStdString() << " / " << operation.toStdString() << " (" << items << " items): " << milliseconds << " ms" << std::endl;
+}
+
+double BenchmarkReport::time(const std::function<void()> &work)
+{
+    auto start = std::chrono::steady_clock::now();
+    work();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void BenchmarkReport::measure(const QString &suite, const QString &operation, int clips, int tracks, int count, const std::function<void()> &work)
+{
+    add(suite, operation, clips, tracks, time(work), count);
+}
+
+void BenchmarkReport::measureItems(const QString &suite, const QString &operation, int items, int count, const std::function<void()> &work)
+{
+    addItems(suite, operation, items, time(work), count);
+}
+
+QByteArray BenchmarkReport::toJson()
+{
+    QJsonObject machine;
+    machine.insert(QStringLiteral("cpu"), QSysInfo::currentCpuArchitecture());
+    machine.insert(QStringLiteral("threads"), QThread::idealThreadCount());
+    machine.insert(QStringLiteral("os"), QSysInfo::prettyProductName());
+    machine.insert(QStringLiteral("qt"), QString::fromLatin1(qVersion()));
+    QJsonObject root;
+    root.insert(QStringLiteral("date"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert(QStringLiteral("machine"), machine);
+    root.insert(QStringLiteral("results"), results);
+    return QJsonDocument(root).toJson();
+}
+
+bool BenchmarkReport::write(const QString &path)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(toJson());
+    return file.commit();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <QByteArray>
+#include <QJsonArray>
+#include <QString>
+#include <functional>
+
+/** @brief Collects the measurements of the benchmark suite, written as JSON at the end of the run
+    so that scaling curves can be compared between builds.
+ */
+class BenchmarkReport
+{
+public:
+    /** @brief Records a measurement
+        @param suite the benchmark the measurement belongs to
+        @param operation the timed operation
+        @param clips the number of clips in the timeline
+        @param tracks the number of tracks in the timeline
+        @param milliseconds the total duration
+        @param count the number of operations done in this duration
+    */
+    static void add(const QString &suite, const QString &operation, int clips, int tracks, double milliseconds, int count = 1);
+
+    /** @brief Records a measurement on a model that is not a timeline
+        @param items the number of items in the model
+    */
+    static void addItems(const QString &suite, const QString &operation, int items, double milliseconds, int count = 1);
+
+    /** @brief Returns the duration of work in milliseconds */
+    static double time(const std::function<void()> &work);
+
+    /** @brief Times work and records it as a measurement on a timeline, see add() */
+    static void measure(const QString &suite, const QString &operation, int clips, int tracks, int count, const std::function<void()> &work);
+
+    /** @brief Times work and records it as a measurement on a model that is not a timeline, see addItems() */
+    static void measureItems(const QString &suite, const QString &operation, int items, int count, const std::function<void()> &work);
+
+    /** @brief Returns all measurements, with a description of the machine */
+    static QByteArray toJson();
+
+    /** @brief Writes the measurements to a file, returns false if it cannot be written */
+    static bool write(const QString &path);
+
+    /** @brief Timelines with more clips than this are skipped */
+    static int maxClips;
+
+private:
+    static QJsonArray results;
+};
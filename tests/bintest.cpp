@@ -0,0 +1,71 @@
+#include "doc/kdenlivedoc.h"
+#include "test_utils.hpp"
+
+#include "bin/projectsortproxymodel.h"
+#include <QDomDocument>
+
+using namespace fakeit;
+Mlt::Profile profile_bin;
+
+TEST_CASE("Bin filters follow the loaded clips", "[Bin]")
+{
+    Logger::clear();
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+
+    // Loading a clip reads the proxy settings of the document
+    Mock<KdenliveDoc> docMock;
+    When(Method(docMock, getDocumentProperty)).AlwaysDo([](const QString &name, const QString &defaultValue) {
+        Q_UNUSED(name) Q_UNUSED(defaultValue)
+        return QString();
+    });
+    KdenliveDoc &mockedDoc = docMock.get();
+
+    Mock<ProjectManager> pmMock;
+    When(Method(pmMock, undoStack)).AlwaysReturn(undoStack);
+    When(Method(pmMock, current)).AlwaysReturn(&mockedDoc);
+    ProjectManager &mocked = pmMock.get();
+    pCore->m_projectManager = &mocked;
+
+    // A clip waiting for its producer, as created when opening a project
+    QDomDocument doc;
+    QDomElement description = doc.createElement(QStringLiteral("producer"));
+    QString binId = QString::number(binModel->getFreeClipId());
+    description.setAttribute(QStringLiteral("id"), binId);
+    auto binClip = ProjectClip::construct(binId, description, QIcon(), binModel);
+    Fun undo = []() { return true; };
+    Fun redo = []() { return true; };
+    REQUIRE(binModel->addItem(binClip, binModel->getRootFolder()->clipId(), undo, redo));
+
+    ProjectSortProxyModel proxy;
+    proxy.setSourceModel(binModel.get());
+    auto isShown = [&]() { return proxy.mapFromSource(binModel->getIndexFromItem(binClip)).isValid(); };
+
+    proxy.slotSetFilters({QStringLiteral("#ff0000")}, 0, ClipType::Color, false);
+    REQUIRE_FALSE(isShown());
+
+    // The producer brings the type and the tags of the clip
+    std::shared_ptr<Mlt::Producer> producer = std::make_shared<Mlt::Producer>(profile_bin, "color", "red");
+    producer->set("length", 20);
+    producer->set("out", 19);
+    producer->set("kdenlive:tags", "#ff0000");
+    REQUIRE(binClip->setProducer(producer, false));
+
+    ProjectItemModel::SearchEntry entry;
+    REQUIRE(binModel->getSearchEntry(binClip->getId(), entry));
+    REQUIRE(entry.type == ClipType::Color);
+    REQUIRE(entry.tags == QStringLiteral("#ff0000"));
+
+    proxy.slotSetFilters({QStringLiteral("#ff0000")}, 0, ClipType::Color, false);
+    REQUIRE(isShown());
+    proxy.slotSetFilters({}, 0, ClipType::Color, false);
+    REQUIRE(isShown());
+    proxy.slotSetFilters({QStringLiteral("#00ff00")}, 0, ClipType::Color, false);
+    REQUIRE_FALSE(isShown());
+    proxy.slotSetFilters({QStringLiteral("#ff0000")}, 0, ClipType::Image, false);
+    REQUIRE_FALSE(isShown());
+
+    binModel->clean();
+    pCore->m_projectManager = nullptr;
+}
@@ -0,0 +1,70 @@
+#include "benchmarkreport.hpp"
+#include "test_utils.hpp"
+
+using namespace fakeit;
+Mlt::Profile profile_dragbenchmark;
+
+TEST_CASE("Drag latency depending on group size", "[Drag][Benchmark]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    std::shared_ptr<MarkerListModel> guideModel = std::make_shared<MarkerListModel>(undoStack);
+
+    Mock<ProjectManager> pmMock;
+    When(Method(pmMock, undoStack)).AlwaysReturn(undoStack);
+
+    ProjectManager &mocked = pmMock.get();
+    pCore->m_projectManager = &mocked;
+
+    QString binId = createProducer(profile_dragbenchmark, "red", binModel);
+    int length = binModel->getClipByBinID(binId)->frameDuration();
+
+    for (int groupSize : {1, 10, 50, 200}) {
+        undoStack->clear();
+        std::shared_ptr<TimelineItemModel> timeline = TimelineItemModel::construct(&profile_dragbenchmark, guideModel, undoStack);
+
+        // The dragged group on the first two tracks, followed by a wall of clips that blocks half of the drag positions
+        int tid1 = TrackModel::construct(timeline);
+        int tid2 = TrackModel::construct(timeline);
+        std::unordered_set<int> group;
+        for (int i = 0; i < groupSize; ++i) {
+            int cid = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+            REQUIRE(timeline->requestClipMove(cid, i % 2 == 0 ? tid1 : tid2, (i / 2) * length));
+            group.insert(cid);
+        }
+        int dragged = *group.begin();
+        if (groupSize > 1) {
+            REQUIRE(timeline->requestClipsGroup(group) > 0);
+        }
+        int groupEnd = ((groupSize + 1) / 2) * length;
+        const int wallSize = 20;
+        for (int i = 0; i < wallSize; ++i) {
+            int cid = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+            REQUIRE(timeline->requestClipMove(cid, i % 2 == 0 ? tid1 : tid2, groupEnd + 2 * length * (i + 1)));
+        }
+        const int clips = groupSize + wallSize;
+
+        // Mouse moves back and forth, only the preview moves
+        const int steps = 200;
+        int startPos = timeline->getClipPosition(dragged);
+        int startTrack = timeline->getClipTrackId(dragged);
+        int dropPos = startPos;
+        BenchmarkReport::measure(QStringLiteral("drag"), QStringLiteral("drag step"), clips, 2, steps, [&]() {
+            for (int i = 0; i < steps; ++i) {
+                dropPos = timeline->suggestClipMove(dragged, startTrack, startPos + (i % 40) * length / 4, -1, -1).at(0).toInt();
+            }
+        });
+        REQUIRE(timeline->getClipPosition(dragged) == startPos);
+
+        // The drop moves the clips in the playlists
+        bool ok = false;
+        BenchmarkReport::measure(QStringLiteral("drag"), QStringLiteral("drop"), clips, 2, 1,
+                                 [&]() { ok = timeline->requestClipDragEnd(dragged, startTrack, startPos, dropPos); });
+        REQUIRE(ok);
+        REQUIRE(timeline->getClipPosition(dragged) == dropPos);
+        REQUIRE(timeline->checkConsistency());
+    }
+    binModel->clean();
+    pCore->m_projectManager = nullptr;
+}
@@ -0,0 +1,159 @@
+#include "test_utils.hpp"
+
+using namespace fakeit;
+Mlt::Profile profile_drag;
+
+TEST_CASE("Move feasibility without touching the playlists", "[Drag]")
+{
+    Logger::clear();
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    std::shared_ptr<MarkerListModel> guideModel = std::make_shared<MarkerListModel>(undoStack);
+
+    Mock<ProjectManager> pmMock;
+    When(Method(pmMock, undoStack)).AlwaysReturn(undoStack);
+
+    ProjectManager &mocked = pmMock.get();
+    pCore->m_projectManager = &mocked;
+
+    TimelineItemModel tim(&profile_drag, undoStack);
+    Mock<TimelineItemModel> timMock(tim);
+    auto timeline = std::shared_ptr<TimelineItemModel>(&timMock.get(), [](...) {});
+    TimelineItemModel::finishConstruct(timeline, guideModel);
+
+    RESET(timMock)
+
+    QString binId = createProducer(profile_drag, "red", binModel);
+    int length = binModel->getClipByBinID(binId)->frameDuration();
+
+    int tid1 = TrackModel::construct(timeline);
+    int tid2 = TrackModel::construct(timeline);
+    int tid3 = TrackModel::construct(timeline, -1, -1, QString(), true);
+    int cid1 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int cid2 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int cid3 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int cid4 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+
+    REQUIRE(timeline->requestClipMove(cid1, tid1, 0));
+    REQUIRE(timeline->requestClipMove(cid2, tid1, length + 10));
+    REQUIRE(timeline->requestClipMove(cid3, tid2, 5));
+    REQUIRE(timeline->requestClipMove(cid4, tid2, 3 * length));
+
+    // Without mixes, the check must give the same answer as an actual move
+    auto checkAgainstMove = [&](int cid, int tid, int from, int to) {
+        for (int pos = from; pos < to; ++pos) {
+            bool feasible = timeline->isClipMoveFeasible(cid, tid, pos);
+            bool possible = timeline->requestClipMoveAttempt(cid, tid, pos);
+            INFO("Moving " << cid << " to track " << tid << " at " << pos);
+            REQUIRE(feasible == possible);
+        }
+        REQUIRE(timeline->checkConsistency());
+    };
+
+    SECTION("Single clip")
+    {
+        checkAgainstMove(cid1, tid1, -5, 5 * length);
+        checkAgainstMove(cid1, tid2, -5, 5 * length);
+        REQUIRE_FALSE(timeline->isClipMoveFeasible(cid1, tid3, 10 * length));
+    }
+
+    SECTION("Group on the same tracks")
+    {
+        REQUIRE(timeline->requestClipsGroup({cid1, cid3}) > 0);
+        checkAgainstMove(cid1, tid1, -10, 5 * length);
+        checkAgainstMove(cid3, tid2, -10, 5 * length);
+        // The clip of the second track would go on the audio track
+        REQUIRE_FALSE(timeline->isClipMoveFeasible(cid1, tid2, 0));
+    }
+
+    SECTION("Drag preview")
+    {
+        int undos = undoStack->count();
+        // Only the preview moves during the drag
+        QVariantList moveData = timeline->suggestClipMove(cid1, tid2, 2 * length, -1, -1);
+        REQUIRE(moveData.at(0).toInt() == 2 * length);
+        REQUIRE(moveData.at(1).toInt() == tid2);
+        REQUIRE(timeline->getClipPosition(cid1) == 0);
+        REQUIRE(timeline->getClipTrackId(cid1) == tid1);
+        REQUIRE(timeline->m_allClips[cid1]->getFakeTrackId() == tid2);
+        REQUIRE(timeline->m_allClips[cid1]->getFakePosition() == 2 * length);
+        // A position blocked by cid4 leaves the preview at the closest free place
+        moveData = timeline->suggestClipMove(cid1, tid2, 3 * length - 5, -1, -1);
+        REQUIRE(moveData.at(0).toInt() == 2 * length);
+        REQUIRE(timeline->getClipPosition(cid1) == 0);
+        REQUIRE(undoStack->count() == undos);
+
+        // The drop moves the clip in one undoable operation
+        REQUIRE(timeline->requestClipDragEnd(cid1, tid1, 0, 2 * length));
+        REQUIRE(timeline->getClipPosition(cid1) == 2 * length);
+        REQUIRE(timeline->getClipTrackId(cid1) == tid2);
+        REQUIRE(timeline->m_allClips[cid1]->getFakeTrackId() == -1);
+        REQUIRE(undoStack->count() == undos + 1);
+        REQUIRE(timeline->checkConsistency());
+        undoStack->undo();
+        REQUIRE(timeline->getClipPosition(cid1) == 0);
+        REQUIRE(timeline->getClipTrackId(cid1) == tid1);
+        REQUIRE(timeline->checkConsistency());
+        undoStack->redo();
+        REQUIRE(timeline->getClipPosition(cid1) == 2 * length);
+        REQUIRE(timeline->checkConsistency());
+    }
+
+    SECTION("Snap during a drag preview")
+    {
+        // First step without snapping, the preview ends away from the model position of the clip
+        QVariantList moveData = timeline->suggestClipMove(cid1, tid1, 3 * length, -1, -1);
+        REQUIRE(moveData.at(0).toInt() == 3 * length);
+        REQUIRE(timeline->getClipPosition(cid1) == 0);
+        // The clip snaps to the start of cid4 from the preview position
+        moveData = timeline->suggestClipMove(cid1, tid1, 3 * length - 3, -1, 5);
+        REQUIRE(moveData.at(0).toInt() == 3 * length);
+        // Back near its model position, the clip does not snap to itself but to cid3
+        moveData = timeline->suggestClipMove(cid1, tid1, 2, -1, 5);
+        REQUIRE(moveData.at(0).toInt() == 5);
+        REQUIRE(timeline->getClipPosition(cid1) == 0);
+
+        REQUIRE(timeline->requestClipDragEnd(cid1, tid1, 0, 5));
+        REQUIRE(timeline->getClipPosition(cid1) == 5);
+        REQUIRE(timeline->getClipTrackId(cid1) == tid1);
+        REQUIRE(timeline->checkConsistency());
+        undoStack->undo();
+        REQUIRE(timeline->getClipPosition(cid1) == 0);
+        REQUIRE(timeline->checkConsistency());
+    }
+
+    SECTION("Drag preview of a group")
+    {
+        REQUIRE(timeline->requestClipsGroup({cid1, cid3}) > 0);
+        int undos = undoStack->count();
+        QVariantList moveData = timeline->suggestClipMove(cid1, tid1, 6 * length, -1, -1);
+        REQUIRE(moveData.at(0).toInt() == 6 * length);
+        REQUIRE(timeline->getClipPosition(cid1) == 0);
+        REQUIRE(timeline->getClipPosition(cid3) == 5);
+        REQUIRE(timeline->m_allClips[cid3]->getFakePosition() == 6 * length + 5);
+        REQUIRE(timeline->m_allClips[cid3]->getFakeTrackId() == tid2);
+
+        REQUIRE(timeline->requestClipDragEnd(cid1, tid1, 0, 6 * length));
+        REQUIRE(timeline->getClipPosition(cid1) == 6 * length);
+        REQUIRE(timeline->getClipPosition(cid3) == 6 * length + 5);
+        REQUIRE(timeline->m_allClips[cid3]->getFakeTrackId() == -1);
+        REQUIRE(undoStack->count() == undos + 1);
+        REQUIRE(timeline->checkConsistency());
+        undoStack->undo();
+        REQUIRE(timeline->getClipPosition(cid1) == 0);
+        REQUIRE(timeline->getClipPosition(cid3) == 5);
+        REQUIRE(timeline->checkConsistency());
+    }
+
+    SECTION("Locked track")
+    {
+        timeline->setTrackLockedState(tid2, true);
+        REQUIRE_FALSE(timeline->isClipMoveFeasible(cid1, tid2, 10 * length));
+        timeline->setTrackLockedState(tid2, false);
+        REQUIRE(timeline->isClipMoveFeasible(cid1, tid2, 10 * length));
+    }
+
+    binModel->clean();
+    pCore->m_projectManager = nullptr;
+}
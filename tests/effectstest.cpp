@@ -2,6 +2,7 @@
 #include "doc/docundostack.hpp"
 #include "test_utils.hpp"
 
+#include <QDomDocument>
 #include <QString>
 #include <cmath>
 #include <iostream>
@@ -112,5 +113,92 @@ TEST_CASE("Effects stack", "[Effects]")
         REQUIRE(clipModel->rowCount() == 0);
         REQUIRE(splitModel->rowCount() == 1);
     }
+    SECTION("Add effects to several clips at once")
+    {
+        int cid2;
+        REQUIRE(timeline->requestClipInsertion(binId, tid1, 300, cid2));
+        std::vector<std::shared_ptr<EffectStackModel>> stacks = {timeline->getClipPtr(cid1)->m_effectStack, timeline->getClipPtr(cid2)->m_effectStack};
+        QDomDocument doc;
+        stacks.front()->appendEffect(anEffect);
+        stacks.front()->appendEffect(QStringLiteral("fade_from_black"));
+        std::vector<EffectStackModel::EffectDescription> descriptions = EffectStackModel::parseEffects(stacks.front()->toXml(doc));
+        REQUIRE(descriptions.size() == 2);
+        Fun undo = []() { return true; };
+        Fun redo = []() { return true; };
+        stacks.front()->removeAllEffects(undo, redo);
+        REQUIRE(stacks.front()->rowCount() == 0);
+
+        undo = []() { return true; };
+        redo = []() { return true; };
+        REQUIRE(EffectStackModel::appendEffects(stacks, descriptions, undo, redo) == 2);
+        for (const auto &stack : stacks) {
+            REQUIRE(stack->checkConsistency());
+            REQUIRE(stack->rowCount() == 2);
+        }
+        REQUIRE(stacks.back()->m_fadeIns.size() == 1);
+
+        REQUIRE(undo());
+        for (const auto &stack : stacks) {
+            REQUIRE(stack->checkConsistency());
+            REQUIRE(stack->rowCount() == 0);
+            REQUIRE(stack->m_fadeIns.empty());
+        }
+        REQUIRE(redo());
+        for (const auto &stack : stacks) {
+            REQUIRE(stack->rowCount() == 2);
+        }
+
+        // A unique effect is not added twice, whether the stack already has it or the batch contains it twice
+        undo = []() { return true; };
+        redo = []() { return true; };
+        REQUIRE(EffectStackModel::appendEffects(stacks, {EffectStackModel::describeEffect(QStringLiteral("fade_from_black"))}, undo, redo) == 0);
+        for (const auto &stack : stacks) {
+            REQUIRE(stack->rowCount() == 2);
+        }
+        int cid3;
+        REQUIRE(timeline->requestClipInsertion(binId, tid1, 500, cid3));
+        auto stack3 = timeline->getClipPtr(cid3)->m_effectStack;
+        std::vector<EffectStackModel::EffectDescription> twice = {EffectStackModel::describeEffect(QStringLiteral("fade_from_black")),
+                                                                   EffectStackModel::describeEffect(QStringLiteral("fade_from_black"))};
+        REQUIRE(EffectStackModel::appendEffects({stack3}, twice, undo, redo) == 0);
+        REQUIRE(stack3->rowCount() == 0);
+    }
+    SECTION("Normalization gain")
+    {
+        auto levelOf = [&model]() {
+            auto effect = std::static_pointer_cast<EffectItemModel>(model->getEffectStackRow(0));
+            return QString(effect->filter().get("level"));
+        };
+        Fun undo = []() { return true; };
+        Fun redo = []() { return true; };
+        REQUIRE(model->setNormalizationGain(7., undo, redo));
+        REQUIRE(model->checkConsistency());
+        REQUIRE(model->rowCount() == 1);
+        REQUIRE(levelOf() == QStringLiteral("7.00"));
+
+        // A second normalization adjusts the existing effect
+        Fun undo2 = []() { return true; };
+        Fun redo2 = []() { return true; };
+        REQUIRE(model->setNormalizationGain(-3.5, undo2, redo2));
+        REQUIRE(model->rowCount() == 1);
+        REQUIRE(levelOf() == QStringLiteral("-3.50"));
+
+        REQUIRE(undo2());
+        REQUIRE(model->rowCount() == 1);
+        REQUIRE(levelOf() == QStringLiteral("7.00"));
+        REQUIRE(redo2());
+        REQUIRE(levelOf() == QStringLiteral("-3.50"));
+
+        // Undoing both removes the effect
+        REQUIRE(undo2());
+        REQUIRE(undo());
+        REQUIRE(model->checkConsistency());
+        REQUIRE(model->rowCount() == 0);
+        REQUIRE(redo());
+        REQUIRE(model->rowCount() == 1);
+        REQUIRE(levelOf() == QStringLiteral("7.00"));
+        REQUIRE(undo());
+        REQUIRE(model->rowCount() == 0);
+    }
     Logger::print_trace();
 }
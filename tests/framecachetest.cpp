@@ -0,0 +1,78 @@
+#include "catch.hpp"
+
+#include "monitor/monitorframecache.hpp"
+#include <mlt++/MltFrame.h>
+
+namespace {
+Mlt::Frame createFrame(int position, int width, int height)
+{
+    Mlt::Frame frame(mlt_frame_init(nullptr));
+    int size = mlt_image_format_size(mlt_image_yuv420p, width, height, nullptr);
+    frame.set("image", mlt_pool_alloc(size), size, mlt_pool_release);
+    frame.set("format", mlt_image_yuv420p);
+    frame.set("width", width);
+    frame.set("height", height);
+    mlt_frame_set_position(frame.get_frame(), position);
+    return frame;
+}
+} // namespace
+
+TEST_CASE("Monitor frame cache", "[FrameCache]")
+{
+    const QSize size(64, 36);
+    const qint64 frameCost = mlt_image_format_size(mlt_image_yuv420p, size.width(), size.height(), nullptr);
+    MonitorFrameCache cache;
+
+    SECTION("Disabled cache")
+    {
+        REQUIRE_FALSE(cache.insert(0, size, createFrame(0, size.width(), size.height()), cache.revision()));
+        REQUIRE(cache.get(0, size) == nullptr);
+    }
+
+    cache.setBudget(3 * frameCost);
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(cache.insert(i, size, createFrame(i, size.width(), size.height()), cache.revision()));
+    }
+    REQUIRE(cache.count() == 3);
+    REQUIRE(cache.cost() == 3 * frameCost);
+
+    SECTION("Least recently used frames are dropped")
+    {
+        REQUIRE(cache.get(0, size) != nullptr);
+        REQUIRE(cache.insert(3, size, createFrame(3, size.width(), size.height()), cache.revision()));
+        REQUIRE(cache.count() == 3);
+        REQUIRE(cache.get(1, size) == nullptr);
+        REQUIRE(cache.get(0, size) != nullptr);
+        REQUIRE(cache.get(0, size)->get_position() == 0);
+        // Replacing a frame doesn't evict another one
+        REQUIRE(cache.insert(3, size, createFrame(3, size.width(), size.height()), cache.revision()));
+        REQUIRE(cache.count() == 3);
+        cache.setBudget(frameCost);
+        REQUIRE(cache.count() == 1);
+        REQUIRE(cache.get(3, size) != nullptr);
+    }
+
+    SECTION("Frames are rendered again at another preview size")
+    {
+        REQUIRE(cache.get(1, QSize(32, 18)) == nullptr);
+        REQUIRE(cache.get(1, size) != nullptr);
+    }
+
+    SECTION("Invalidation")
+    {
+        quint64 revision = cache.revision();
+        cache.invalidate(1, 1);
+        REQUIRE(cache.count() == 2);
+        REQUIRE(cache.get(1, size) == nullptr);
+        REQUIRE(cache.get(2, size) != nullptr);
+        // A frame requested before the change is not cached
+        REQUIRE_FALSE(cache.insert(1, size, createFrame(1, size.width(), size.height()), revision));
+        REQUIRE(cache.insert(1, size, createFrame(1, size.width(), size.height()), cache.revision()));
+        cache.invalidate(1, -1);
+        REQUIRE(cache.count() == 1);
+        REQUIRE(cache.get(0, size) != nullptr);
+        cache.clear();
+        REQUIRE(cache.count() == 0);
+        REQUIRE(cache.cost() == 0);
+    }
+}
@@ -0,0 +1,69 @@
+#include "benchmarkreport.hpp"
+#include "test_utils.hpp"
+
+using namespace fakeit;
+
+TEST_CASE("Keyframe model scaling", "[KeyframeModel][Benchmark]")
+{
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    Mock<ProjectManager> pmMock;
+    When(Method(pmMock, undoStack)).AlwaysReturn(undoStack);
+
+    ProjectManager &mocked = pmMock.get();
+    pCore->m_projectManager = &mocked;
+    const double fps = pCore->getCurrentFps();
+    GenTime::setFps(fps);
+
+    Mlt::Profile pr;
+    std::shared_ptr<Mlt::Producer> producer = std::make_shared<Mlt::Producer>(pr, "color", "red");
+    auto effectstack = EffectStackModel::construct(producer, {ObjectType::TimelineClip, 0}, undoStack);
+    effectstack->appendEffect(QStringLiteral("audiobalance"));
+    REQUIRE(effectstack->rowCount() == 1);
+    auto effect = std::dynamic_pointer_cast<EffectItemModel>(effectstack->getEffectStackRow(0));
+    effect->prepareKeyframes();
+    QModelIndex index = effect->index(0, 0);
+
+    for (int count : {1000, 10000, 100000}) {
+        auto model = std::make_shared<KeyframeModel>(effect, index, undoStack);
+        // Keyframes every other frame, after the initial one
+        Fun undo = []() { return true; };
+        Fun redo = []() { return true; };
+        bool ok = true;
+        BenchmarkReport::measureItems(QStringLiteral("keyframes"), QStringLiteral("insertion"), count, count, [&]() {
+            for (int i = 1; i <= count; ++i) {
+                ok = ok && model->addKeyframe(GenTime(2 * i, fps), KeyframeType::Linear, i % 100, false, undo, redo);
+            }
+        });
+        REQUIRE(ok);
+        REQUIRE(model->rowCount() == count + 1);
+
+        int found = 0;
+        BenchmarkReport::measureItems(QStringLiteral("keyframes"), QStringLiteral("lookup"), count, 2 * count, [&]() {
+            for (int frame = 0; frame < 2 * count; ++frame) {
+                found += model->hasKeyframe(frame) ? 1 : 0;
+            }
+        });
+        REQUIRE(found == count);
+
+        BenchmarkReport::measureItems(QStringLiteral("keyframes"), QStringLiteral("neighbours"), count, 2 * count, [&]() {
+            for (int frame = 0; frame < 2 * count; ++frame) {
+                GenTime pos(frame, fps);
+                model->getNextKeyframe(pos, &ok);
+                model->getPrevKeyframe(pos, &ok);
+            }
+        });
+
+        QString anim;
+        BenchmarkReport::measureItems(QStringLiteral("keyframes"), QStringLiteral("serialization"), count, 1, [&]() { anim = model->getAnimProperty(); });
+        REQUIRE(!anim.isEmpty());
+
+        BenchmarkReport::measureItems(QStringLiteral("keyframes"), QStringLiteral("removal"), count, count, [&]() {
+            for (int i = count; i > 0; --i) {
+                ok = ok && model->removeKeyframe(GenTime(2 * i, fps), undo, redo, false);
+            }
+        });
+        REQUIRE(ok);
+        REQUIRE(model->rowCount() == 1);
+    }
+    pCore->m_projectManager = nullptr;
+}
@@ -0,0 +1,65 @@
+#include "catch.hpp"
+
+#include "jobs/loudnessjob.hpp"
+#include <cmath>
+
+TEST_CASE("Loudness measures", "[Loudness]")
+{
+    SECTION("Parse ebur128 summaries")
+    {
+        const QString log = QStringLiteral("Input #0, matroska,webm, from 'clip.mkv':\n"
+                                           "[Parsed_ebur128_1 @ 0x55d0c1a3b2c0] Summary:\n"
+                                           "\n"
+                                           "  Integrated loudness:\n"
+                                           "    I:         -70.0 LUFS\n"
+                                           "    Threshold:   0.0 LUFS\n"
+                                           "\n"
+                                           "  Loudness range:\n"
+                                           "    LRA:         0.0 LU\n"
+                                           "    Threshold:   0.0 LUFS\n"
+                                           "    LRA low:     0.0 LUFS\n"
+                                           "    LRA high:    0.0 LUFS\n"
+                                           "\n"
+                                           "  True peak:\n"
+                                           "    Peak:       -inf dBFS\n"
+                                           "[Parsed_ebur128_0 @ 0x55d0c1a3a100] Summary:\n"
+                                           "\n"
+                                           "  Integrated loudness:\n"
+                                           "    I:         -16.5 LUFS\n"
+                                           "    Threshold: -26.8 LUFS\n"
+                                           "\n"
+                                           "  Loudness range:\n"
+                                           "    LRA:         5.9 LU\n"
+                                           "    Threshold: -36.8 LUFS\n"
+                                           "    LRA low:   -21.2 LUFS\n"
+                                           "    LRA high:  -15.3 LUFS\n"
+                                           "\n"
+                                           "  True peak:\n"
+                                           "    Peak:       -0.2 dBFS\n"
+                                           "[Parsed_ebur128_2 @ 0x55d0c1a3c200] Summary:\n"
+                                           "\n"
+                                           "  Integrated loudness:\n"
+                                           "    I:         -20.0 LUFS\n");
+        QMap<int, LoudnessJob::Measure> measures = LoudnessJob::parseSummaries(log);
+        // The truncated third summary is ignored
+        REQUIRE(measures.count() == 2);
+        REQUIRE(measures.value(0).integrated == Approx(-16.5));
+        REQUIRE(measures.value(0).range == Approx(5.9));
+        REQUIRE(measures.value(0).truePeak == Approx(-0.2));
+        REQUIRE(measures.value(1).integrated == Approx(-70.));
+        REQUIRE(std::isinf(measures.value(1).truePeak));
+        REQUIRE(LoudnessJob::parseSummaries(QString()).isEmpty());
+    }
+
+    SECTION("Normalization gain")
+    {
+        // Quiet clip, brought to the target
+        REQUIRE(LoudnessJob::normalizationGain({-30., 5., -12.}, -23., -1.) == Approx(7.));
+        // Loud clip, attenuated
+        REQUIRE(LoudnessJob::normalizationGain({-16.5, 5.9, -0.2}, -23., -1.) == Approx(-6.5));
+        // The gain is limited by the true peak
+        REQUIRE(LoudnessJob::normalizationGain({-30., 15., -3.}, -23., -1.) == Approx(2.));
+        // Silence is left alone
+        REQUIRE(LoudnessJob::normalizationGain({-70., 0., -INFINITY}, -23., -1.) == Approx(0.));
+    }
+}
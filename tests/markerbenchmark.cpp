@@ -0,0 +1,66 @@
+#include "benchmarkreport.hpp"
+#include "test_utils.hpp"
+
+#include "timeline2/model/snapmodel.hpp"
+
+using namespace fakeit;
+
+TEST_CASE("Marker model scaling", "[MarkerListModel][Benchmark]")
+{
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    const double fps = pCore->getCurrentFps();
+    GenTime::setFps(fps);
+
+    for (int count : {1000, 10000, 50000}) {
+        std::shared_ptr<MarkerListModel> model = std::make_shared<MarkerListModel>(undoStack, nullptr);
+        std::shared_ptr<SnapModel> snaps = std::make_shared<SnapModel>();
+        model->registerSnapModel(snaps);
+
+        // The undo lambdas of guides fetch their model from the project
+        Mock<ProjectManager> pmMock;
+        When(Method(pmMock, getGuideModel)).AlwaysReturn(model);
+        When(Method(pmMock, undoStack)).AlwaysReturn(undoStack);
+        ProjectManager &mocked = pmMock.get();
+        pCore->m_projectManager = &mocked;
+
+        // One marker every 10 frames
+        const int spacing = 10;
+        Fun undo = []() { return true; };
+        Fun redo = []() { return true; };
+        bool ok = true;
+        BenchmarkReport::measureItems(QStringLiteral("markers"), QStringLiteral("insertion"), count, count, [&]() {
+            for (int i = 0; i < count; ++i) {
+                ok = ok && model->addMarker(GenTime(i * spacing, fps), QStringLiteral("Marker"), i % 5, undo, redo);
+            }
+        });
+        REQUIRE(ok);
+        REQUIRE(model->rowCount() == count);
+
+        int found = 0;
+        BenchmarkReport::measureItems(QStringLiteral("markers"), QStringLiteral("lookup"), count, count * spacing, [&]() {
+            for (int frame = 0; frame < count * spacing; ++frame) {
+                found += model->hasMarker(frame) ? 1 : 0;
+            }
+        });
+        REQUIRE(found == count);
+
+        BenchmarkReport::measureItems(QStringLiteral("markers"), QStringLiteral("get marker"), count, count, [&]() {
+            for (int i = 0; i < count; ++i) {
+                model->getMarker(GenTime(i * spacing, fps), &ok);
+            }
+        });
+        REQUIRE(ok);
+
+        QString json;
+        BenchmarkReport::measureItems(QStringLiteral("markers"), QStringLiteral("export"), count, 1, [&]() { json = model->toJson(); });
+        BenchmarkReport::measureItems(QStringLiteral("markers"), QStringLiteral("removal"), count, count, [&]() { ok = model->removeAllMarkers(); });
+        REQUIRE(ok);
+        REQUIRE(model->rowCount() == 0);
+        BenchmarkReport::measureItems(QStringLiteral("markers"), QStringLiteral("import"), count, count, [&]() {
+            ok = model->importFromJson(json, false, undo, redo);
+        });
+        REQUIRE(ok);
+        REQUIRE(model->rowCount() == count);
+        pCore->m_projectManager = nullptr;
+    }
+}
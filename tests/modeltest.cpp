@@ -166,6 +166,61 @@ TEST_CASE("Basic creation/deletion of a clip", "[ClipModel]")
     Logger::print_trace();
 }
 
+TEST_CASE("Loading clips on a track", "[ClipModel]")
+{
+    auto binModel = pCore->projectItemModel();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    std::shared_ptr<MarkerListModel> guideModel = std::make_shared<MarkerListModel>(undoStack);
+    std::shared_ptr<TimelineItemModel> timeline = TimelineItemModel::construct(&profile_model, guideModel, undoStack);
+
+    Mock<ProjectManager> pmMock;
+    When(Method(pmMock, undoStack)).AlwaysReturn(undoStack);
+
+    ProjectManager &mocked = pmMock.get();
+    pCore->m_projectManager = &mocked;
+
+    QString binId = createProducer(profile_model, "red", binModel);
+    int tid1 = TrackModel::construct(timeline);
+    int cid1 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int cid2 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int cid3 = ClipModel::construct(timeline, binId, -1, PlaylistState::VideoOnly);
+    int length = timeline->getClipPlaytime(cid1);
+    Fun undo = []() { return true; };
+    Fun redo = []() { return true; };
+
+    SECTION("Overlapping clips are rejected")
+    {
+        REQUIRE_FALSE(timeline->requestClipsLoad(tid1, {{cid1, 0}, {cid2, length - 1}}, 0, undo, redo));
+        REQUIRE(timeline->getClipTrackId(cid1) == -1);
+        REQUIRE(timeline->getClipTrackId(cid2) == -1);
+        REQUIRE(timeline->getTrackClipsCount(tid1) == 0);
+    }
+
+    SECTION("Clips are inserted at their position")
+    {
+        auto state = [&]() {
+            REQUIRE(timeline->checkConsistency());
+            REQUIRE(timeline->getTrackClipsCount(tid1) == 3);
+            REQUIRE(timeline->getClipPosition(cid1) == 0);
+            REQUIRE(timeline->getClipPosition(cid2) == length);
+            REQUIRE(timeline->getClipPosition(cid3) == 2 * length + 10);
+            REQUIRE(timeline->duration() == 3 * length + 10);
+        };
+        REQUIRE(timeline->requestClipsLoad(tid1, {{cid1, 0}, {cid2, length}, {cid3, 2 * length + 10}}, 0, undo, redo));
+        state();
+
+        REQUIRE(undo());
+        REQUIRE(timeline->checkConsistency());
+        REQUIRE(timeline->getTrackClipsCount(tid1) == 0);
+        REQUIRE(timeline->getClipTrackId(cid3) == -1);
+
+        REQUIRE(redo());
+        state();
+    }
+    binModel->clean();
+    pCore->m_projectManager = nullptr;
+}
+
 TEST_CASE("Clip manipulation", "[ClipModel]")
 {
     Logger::clear();
@@ -1790,8 +1845,8 @@ TEST_CASE("Snapping", "[Snapping]")
         int beg = 30;
         // in the absence of other clips, a valid move shouldn't be modified
         for (int snap = -1; snap <= 5; ++snap) {
-            REQUIRE(timeline->suggestClipMove(cid2, tid2, beg, -1, snap).at(0) == beg);
-            REQUIRE(timeline->suggestClipMove(cid2, tid2, beg + length, -1, snap).at(0) == beg + length);
+            REQUIRE(timeline->suggestClipMove(cid2, tid2, beg, -1, snap, true, false).at(0) == beg);
+            REQUIRE(timeline->suggestClipMove(cid2, tid2, beg + length, -1, snap, true, false).at(0) == beg + length);
             REQUIRE(timeline->checkConsistency());
         }
 
@@ -1801,11 +1856,11 @@ TEST_CASE("Snapping", "[Snapping]")
         // Now a clip in second track should snap to beginning
         auto check_snap = [&](int pos, int perturb, int snap) {
             if (snap >= perturb) {
-                REQUIRE(timeline->suggestClipMove(cid2, tid2, pos + perturb, -1, snap).at(0) == pos);
-                REQUIRE(timeline->suggestClipMove(cid2, tid2, pos - perturb, -1, snap).at(0) == pos);
+                REQUIRE(timeline->suggestClipMove(cid2, tid2, pos + perturb, -1, snap, true, false).at(0) == pos);
+                REQUIRE(timeline->suggestClipMove(cid2, tid2, pos - perturb, -1, snap, true, false).at(0) == pos);
             } else {
-                REQUIRE(timeline->suggestClipMove(cid2, tid2, pos + perturb, -1, snap).at(0) == pos + perturb);
-                REQUIRE(timeline->suggestClipMove(cid2, tid2, pos - perturb, -1, snap).at(0) == pos - perturb);
+                REQUIRE(timeline->suggestClipMove(cid2, tid2, pos + perturb, -1, snap, true, false).at(0) == pos + perturb);
+                REQUIRE(timeline->suggestClipMove(cid2, tid2, pos - perturb, -1, snap, true, false).at(0) == pos - perturb);
             }
         };
         for (int snap = -1; snap <= 5; ++snap) {
@@ -1194,7 +1194,7 @@ TEST_CASE("FuzzBug9")
         undoStack->redo();
         REQUIRE(timeline_0->checkConsistency());
         {
-            timeline_0->suggestClipMove(2, 1, -34, 0, 0);
+            timeline_0->suggestClipMove(2, 1, -34, 0, 0, true, false);
         }
         REQUIRE(timeline_0->checkConsistency());
         undoStack->undo();
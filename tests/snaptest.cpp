@@ -123,4 +123,72 @@ TEST_CASE("Snap points model test", "[SnapModel]")
         REQUIRE(snap.getClosestPoint(9) == 15);
         REQUIRE(snap.getClosestPoint(999) == 15);
     }
+
+    SECTION("Excluding points in a query")
+    {
+        snap.addPoint(10);
+        snap.addPoint(10);
+        snap.addPoint(20);
+        auto stored = snap._snaps();
+
+        REQUIRE(snap.getClosestPoint(12, 100, {}) == 10);
+        REQUIRE(snap.getClosestPoint(12, 100, {10}) == 10);
+        REQUIRE(snap.getClosestPoint(12, 100, {10, 10}) == 20);
+        REQUIRE(snap.getClosestPoint(12, 100, {10, 10, 20}) == -1);
+        // distance limit
+        REQUIRE(snap.getClosestPoint(14, 4, {}) == 10);
+        REQUIRE(snap.getClosestPoint(14, 3, {}) == -1);
+        REQUIRE(snap.getClosestPoint(17, 3, {10, 10}) == 20);
+        // extra points are only used for the query
+        REQUIRE(snap.getClosestPoint(14, 100, {}, {15}) == 15);
+        REQUIRE(snap.getClosestPoint(14, 100, {10, 10, 20}, {13}) == 13);
+        REQUIRE(snap.getClosestPoint(14, 0, {}, {13}) == -1);
+        // the model is never modified
+        REQUIRE(snap._snaps() == stored);
+
+        // resizing ignores the boundaries of the item
+        REQUIRE(snap.proposeSize(10, 20, 9, true, 2) == -1);
+        REQUIRE(snap.proposeSize(10, 20, {10, 20}, 9, true, 2, {18}) == 8);
+        REQUIRE(snap._snaps() == stored);
+    }
+
+    SECTION("Snap layers")
+    {
+        snap.addPoint(10, SnapModel::ClipEdge, 1);
+        snap.addPoint(20, SnapModel::ClipEdge, 2);
+        snap.addPoint(30, SnapModel::Marker);
+        auto guides = snap.layer(SnapModel::Guide);
+        guides->addPoint(40);
+        REQUIRE(snap.layer(SnapModel::Guide) == guides);
+
+        REQUIRE(snap.getClosestPoint(12) == 10);
+        snap.setTrackEnabled(1, false);
+        REQUIRE(snap.getClosestPoint(12) == 20);
+        snap.setTypeEnabled(SnapModel::ClipEdge, false);
+        REQUIRE(snap.getClosestPoint(12) == 30);
+        snap.setTypeEnabled(SnapModel::Marker, false);
+        REQUIRE(snap.getClosestPoint(12) == 40);
+        snap.setTypeEnabled(SnapModel::Guide, false);
+        REQUIRE(snap.getClosestPoint(12) == -1);
+        REQUIRE(snap.getClosestPoint(12, 100, {}, {15}) == 15);
+
+        snap.setTypeEnabled(SnapModel::ClipEdge, true);
+        REQUIRE(snap.getClosestPoint(12) == 20);
+        snap.setTrackEnabled(1, true);
+        REQUIRE(snap.getClosestPoint(12) == 10);
+
+        // a disabled layer sharing a position with an enabled one does not hide it
+        snap.addPoint(10, SnapModel::Marker);
+        REQUIRE(snap.getClosestPoint(12, 100, {10}) == 10);
+        REQUIRE(snap.getClosestPoint(12, 100, {10, 10}) == 20);
+        snap.setTrackEnabled(1, false);
+        REQUIRE(snap.getClosestPoint(12) == 20);
+
+        guides->removePoint(40);
+        snap.removePoint(10, SnapModel::Marker);
+        snap.removePoint(30, SnapModel::Marker);
+        snap.removePoint(20, SnapModel::ClipEdge, 2);
+        snap.removePoint(10, SnapModel::ClipEdge, 1);
+        REQUIRE(snap._snaps().empty());
+    }
 }
@@ -0,0 +1,36 @@
+#include "catch.hpp"
+
+#include "gentime.h"
+#include <map>
+
+TEST_CASE("Exact time positions", "[TickTime]")
+{
+    SECTION("Frames of common rates are exact")
+    {
+        for (int num : {24000, 25, 30000, 50, 60000}) {
+            int den = num > 1000 ? 1001 : 1;
+            for (qint64 frame : {0ll, 1ll, -7ll, 1000ll, 123457ll, 10000000ll}) {
+                TickTime time = TickTime::fromFrames(frame, num, den);
+                REQUIRE(time.frames(num, den) == frame);
+                REQUIRE(time == TickTime::fromFrames(frame, double(num) / den));
+                REQUIRE(time + TickTime::fromFrames(1, num, den) == TickTime::fromFrames(frame + 1, num, den));
+            }
+        }
+        REQUIRE(TickTime::fromFrames(1, 30000, 1001).ticks() == 23543520);
+    }
+
+    SECTION("Conversion from GenTime")
+    {
+        GenTime::setFps(25);
+        // A GenTime converts to the start of its frame
+        REQUIRE(TickTime(GenTime(1.1)) == TickTime::fromFrames(28, 25, 1));
+        REQUIRE(TickTime(GenTime(1.13)) == TickTime::fromFrames(28, 25, 1));
+        REQUIRE(TickTime(GenTime(28, 25)) == TickTime::fromFrames(28, 25, 1));
+        REQUIRE(GenTime(TickTime::fromFrames(28, 25, 1)).frames(25) == 28);
+
+        std::map<TickTime, int> positions;
+        positions[GenTime(3, 25)] = 3;
+        REQUIRE(positions.count(GenTime(0.121)) == 1);
+        REQUIRE(positions.count(GenTime(4, 25)) == 0);
+    }
+}
@@ -0,0 +1,201 @@
+#include "benchmarkreport.hpp"
+#include "test_utils.hpp"
+#include <mlt++/MltConsumer.h>
+
+using namespace fakeit;
+Mlt::Profile profile_benchmark;
+
+namespace {
+struct TimelineSize
+{
+    int clips;
+    int tracks;
+};
+
+// From a short edit to a feature film with many layers
+const std::vector<TimelineSize> timelineSizes = {{1000, 2}, {1000, 8}, {5000, 8}, {10000, 16}, {20000, 32}, {50000, 64}};
+
+/* @brief Rebuilds the clips of a saved tractor on the tracks of a new timeline, the way the project loader does */
+bool rebuildTimeline(const std::shared_ptr<TimelineItemModel> &timeline, const std::vector<int> &tracks, Mlt::Tractor &tractor, Fun &undo, Fun &redo)
+{
+    size_t trackIndex = 0;
+    for (int i = 0; i < tractor.count() && trackIndex < tracks.size(); ++i) {
+        std::unique_ptr<Mlt::Producer> track(tractor.track(i));
+        if (track->type() != tractor_type) {
+            // black track
+            continue;
+        }
+        int tid = tracks.at(trackIndex++);
+        Mlt::Tractor trackTractor(*track);
+        std::unique_ptr<Mlt::Producer> playlistProducer(trackTractor.track(0));
+        Mlt::Playlist playlist(*playlistProducer);
+        std::vector<std::pair<int, int>> clips;
+        for (int j = 0; j < playlist.count(); ++j) {
+            if (playlist.is_blank(j)) {
+                continue;
+            }
+            std::shared_ptr<Mlt::Producer> clip(playlist.get_clip(j));
+            QString binId = clip->parent().get("kdenlive:id");
+            int cid = ClipModel::construct(timeline, binId, clip, PlaylistState::VideoOnly, tid, QString());
+            clips.push_back({cid, playlist.clip_start(j)});
+        }
+        if (!timeline->requestClipsLoad(tid, clips, 0, undo, redo)) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST_CASE("Timeline model scaling", "[Timeline][Benchmark]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+    std::shared_ptr<MarkerListModel> guideModel = std::make_shared<MarkerListModel>(undoStack);
+
+    Mock<ProjectManager> pmMock;
+    When(Method(pmMock, undoStack)).AlwaysReturn(undoStack);
+
+    ProjectManager &mocked = pmMock.get();
+    pCore->m_projectManager = &mocked;
+
+    // Clips are separated by a small blank, so that groups can move without colliding
+    const int length = 20;
+    const int gap = 5;
+    QString binId = createProducer(profile_benchmark, "red", binModel, length);
+    QString binId2 = createProducer(profile_benchmark, "blue", binModel, length);
+
+    for (const TimelineSize &size : timelineSizes) {
+        if (size.clips > BenchmarkReport::maxClips) {
+            continue;
+        }
+        undoStack->clear();
+        std::shared_ptr<TimelineItemModel> timeline = TimelineItemModel::construct(&profile_benchmark, guideModel, undoStack);
+
+        std::vector<int> tracks;
+        for (int i = 0; i < size.tracks; ++i) {
+            tracks.push_back(TrackModel::construct(timeline));
+        }
+        const int perTrack = size.clips / size.tracks;
+        std::vector<std::vector<int>> clips(size_t(size.tracks));
+        bool ok = true;
+
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("insertion"), size.clips, size.tracks, perTrack * size.tracks, [&]() {
+            for (int t = 0; t < size.tracks; ++t) {
+                for (int i = 0; i < perTrack; ++i) {
+                    int cid = -1;
+                    ok = ok && timeline->requestClipInsertion(i % 2 == 0 ? binId : binId2, tracks[t], i * (length + gap), cid, false, false, false);
+                    clips[t].push_back(cid);
+                }
+            }
+        });
+        REQUIRE(ok);
+        REQUIRE(timeline->getClipsCount() == perTrack * size.tracks);
+
+        std::unordered_set<int> allClips;
+        for (const auto &trackClips : clips) {
+            allClips.insert(trackClips.begin(), trackClips.end());
+        }
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("select all"), size.clips, size.tracks, 1, [&]() {
+            ok = timeline->requestSetSelection(allClips);
+        });
+        REQUIRE(ok);
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("clear selection"), size.clips, size.tracks, 1, [&]() {
+            timeline->requestClearSelection();
+        });
+
+        // Group the clips of the first two tracks and move them back and forth
+        std::unordered_set<int> grouped(clips[0].begin(), clips[0].end());
+        grouped.insert(clips[1].begin(), clips[1].end());
+        int gid = -1;
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("group"), size.clips, size.tracks, 1, [&]() {
+            gid = timeline->requestClipsGroup(grouped);
+        });
+        REQUIRE(gid > -1);
+        const int moves = 10;
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("group move"), size.clips, size.tracks, moves, [&]() {
+            for (int i = 0; i < moves; ++i) {
+                ok = ok && timeline->requestGroupMove(clips[0].front(), gid, 0, i % 2 == 0 ? gap : -gap);
+            }
+        });
+        REQUIRE(ok);
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("ungroup"), size.clips, size.tracks, 1, [&]() {
+            ok = timeline->requestClipUngroup(clips[0].front());
+        });
+        REQUIRE(ok);
+
+        // Ripple: insert then remove a blank in the middle of the timeline, on all tracks
+        const int middle = (perTrack / 2) * (length + gap) + length;
+        const QPoint zone(middle, middle + length);
+        const QVector<int> allTracks = QVector<int>::fromStdVector(tracks);
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("ripple insert"), size.clips, size.tracks, 1, [&]() {
+            Fun undo = []() { return true; };
+            Fun redo = []() { return true; };
+            ok = TimelineFunctions::requestInsertSpace(timeline, zone, undo, redo, allTracks);
+            pCore->pushUndo(undo, redo, QStringLiteral("Insert space"));
+        });
+        REQUIRE(ok);
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("ripple delete"), size.clips, size.tracks, 1, [&]() {
+            Fun undo = []() { return true; };
+            Fun redo = []() { return true; };
+            ok = TimelineFunctions::removeSpace(timeline, zone, undo, redo, allTracks, false);
+            pCore->pushUndo(undo, redo, QStringLiteral("Remove space"));
+        });
+        REQUIRE(ok);
+
+        const int cuts = 20;
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("cut all"), size.clips, size.tracks, cuts, [&]() {
+            for (int i = 0; i < cuts; ++i) {
+                ok = ok && TimelineFunctions::requestClipCutAll(timeline, (i * perTrack / cuts) * (length + gap) + length / 2);
+            }
+        });
+        REQUIRE(ok);
+        const int clipCount = timeline->getClipsCount();
+        REQUIRE(timeline->checkConsistency());
+
+        const int commands = undoStack->count();
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("undo"), size.clips, size.tracks, commands, [&]() {
+            for (int i = 0; i < commands; ++i) {
+                undoStack->undo();
+            }
+        });
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("redo"), size.clips, size.tracks, commands, [&]() {
+            for (int i = 0; i < commands; ++i) {
+                undoStack->redo();
+            }
+        });
+        REQUIRE(timeline->getClipsCount() == clipCount);
+
+        QByteArray xml;
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("save"), size.clips, size.tracks, 1, [&]() {
+            Mlt::Consumer c(profile_benchmark, "xml", "string");
+            c.connect(*timeline->tractor());
+            c.set("time_format", "frames");
+            c.set("no_meta", 1);
+            c.set("store", "kdenlive");
+            c.run();
+            xml = QByteArray(c.get("string"));
+        });
+        REQUIRE(!xml.isEmpty());
+
+        std::shared_ptr<TimelineItemModel> loaded = TimelineItemModel::construct(&profile_benchmark, guideModel, undoStack);
+        std::vector<int> loadedTracks;
+        for (int i = 0; i < size.tracks; ++i) {
+            loadedTracks.push_back(TrackModel::construct(loaded));
+        }
+        BenchmarkReport::measure(QStringLiteral("timeline"), QStringLiteral("load"), size.clips, size.tracks, clipCount, [&]() {
+            Mlt::Producer xmlProd(profile_benchmark, "xml-string", xml.constData());
+            Mlt::Service s(xmlProd);
+            Mlt::Tractor tractor(s);
+            Fun undo = []() { return true; };
+            Fun redo = []() { return true; };
+            ok = rebuildTimeline(loaded, loadedTracks, tractor, undo, redo);
+        });
+        REQUIRE(ok);
+        REQUIRE(loaded->getClipsCount() == clipCount);
+        undoStack->clear();
+    }
+    binModel->clean();
+    pCore->m_projectManager = nullptr;
+}
@@ -0,0 +1,71 @@
+#include "catch.hpp"
+
+#include "titler/titlebatch.hpp"
+#include <QDomDocument>
+
+TEST_CASE("Title batch generation", "[TitleBatch]")
+{
+    SECTION("Parse CSV data")
+    {
+        TitleBatch::Data data = TitleBatch::parseCsv(QStringLiteral("name;role\r\n"
+                                                                    "Jane Doe;\"Director; writer\"\r\n"
+                                                                    "\n"
+                                                                    "\"John \"\"Johnny\"\" Smith\";\"Line\nbreak\"\n"
+                                                                    "Short\n"));
+        REQUIRE(data.columns == QStringList({QStringLiteral("name"), QStringLiteral("role")}));
+        REQUIRE(data.rows.count() == 3);
+        REQUIRE(data.rows.at(0) == QStringList({QStringLiteral("Jane Doe"), QStringLiteral("Director; writer")}));
+        REQUIRE(data.rows.at(1) == QStringList({QStringLiteral("John \"Johnny\" Smith"), QStringLiteral("Line\nbreak")}));
+        // Missing values are empty
+        REQUIRE(data.rows.at(2) == QStringList({QStringLiteral("Short"), QString()}));
+    }
+
+    SECTION("Parse JSON data")
+    {
+        TitleBatch::Data data;
+        QString error;
+        REQUIRE(TitleBatch::parseJson(QByteArray("[{\"name\": \"Jane\", \"age\": 42}, {\"name\": \"John\"}]"), data, error));
+        REQUIRE(data.columns == QStringList({QStringLiteral("age"), QStringLiteral("name")}));
+        REQUIRE(data.rows.count() == 2);
+        REQUIRE(data.rows.at(0) == QStringList({QStringLiteral("42"), QStringLiteral("Jane")}));
+        REQUIRE(data.rows.at(1) == QStringList({QString(), QStringLiteral("John")}));
+        REQUIRE_FALSE(TitleBatch::parseJson(QByteArray("{\"name\": \"Jane\"}"), data, error));
+        REQUIRE_FALSE(TitleBatch::parseJson(QByteArray("[{\"name\": "), data, error));
+    }
+
+    SECTION("Fill and classify titles")
+    {
+        const QString title = QStringLiteral("<kdenlivetitle width=\"1920\" height=\"1080\">"
+                                             "<item type=\"QGraphicsTextItem\" z-index=\"0\"><content font=\"Sans\">%s</content></item>"
+                                             "<item type=\"QGraphicsTextItem\" z-index=\"1\"><content font=\"Sans\">{role} &amp; {name}</content></item>"
+                                             "<startviewport rect=\"0,0,1920,1080\"/><endviewport rect=\"0,0,1920,1080\"/>"
+                                             "</kdenlivetitle>");
+        const QStringList columns = {QStringLiteral("name"), QStringLiteral("role")};
+        const QString filled = TitleBatch::applyRow(title, columns, {QStringLiteral("Jane <Doe>"), QStringLiteral("Director")});
+        QDomDocument doc;
+        REQUIRE(doc.setContent(filled));
+        QDomNodeList contents = doc.elementsByTagName(QStringLiteral("content"));
+        REQUIRE(contents.item(0).toElement().text() == QStringLiteral("Jane <Doe>"));
+        REQUIRE(contents.item(1).toElement().text() == QStringLiteral("Director & Jane <Doe>"));
+        REQUIRE(contents.item(0).toElement().attribute(QStringLiteral("font")) == QStringLiteral("Sans"));
+        // Values are inserted as is, even if they look like placeholders
+        REQUIRE(doc.setContent(TitleBatch::applyRow(title, columns, {QStringLiteral("{role}"), QStringLiteral("100%s {x}")})));
+        contents = doc.elementsByTagName(QStringLiteral("content"));
+        REQUIRE(contents.item(0).toElement().text() == QStringLiteral("{role}"));
+        REQUIRE(contents.item(1).toElement().text() == QStringLiteral("100%s {x} & {role}"));
+
+        REQUIRE(TitleBatch::isStatic(filled));
+        QString scrolling = title;
+        scrolling.replace(QStringLiteral("<endviewport rect=\"0,0,1920,1080\"/>"), QStringLiteral("<endviewport rect=\"0,-1080,1920,1080\"/>"));
+        REQUIRE_FALSE(TitleBatch::isStatic(scrolling));
+        QString typewriter = title;
+        typewriter.replace(QStringLiteral("<content font=\"Sans\">%s"), QStringLiteral("<content font=\"Sans\" typewriter=\"2;0\">%s"));
+        REQUIRE_FALSE(TitleBatch::isStatic(typewriter));
+
+        // Identical titles share a key, which depends on the size
+        const QSize size(1920, 1080);
+        REQUIRE(TitleBatch::cacheKey(filled, size) == TitleBatch::cacheKey(filled, size));
+        REQUIRE(TitleBatch::cacheKey(filled, size) != TitleBatch::cacheKey(title, size));
+        REQUIRE(TitleBatch::cacheKey(filled, size) != TitleBatch::cacheKey(filled, QSize(1280, 720)));
+    }
+}
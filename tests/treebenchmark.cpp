@@ -0,0 +1,49 @@
+#include "benchmarkreport.hpp"
+#include "catch.hpp"
+
+#include "abstractmodel/abstracttreemodel.hpp"
+#include "abstractmodel/treeitem.hpp"
+
+#include <QString>
+
+TEST_CASE("Tree model scaling", "[TreeModel][Benchmark]")
+{
+    for (int count : {1000, 10000, 100000}) {
+        auto model = AbstractTreeModel::construct();
+        auto folder = model->getRoot()->appendChild(QList<QVariant>{QString("folder")});
+        std::vector<std::shared_ptr<TreeItem>> items;
+        items.reserve(size_t(count));
+        BenchmarkReport::measureItems(QStringLiteral("tree"), QStringLiteral("append"), count, count, [&]() {
+            for (int i = 0; i < count; ++i) {
+                items.push_back(folder->appendChild(QList<QVariant>{QString::number(i)}));
+            }
+        });
+
+        QModelIndex folderIndex = model->getIndexFromItem(folder);
+        bool ok = true;
+        BenchmarkReport::measureItems(QStringLiteral("tree"), QStringLiteral("index of row"), count, count, [&]() {
+            for (int i = 0; i < count; ++i) {
+                ok = ok && model->index(i, 0, folderIndex).isValid();
+            }
+        });
+        REQUIRE(ok);
+
+        BenchmarkReport::measureItems(QStringLiteral("tree"), QStringLiteral("parent and row"), count, count, [&]() {
+            for (const auto &item : items) {
+                QModelIndex ix = model->getIndexFromItem(item);
+                ok = ok && model->parent(ix) == folderIndex;
+            }
+        });
+        REQUIRE(ok);
+
+        // Removals from the middle shift the rows of all following items
+        const int removed = count / 100;
+        BenchmarkReport::measureItems(QStringLiteral("tree"), QStringLiteral("removal"), count, removed, [&]() {
+            for (int i = 0; i < removed; ++i) {
+                folder->removeChild(items[size_t(count / 2 + i)]);
+            }
+        });
+        REQUIRE(folder->childCount() == count - removed);
+        REQUIRE(items.back()->row() == count - removed - 1);
+    }
+}
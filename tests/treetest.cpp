@@ -185,3 +185,46 @@ TEST_CASE("Basic tree testing", "[TreeModel]")
         state();
     }
 }
+
+TEST_CASE("Rows are kept up to date", "[TreeModel]")
+{
+    auto model = AbstractTreeModel::construct();
+    std::vector<std::shared_ptr<TreeItem>> items;
+    for (int i = 0; i < 10; ++i) {
+        items.push_back(model->getRoot()->appendChild(QList<QVariant>{QString::number(i)}));
+    }
+    auto checkRows = [&]() {
+        REQUIRE(model->checkConsistency());
+        for (int i = 0; i < model->getRoot()->childCount(); ++i) {
+            REQUIRE(model->getRoot()->child(i)->row() == i);
+            REQUIRE(model->index(i, 0).internalId() == quintptr(model->getRoot()->child(i)->getId()));
+        }
+    };
+    checkRows();
+
+    // Removal in the middle shifts the following rows
+    model->getRoot()->removeChild(items[4]);
+    REQUIRE(items[4]->row() == -1);
+    REQUIRE(items[5]->row() == 4);
+    REQUIRE(model->getRoot()->childCount() == 9);
+    checkRows();
+
+    // Move to the front and back to the end
+    model->getRoot()->moveChild(0, items[9]);
+    REQUIRE(items[9]->row() == 0);
+    REQUIRE(items[0]->row() == 1);
+    checkRows();
+    model->getRoot()->moveChild(8, items[9]);
+    REQUIRE(items[9]->row() == 8);
+    checkRows();
+
+    // Move from another parent
+    auto folder = model->getRoot()->appendChild(QList<QVariant>{QString("folder")});
+    REQUIRE(items[2]->changeParent(folder));
+    REQUIRE(items[2]->row() == 0);
+    REQUIRE(items[3]->row() == 2);
+    model->getRoot()->moveChild(1, items[2]);
+    REQUIRE(folder->childCount() == 0);
+    REQUIRE(items[2]->row() == 1);
+    checkRows();
+}